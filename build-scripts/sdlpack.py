@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+#
+# Build a pack file for SDL_OpenPack() and SDL_RWFromPack().
+#
+# Usage: sdlpack.py [-a alignment] output.pak path...
+#
+# Each path is a file, stored under the name given on the command line, or
+# a directory, whose files are stored under their names relative to it.
+# Names use '/' between directories.  Entries are stored sorted by name,
+# so assets that live together are read together.
+#
+# See src/file/SDL_pack.c for a description of the format.
+
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = b"SDLP"
+VERSION = 1
+HEADER_SIZE = 32
+ENTRY_SIZE = 24
+
+
+def fnv1a(data):
+    value = 2166136261
+    for byte in data:
+        value = ((value ^ byte) * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def collect(paths):
+    files = {}
+    for path in paths:
+        if os.path.isdir(path):
+            for root, dirs, names in os.walk(path):
+                dirs.sort()
+                for name in names:
+                    full = os.path.join(root, name)
+                    rel = os.path.relpath(full, path).replace(os.sep, "/")
+                    files[rel] = full
+        elif os.path.isfile(path):
+            files[path.replace(os.sep, "/")] = path
+        else:
+            sys.exit("sdlpack: no such file or directory: " + path)
+    return files
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Build an SDL pack file.")
+    parser.add_argument("-a", "--alignment", type=int, default=4096,
+                        help="alignment of each entry in bytes (default 4096)")
+    parser.add_argument("output", help="the pack file to write")
+    parser.add_argument("paths", nargs="+", help="files or directories to pack")
+    args = parser.parse_args()
+
+    if args.alignment <= 0:
+        sys.exit("sdlpack: the alignment must be positive")
+
+    files = collect(args.paths)
+    names = sorted(files)
+
+    # Between one and two buckets for each entry keeps the chains short
+    num_buckets = 1
+    while num_buckets < len(names):
+        num_buckets *= 2
+
+    encoded = [name.encode("utf-8") for name in names]
+    hashes = [fnv1a(name) for name in encoded]
+    name_table = b"".join(encoded)
+    name_offsets = []
+    offset = 0
+    for name in encoded:
+        name_offsets.append(offset)
+        offset += len(name)
+
+    directory_end = (HEADER_SIZE + (num_buckets + 1) * 4 +
+                     len(names) * ENTRY_SIZE + len(name_table))
+
+    def align(value):
+        return (value + args.alignment - 1) // args.alignment * args.alignment
+
+    # Data goes in name order, the directory in bucket order
+    data_offsets = []
+    sizes = []
+    offset = align(directory_end)
+    for name in names:
+        size = os.path.getsize(files[name])
+        if size > 0xFFFFFFFF:
+            sys.exit("sdlpack: too large for a pack entry: " + files[name])
+        data_offsets.append(offset)
+        sizes.append(size)
+        offset = align(offset + size)
+
+    order = sorted(range(len(names)), key=lambda i: (hashes[i] & (num_buckets - 1), i))
+    buckets = [0] * (num_buckets + 1)
+    for i in order:
+        buckets[(hashes[i] & (num_buckets - 1)) + 1] += 1
+    for b in range(num_buckets):
+        buckets[b + 1] += buckets[b]
+
+    with open(args.output, "wb") as out:
+        out.write(MAGIC)
+        out.write(struct.pack("<7I", VERSION, len(names), num_buckets,
+                              len(name_table), args.alignment, 0, 0))
+        out.write(struct.pack("<%dI" % len(buckets), *buckets))
+        for i in order:
+            out.write(struct.pack("<4IQ", hashes[i], name_offsets[i],
+                                  len(encoded[i]), sizes[i], data_offsets[i]))
+        out.write(name_table)
+
+        for i, name in enumerate(names):
+            out.write(b"\0" * (data_offsets[i] - out.tell()))
+            with open(files[name], "rb") as src:
+                out.write(src.read())
+
+        size = out.tell()
+
+    print("%s: %d entries, %d bytes" % (args.output, len(names), size))
+
+
+if __name__ == "__main__":
+    main()
@@ -32,6 +32,7 @@
 #include "SDL_main.h"
 #include "SDL_stdinc.h"
 #include "SDL_assert.h"
+#include "SDL_asyncio.h"
 #include "SDL_atomic.h"
 #include "SDL_audio.h"
 #include "SDL_clipboard.h"
@@ -43,9 +44,11 @@
 #include "SDL_gamecontroller.h"
 #include "SDL_haptic.h"
 #include "SDL_hints.h"
+#include "SDL_jobs.h"
 #include "SDL_joystick.h"
 #include "SDL_loadso.h"
 #include "SDL_log.h"
+#include "SDL_memstats.h"
 #include "SDL_messagebox.h"
 #include "SDL_mutex.h"
 #include "SDL_power.h"
@@ -0,0 +1,117 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef SDL_asyncio_h_
+#define SDL_asyncio_h_
+
+/**
+ *  \file SDL_asyncio.h
+ *
+ *  Header for SDL asynchronous file reads.
+ *
+ *  Reads are queued and performed by a dedicated I/O thread, so that
+ *  slow media such as optical drives don't stall the calling thread.
+ *  Queued reads of the same stream are served in order of file offset,
+ *  sweeping forward through the file, rather than in the order they were
+ *  submitted, to keep the drive from seeking back and forth.
+ *
+ *  When a read finishes its callback is called on the I/O thread, or if
+ *  no callback was given, an ::SDL_ASYNCIOCOMPLETE event is pushed.
+ *
+ *  The I/O thread is started on first use and shut down by SDL_Quit(),
+ *  which waits for queued reads to finish.
+ */
+
+#include "SDL_stdinc.h"
+#include "SDL_error.h"
+#include "SDL_rwops.h"
+
+#include "begin_code.h"
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  The function called when an asynchronous read finishes.
+ *
+ *  It is called on the I/O thread, so it should return quickly; no other
+ *  reads are serviced while it runs.
+ *
+ *  \param userdata The pointer passed when the read was submitted.
+ *  \param buffer The buffer the data was read into.
+ *  \param result The number of bytes read, which is less than requested
+ *                at the end of the file, or -1 on error.
+ */
+typedef void (SDLCALL * SDL_AsyncIOCallback) (void *userdata, void *buffer, Sint64 result);
+
+/**
+ *  Queue a read from a stream.
+ *
+ *  The stream must be seekable, and must not be used or closed by other
+ *  threads until every read queued on it has finished.
+ *
+ *  If \c callback is NULL, an ::SDL_ASYNCIOCOMPLETE event is pushed when
+ *  the read finishes, with event.user.code set to the result,
+ *  event.user.data1 to \c userdata and event.user.data2 to \c buffer.
+ *
+ *  \param context The stream to read from.
+ *  \param offset The offset in the stream to read from.
+ *  \param buffer The buffer to read into, which must stay valid until the
+ *                read finishes.
+ *  \param size The number of bytes to read.
+ *  \param callback The function to call when the read finishes, or NULL.
+ *  \param userdata A pointer passed to \c callback.
+ *
+ *  \return 0 if the read was queued, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_ReadAsync(SDL_RWops * context, Sint64 offset,
+                                          void *buffer, size_t size,
+                                          SDL_AsyncIOCallback callback,
+                                          void *userdata);
+
+/**
+ *  Queue a read from a file.
+ *
+ *  The file is opened with SDL_RWFromFile() on the I/O thread, and kept
+ *  open while further reads of it are queued.
+ *
+ *  \sa SDL_ReadAsync
+ */
+extern DECLSPEC int SDLCALL SDL_ReadFileAsync(const char *file, Sint64 offset,
+                                              void *buffer, size_t size,
+                                              SDL_AsyncIOCallback callback,
+                                              void *userdata);
+
+/**
+ *  Wait until every queued read has finished.
+ */
+extern DECLSPEC void SDLCALL SDL_WaitAsyncIO(void);
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+#include "close_code.h"
+
+#endif /* SDL_asyncio_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
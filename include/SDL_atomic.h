@@ -265,6 +265,108 @@ extern DECLSPEC void* SDLCALL SDL_AtomicSetPtr(void **a, void* v);
  */
 extern DECLSPEC void* SDLCALL SDL_AtomicGetPtr(void **a);
 
+/**
+ *  \name Lock-free queue and stack
+ */
+/* @{ */
+
+/**
+ * \brief A bounded multi-producer, multi-consumer FIFO of pointers.
+ *
+ * Any number of threads may push and pop at the same time without taking
+ * a lock.  Pushing fails when the queue is full rather than growing it.
+ */
+struct SDL_AtomicQueue;
+typedef struct SDL_AtomicQueue SDL_AtomicQueue;
+
+/**
+ * \brief Create a queue that holds at least \c capacity items.
+ *
+ * The capacity is rounded up to a power of two.
+ *
+ * \return The new queue, or NULL on error.
+ */
+extern DECLSPEC SDL_AtomicQueue * SDLCALL SDL_CreateAtomicQueue(Uint32 capacity);
+
+/**
+ * \brief Add an item to the end of the queue.
+ *
+ * \return SDL_TRUE if the item was added, SDL_FALSE if the queue was full.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_AtomicQueuePush(SDL_AtomicQueue *queue, void *item);
+
+/**
+ * \brief Remove the item at the front of the queue.
+ *
+ * \return SDL_TRUE if an item was stored in \c item, SDL_FALSE if the queue
+ *         was empty.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_AtomicQueuePop(SDL_AtomicQueue *queue, void **item);
+
+/**
+ * \brief Destroy a queue.  Any items still in it are not freed.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyAtomicQueue(SDL_AtomicQueue *queue);
+
+/**
+ * \brief A link in an SDL_AtomicStack.
+ *
+ * Embed this in your own structure, usually as the first member.
+ */
+typedef struct SDL_AtomicStackNode
+{
+    struct SDL_AtomicStackNode *next;
+} SDL_AtomicStackNode;
+
+/**
+ * \brief An intrusive last-in, first-out stack that threads can push to
+ *        and pop from without taking a lock.
+ *
+ * A counter stored alongside the top of the stack protects against the ABA
+ * problem, so nodes may be popped and pushed again freely.  Nodes must stay
+ * allocated for as long as other threads may be using the stack, which
+ * makes it a good fit for free lists.
+ *
+ * On platforms without a suitable compare-and-swap this falls back to a
+ * spinlock.
+ */
+struct SDL_AtomicStack;
+typedef struct SDL_AtomicStack SDL_AtomicStack;
+
+/**
+ * \brief Create an empty stack.
+ *
+ * \return The new stack, or NULL on error.
+ */
+extern DECLSPEC SDL_AtomicStack * SDLCALL SDL_CreateAtomicStack(void);
+
+/**
+ * \brief Destroy a stack.  Any nodes still on it are not freed.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyAtomicStack(SDL_AtomicStack *stack);
+
+/**
+ * \brief Push a node onto the stack.
+ */
+extern DECLSPEC void SDLCALL SDL_AtomicStackPush(SDL_AtomicStack *stack, SDL_AtomicStackNode *node);
+
+/**
+ * \brief Pop the most recently pushed node off the stack.
+ *
+ * \return The node, or NULL if the stack was empty.
+ */
+extern DECLSPEC SDL_AtomicStackNode * SDLCALL SDL_AtomicStackPop(SDL_AtomicStack *stack);
+
+/**
+ * \brief Empty the stack in one step.
+ *
+ * \return The nodes that were on the stack, linked through their \c next
+ *         members, most recently pushed first, or NULL if it was empty.
+ */
+extern DECLSPEC SDL_AtomicStackNode * SDLCALL SDL_AtomicStackPopAll(SDL_AtomicStack *stack);
+
+/* @} *//* Lock-free queue and stack */
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
@@ -220,6 +220,7 @@
 
 /* SDL internal assertion support */
 #cmakedefine SDL_DEFAULT_ASSERT_LEVEL @SDL_DEFAULT_ASSERT_LEVEL@
+#cmakedefine SDL_MEMORY_ACCOUNTING @SDL_MEMORY_ACCOUNTING@
 
 /* Allow disabling of core subsystems */
 #cmakedefine SDL_ATOMIC_DISABLED @SDL_ATOMIC_DISABLED@
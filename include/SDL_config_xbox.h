@@ -136,4 +136,10 @@
 /* Enable the dummy filesystem driver (src/filesystem/dummy/\*.c) */
 #define SDL_FILESYSTEM_DUMMY  1
 
+/* Serve small allocations from the slab allocator in src/stdlib/SDL_malloc.c */
+#define SDL_MALLOC_SLAB 1
+
+/* Use the SSE and string instruction versions of SDL_memcpy and SDL_memset */
+#define SDL_MEMCPY_TUNED 1
+
 #endif /* _SDL_config_xbox_h */
@@ -150,6 +150,9 @@ typedef enum
     /* Sensor events */
     SDL_SENSORUPDATE = 0x1200,     /**< A sensor was updated */
 
+    /* Asynchronous I/O events */
+    SDL_ASYNCIOCOMPLETE = 0x1300,  /**< An asynchronous read finished, see SDL_asyncio.h */
+
     /* Render events */
     SDL_RENDER_TARGETS_RESET = 0x2000, /**< The render targets have been reset and their contents need to be updated */
     SDL_RENDER_DEVICE_RESET, /**< The device has been reset and all textures need to be recreated */
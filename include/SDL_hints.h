@@ -29,6 +29,8 @@
  *
  *  The convention for naming hints is SDL_HINT_X, where "SDL_X" is
  *  the environment variable that can be used to override the default.
+ *  Each environment variable is read the first time its hint is used,
+ *  and again only after SDL_ClearHints() or SDL_Quit().
  *
  *  In general these hints are just that - they may or may not be
  *  supported or applicable on any given platform, but they provide
@@ -1119,6 +1121,69 @@ extern "C" {
  */
 #define SDL_HINT_EVENT_LOGGING   "SDL_EVENT_LOGGING"
 
+/**
+ *  \brief  A variable controlling the number of worker threads in the SDL job pool.
+ *
+ *  By default SDL creates one worker thread for each CPU core beyond the
+ *  first, since the thread waiting for a job group also runs jobs. Setting
+ *  this to "0" runs every job on the thread that submits it.
+ *
+ *  This hint is read when the job pool starts, which happens the first time
+ *  a job is submitted after SDL_Init().
+ */
+#define SDL_HINT_JOB_WORKERS   "SDL_JOB_WORKERS"
+
+/**
+ *  \brief  A variable controlling whether SDL_RWFromFile() buffers files.
+ *
+ *  If set to a size in bytes, files opened with SDL_RWFromFile() are wrapped
+ *  with SDL_CreateBufferedRW() using a buffer of that size, so that small
+ *  reads and writes are served from memory. Files opened for appending are
+ *  not buffered. By default files are not wrapped.
+ */
+#define SDL_HINT_RWOPS_BUFFER_SIZE   "SDL_RWOPS_BUFFER_SIZE"
+
+/**
+ *  \brief  A variable controlling whether blits from RGB surfaces to palettized surfaces are dithered.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Each pixel gets the palette color nearest to it (default)
+ *    "1"       - An ordered dither spreads colors between palette entries
+ *
+ *  Only opaque blits without a color key are dithered. The hint is read
+ *  when a surface is first blitted to a palettized surface, or after the
+ *  blit mapping changes.
+ */
+#define SDL_HINT_PALETTE_DITHER   "SDL_PALETTE_DITHER"
+
+/**
+ *  \brief  A variable controlling whether large pixel conversions use the SDL job pool.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Conversions run on the calling thread (default)
+ *    "1"       - Large conversions are split into bands of rows across the job pool
+ *
+ *  This applies to SDL_ConvertPixels(), SDL_ConvertSurface(),
+ *  SDL_RunPixelConverter() and SDL_SoftStretch() on images of about a quarter
+ *  of a megapixel or more. The result is the same either way.
+ */
+#define SDL_HINT_PARALLEL_CONVERT   "SDL_PARALLEL_CONVERT"
+
+/**
+ *  \brief  A variable controlling whether window surface updates only send the parts that changed.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - The rects passed to SDL_UpdateWindowSurfaceRects() are sent as they are (default)
+ *    "1"       - The rects are checked against the last update in 32x32 pixel tiles,
+ *                and only the tiles that changed are sent
+ *
+ *  This helps applications that update the whole window surface every frame
+ *  while most of it stays the same. Tiles are compared by a 32-bit hash of
+ *  their pixels, so about one change in four billion could be missed.
+ *  The hint is checked on every update.
+ */
+#define SDL_HINT_FRAMEBUFFER_DAMAGE   "SDL_FRAMEBUFFER_DAMAGE"
+
 
 
 /**
@@ -0,0 +1,133 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef SDL_jobs_h_
+#define SDL_jobs_h_
+
+/**
+ *  \file SDL_jobs.h
+ *
+ *  Header for the SDL job system.
+ *
+ *  SDL keeps a fixed pool of worker threads, sized from SDL_GetCPUCount(),
+ *  that run small jobs submitted from any thread. Each worker has its own
+ *  queue of jobs; idle workers steal work from busy ones, and threads that
+ *  wait for a job group help run queued jobs while they wait.
+ *
+ *  The pool is started on first use and shut down by SDL_Quit(). If the
+ *  pool has no workers (a single core system, threads disabled, or
+ *  ::SDL_HINT_JOB_WORKERS set to "0"), jobs simply run on the calling
+ *  thread.
+ */
+
+#include "SDL_stdinc.h"
+#include "SDL_error.h"
+
+#include "begin_code.h"
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The SDL job group structure, defined in SDL_jobs.c */
+struct SDL_JobGroup;
+typedef struct SDL_JobGroup SDL_JobGroup;
+
+/**
+ *  The function passed to SDL_SubmitJob().
+ */
+typedef void (SDLCALL * SDL_JobFunction) (void *data);
+
+/**
+ *  The function passed to SDL_ParallelFor().
+ *  It is called with a half-open range [start, end) of indices to process.
+ */
+typedef void (SDLCALL * SDL_ParallelForFunction) (void *data, int start, int end);
+
+/**
+ *  Get the number of worker threads in the job pool, starting the pool
+ *  if it isn't running yet.
+ *
+ *  \return The number of worker threads, which may be 0.
+ */
+extern DECLSPEC int SDLCALL SDL_GetJobWorkerCount(void);
+
+/**
+ *  Create a job group, used to wait for a set of jobs to complete.
+ *
+ *  \return The new job group, or NULL on error.
+ */
+extern DECLSPEC SDL_JobGroup *SDLCALL SDL_CreateJobGroup(void);
+
+/**
+ *  Queue a job to run on the worker pool.
+ *
+ *  Jobs may be submitted from any thread, including from inside other jobs.
+ *  A job submitted from a worker thread is queued on that worker, where it
+ *  may be stolen by other idle workers.
+ *
+ *  \param group The group the job belongs to, or NULL for no group.
+ *  \param fn The function to run.
+ *  \param data A pointer passed to the function.
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_SubmitJob(SDL_JobGroup *group, SDL_JobFunction fn, void *data);
+
+/**
+ *  Wait for every job in a group to complete.
+ *
+ *  The calling thread runs queued jobs while it waits, so it is safe to
+ *  call this from inside a job.
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_WaitJobGroup(SDL_JobGroup *group);
+
+/**
+ *  Destroy a job group, waiting for any jobs still pending in it.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyJobGroup(SDL_JobGroup *group);
+
+/**
+ *  Run a function over the index range [start, end), split across the
+ *  job pool in chunks of \c grainsize indices, and wait for it to finish.
+ *
+ *  \param start The first index to process.
+ *  \param end One past the last index to process.
+ *  \param grainsize The number of indices per job, or 0 to pick a size
+ *                   based on the number of workers.
+ *  \param fn The function to run on each chunk.
+ *  \param data A pointer passed to the function.
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_ParallelFor(int start, int end, int grainsize, SDL_ParallelForFunction fn, void *data);
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+#include "close_code.h"
+
+#endif /* SDL_jobs_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -199,6 +199,38 @@ extern DECLSPEC void SDLCALL SDL_LogGetOutputFunction(SDL_LogOutputFunction *cal
  */
 extern DECLSPEC void SDLCALL SDL_LogSetOutputFunction(SDL_LogOutputFunction callback, void *userdata);
 
+/**
+ *  \brief Turn asynchronous logging on or off.
+ *
+ *  While asynchronous logging is on, messages are formatted on the calling
+ *  thread and queued, and a background thread passes them to the output
+ *  function. Logging never waits for slow output, but if the queue is full
+ *  the message is dropped and counted instead, and messages longer than 255
+ *  characters are cut short.
+ *
+ *  Turning it off writes out any queued messages. SDL_Quit() turns it off.
+ *  This function should not be called from several threads at once.
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_LogSetAsync(SDL_bool enabled);
+
+/**
+ *  \brief Write out queued log messages on the calling thread.
+ *
+ *  Call this before aborting, so that queued messages aren't lost.
+ *  If the log thread is still busy with the output function after a short
+ *  wait, the messages are written without waiting for it, so this is safe
+ *  to call when the log thread is stuck.
+ *  It does nothing unless asynchronous logging is on.
+ */
+extern DECLSPEC void SDLCALL SDL_LogFlush(void);
+
+/**
+ *  \brief Get the number of messages dropped because the log queue was full.
+ */
+extern DECLSPEC int SDLCALL SDL_LogGetDroppedCount(void);
+
 
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
@@ -0,0 +1,124 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef SDL_memstats_h_
+#define SDL_memstats_h_
+
+/**
+ *  \file SDL_memstats.h
+ *
+ *  Header for SDL heap usage statistics.
+ *
+ *  When SDL is built with SDL_MEMORY_ACCOUNTING defined to 1, every block
+ *  handed out by SDL_malloc(), SDL_calloc() and SDL_realloc() is tagged
+ *  with the part of SDL that allocated it, and SDL keeps running totals
+ *  for each tag. Allocations made by the application through the SDL
+ *  memory functions are counted under ::SDL_MEMORY_TAG_APP.
+ *
+ *  Accounting adds a small header to each block and a few atomic
+ *  operations to each allocation, so it is disabled by default.
+ */
+
+#include "SDL_stdinc.h"
+#include "SDL_error.h"
+#include "SDL_rwops.h"
+
+#include "begin_code.h"
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  The parts of SDL that heap allocations are accounted to.
+ */
+typedef enum
+{
+    SDL_MEMORY_TAG_APP,         /**< Allocations made by the application */
+    SDL_MEMORY_TAG_STDLIB,      /**< Everything not listed below */
+    SDL_MEMORY_TAG_VIDEO,
+    SDL_MEMORY_TAG_RENDER,
+    SDL_MEMORY_TAG_AUDIO,
+    SDL_MEMORY_TAG_EVENTS,
+    SDL_MEMORY_TAG_JOYSTICK,
+    SDL_NUM_MEMORY_TAGS
+} SDL_MemoryTag;
+
+/**
+ *  The number of buckets in the allocation size histogram.
+ *
+ *  Bucket 0 counts allocations of up to 16 bytes, each following bucket
+ *  counts allocations up to twice the size of the one before, and the
+ *  last bucket counts everything larger.
+ */
+#define SDL_MEMORY_HISTOGRAM_BUCKETS    16
+
+/**
+ *  A snapshot of the heap usage of one tag.
+ */
+typedef struct SDL_MemoryStats
+{
+    size_t live_bytes;          /**< Bytes currently allocated */
+    size_t peak_bytes;          /**< The highest live_bytes has been */
+    int live_allocations;       /**< Blocks currently allocated */
+    int total_allocations;      /**< Blocks allocated since startup */
+    int histogram[SDL_MEMORY_HISTOGRAM_BUCKETS];  /**< Live blocks by size */
+} SDL_MemoryStats;
+
+/**
+ *  Get the name of a memory tag, e.g. "video".
+ *
+ *  \return The name of the tag, or NULL if it isn't valid.
+ */
+extern DECLSPEC const char *SDLCALL SDL_GetMemoryTagName(SDL_MemoryTag tag);
+
+/**
+ *  Get the heap usage of one tag.
+ *
+ *  The counters are read one at a time while other threads may be
+ *  allocating, so they may be slightly out of step with each other.
+ *
+ *  \param tag The tag to query.
+ *  \param stats A structure filled in with the usage of the tag.
+ *
+ *  \return 0 on success, or -1 if the tag is invalid or SDL was built
+ *          without memory accounting.
+ */
+extern DECLSPEC int SDLCALL SDL_GetMemoryStats(SDL_MemoryTag tag, SDL_MemoryStats * stats);
+
+/**
+ *  Write a text report of the heap usage of every tag.
+ *
+ *  \param dst The stream to write the report to, it is not closed.
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_DumpMemoryStats(SDL_RWops * dst);
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+#include "close_code.h"
+
+#endif /* SDL_memstats_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -45,6 +45,10 @@ extern "C" {
 #define SDL_RWOPS_JNIFILE   3U  /**< Android asset */
 #define SDL_RWOPS_MEMORY    4U  /**< Memory stream */
 #define SDL_RWOPS_MEMORY_RO 5U  /**< Read-Only memory stream */
+#define SDL_RWOPS_BUFFERED  6U  /**< Buffered stream */
+#define SDL_RWOPS_MAPPED    7U  /**< Memory-mapped read-only file */
+#define SDL_RWOPS_PACK      8U  /**< Entry of a pack file */
+#define SDL_RWOPS_COMPRESSED 9U /**< Compressed stream */
 
 /**
  * This is the read/write operation structure -- very basic.
@@ -165,8 +169,169 @@ extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromMem(void *mem, int size);
 extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromConstMem(const void *mem,
                                                       int size);
 
+/**
+ *  Open a file for reading by mapping it into memory.
+ *
+ *  Where the platform supports it the file is mapped with mmap() or a
+ *  file mapping, so its pages are only read from disk when they are used.
+ *  Otherwise the whole file is read into memory. Either way the stream is
+ *  read-only, and SDL_RWGetPointer() can be used to parse it in place.
+ *
+ *  \return The stream, or NULL on error.
+ */
+extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromFileMapped(const char *file);
+
 /* @} *//* RWFrom functions */
 
+/**
+ *  Get a pointer to the data at the current position of a stream that is
+ *  held in memory, such as one created with SDL_RWFromFileMapped(),
+ *  SDL_RWFromMem() or SDL_RWFromConstMem().
+ *
+ *  The data must not be modified, and stays valid until the stream is
+ *  closed. Use SDL_RWseek() to move past data that was parsed in place.
+ *
+ *  \param context The stream.
+ *  \param available Filled in with the number of bytes from the current
+ *                   position to the end of the stream. May be NULL.
+ *
+ *  \return A pointer to the data, or NULL if the stream isn't held in
+ *          memory. No error is set in that case.
+ */
+extern DECLSPEC const void *SDLCALL SDL_RWGetPointer(SDL_RWops * context,
+                                                     size_t *available);
+
+/**
+ *  The buffer size used by SDL_CreateBufferedRW() when none is given.
+ */
+#define SDL_RWOPS_DEFAULT_BUFFER_SIZE   4096
+
+/**
+ *  Wrap a stream with a buffer, so that small reads and writes are served
+ *  from memory instead of going to \c src each time.
+ *
+ *  Reads fill the buffer ahead of the stream position, and writes are held
+ *  back until the buffer is full, the stream seeks outside the buffer, or
+ *  the stream is closed. Reads and writes at least as large as the buffer
+ *  bypass it. \c src must not be used directly while it is wrapped.
+ *
+ *  \param src The stream to wrap.
+ *  \param buffer_size The size of the buffer in bytes, or 0 for
+ *                     ::SDL_RWOPS_DEFAULT_BUFFER_SIZE.
+ *  \param freesrc Non-zero to close \c src when the new stream is closed.
+ *
+ *  \return The buffered stream, or NULL on error.
+ */
+extern DECLSPEC SDL_RWops *SDLCALL SDL_CreateBufferedRW(SDL_RWops * src,
+                                                        size_t buffer_size,
+                                                        int freesrc);
+
+/**
+ *  \name Pack files
+ *
+ *  A pack file holds many small assets in one file, so that they can be
+ *  loaded with one open and mostly sequential reads instead of an open,
+ *  seek and close for each asset. Entries are looked up by name through a
+ *  hashed directory and start on 4K boundaries. Packs are built with
+ *  build-scripts/sdlpack.py.
+ */
+/* @{ */
+
+typedef struct SDL_Pack SDL_Pack;
+
+/**
+ *  Open a pack file and read its directory.
+ *
+ *  \return The pack, or NULL on error.
+ */
+extern DECLSPEC SDL_Pack *SDLCALL SDL_OpenPack(const char *file);
+
+/**
+ *  Read the directory of a pack file from a stream.
+ *
+ *  The stream must be seekable, and must not be used directly while the
+ *  pack or any stream opened from it is open.
+ *
+ *  \param src The stream to read the pack from.
+ *  \param freesrc Non-zero to close \c src when the pack is closed.
+ *
+ *  \return The pack, or NULL on error.
+ */
+extern DECLSPEC SDL_Pack *SDLCALL SDL_OpenPackRW(SDL_RWops * src, int freesrc);
+
+/**
+ *  Open an entry of a pack file as a read-only stream.
+ *
+ *  Streams opened from one pack share its file handle, and may be used
+ *  from different threads. They may be closed before or after the pack.
+ *
+ *  \param pack The pack.
+ *  \param name The name of the entry, with '/' between directories.
+ *
+ *  \return The stream, or NULL if there is no such entry.
+ */
+extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromPack(SDL_Pack * pack, const char *name);
+
+/**
+ *  Close a pack file.
+ *
+ *  The file stays open until every stream opened from the pack is closed.
+ */
+extern DECLSPEC void SDLCALL SDL_ClosePack(SDL_Pack * pack);
+
+/* @} *//* Pack files */
+
+/**
+ *  \name Compressed streams
+ *
+ *  A compressed stream is split into blocks that are compressed one by
+ *  one with a fast LZ77 coder, so that reading one needs little CPU time
+ *  and seeking only decompresses the block that holds the new position.
+ */
+/* @{ */
+
+/**
+ *  The block size used by SDL_CompressRW() when none is given.
+ */
+#define SDL_RWOPS_DEFAULT_COMPRESSED_BLOCK_SIZE (64 * 1024)
+
+/**
+ *  Open a stream created with SDL_CompressRW() for reading, decompressing
+ *  it as it is read.
+ *
+ *  The returned stream can be passed to any loader, such as
+ *  SDL_LoadBMP_RW() or SDL_LoadWAV_RW(). \c src must be seekable, and
+ *  must not be used directly while it is wrapped.
+ *
+ *  \param src The compressed stream.
+ *  \param freesrc Non-zero to close \c src when the new stream is closed.
+ *
+ *  \return The decompressing stream, or NULL if \c src isn't compressed or
+ *          on error.
+ */
+extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromCompressed(SDL_RWops * src,
+                                                        int freesrc);
+
+/**
+ *  Compress the data from the current position of a stream to its end.
+ *
+ *  Blocks that don't get smaller are stored as they are.
+ *
+ *  \param src The stream to compress, its size must be known.
+ *  \param dst The stream to write the compressed data to, it must be
+ *              seekable.
+ *  \param block_size The number of bytes compressed together, from 256 to
+ *                     4 MB, or 0 for ::SDL_RWOPS_DEFAULT_COMPRESSED_BLOCK_SIZE.
+ *                     Larger blocks compress better but make seeking
+ *                     slower.
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_CompressRW(SDL_RWops * src, SDL_RWops * dst,
+                                           size_t block_size);
+
+/* @} *//* Compressed streams */
+
 
 extern DECLSPEC SDL_RWops *SDLCALL SDL_AllocRW(void);
 extern DECLSPEC void SDLCALL SDL_FreeRW(SDL_RWops * area);
@@ -243,6 +408,40 @@ extern DECLSPEC size_t SDLCALL SDL_WriteLE64(SDL_RWops * dst, Uint64 value);
 extern DECLSPEC size_t SDLCALL SDL_WriteBE64(SDL_RWops * dst, Uint64 value);
 /* @} *//* Write endian functions */
 
+/**
+ *  \name Read endian array functions
+ *
+ *  Read an array of items of the specified endianness with a single read
+ *  and convert them to native format in place.
+ *
+ *  \return The number of items read.
+ */
+/* @{ */
+extern DECLSPEC size_t SDLCALL SDL_ReadLE16Array(SDL_RWops * src, Uint16 * dst, size_t count);
+extern DECLSPEC size_t SDLCALL SDL_ReadBE16Array(SDL_RWops * src, Uint16 * dst, size_t count);
+extern DECLSPEC size_t SDLCALL SDL_ReadLE32Array(SDL_RWops * src, Uint32 * dst, size_t count);
+extern DECLSPEC size_t SDLCALL SDL_ReadBE32Array(SDL_RWops * src, Uint32 * dst, size_t count);
+extern DECLSPEC size_t SDLCALL SDL_ReadLE64Array(SDL_RWops * src, Uint64 * dst, size_t count);
+extern DECLSPEC size_t SDLCALL SDL_ReadBE64Array(SDL_RWops * src, Uint64 * dst, size_t count);
+/* @} *//* Read endian array functions */
+
+/**
+ *  \name Write endian array functions
+ *
+ *  Write an array of items of native format to the specified endianness.
+ *  The array is written with a single write when no conversion is needed.
+ *
+ *  \return The number of items written.
+ */
+/* @{ */
+extern DECLSPEC size_t SDLCALL SDL_WriteLE16Array(SDL_RWops * dst, const Uint16 * src, size_t count);
+extern DECLSPEC size_t SDLCALL SDL_WriteBE16Array(SDL_RWops * dst, const Uint16 * src, size_t count);
+extern DECLSPEC size_t SDLCALL SDL_WriteLE32Array(SDL_RWops * dst, const Uint32 * src, size_t count);
+extern DECLSPEC size_t SDLCALL SDL_WriteBE32Array(SDL_RWops * dst, const Uint32 * src, size_t count);
+extern DECLSPEC size_t SDLCALL SDL_WriteLE64Array(SDL_RWops * dst, const Uint64 * src, size_t count);
+extern DECLSPEC size_t SDLCALL SDL_WriteBE64Array(SDL_RWops * dst, const Uint64 * src, size_t count);
+/* @} *//* Write endian array functions */
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
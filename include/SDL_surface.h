@@ -200,6 +200,32 @@ extern DECLSPEC SDL_Surface *SDLCALL SDL_LoadBMP_RW(SDL_RWops * src,
  */
 #define SDL_LoadBMP(file)   SDL_LoadBMP_RW(SDL_RWFromFile(file, "rb"), 1)
 
+/**
+ *  Load a surface from a seekable SDL data stream (memory or file), in the
+ *  given pixel format.
+ *
+ *  This gives the same result as SDL_ConvertSurfaceFormat() on the surface
+ *  returned by SDL_LoadBMP_RW(), but RGB formats are converted a row at a
+ *  time as the image is read, without a second copy of the image.
+ *
+ *  If \c freesrc is non-zero, the stream will be closed after being read.
+ *
+ *  The new surface should be freed with SDL_FreeSurface().
+ *
+ *  \return the new surface, or NULL if there was an error.
+ */
+extern DECLSPEC SDL_Surface *SDLCALL SDL_LoadBMPFormat_RW(SDL_RWops * src,
+                                                          int freesrc,
+                                                          Uint32 format);
+
+/**
+ *  Load a surface from a file, in the given pixel format.
+ *
+ *  Convenience macro.
+ */
+#define SDL_LoadBMPFormat(file, format) \
+        SDL_LoadBMPFormat_RW(SDL_RWFromFile(file, "rb"), 1, format)
+
 /**
  *  Save a surface to a seekable SDL data stream (memory or file).
  *
@@ -409,6 +435,73 @@ extern DECLSPEC int SDLCALL SDL_ConvertPixels(int width, int height,
                                               Uint32 dst_format,
                                               void * dst, int dst_pitch);
 
+/**
+ * \brief A conversion between two pixel formats, set up once for repeated use.
+ *
+ *  \sa SDL_CreatePixelConverter
+ */
+typedef struct SDL_PixelConverter SDL_PixelConverter;
+
+/**
+ * \brief Prepare to convert blocks of pixels of one size and format to another
+ *        format.
+ *
+ *  This does the format lookups and blitter selection that SDL_ConvertPixels()
+ *  repeats on every call, so converting a block of the same size and formats
+ *  over and over, like a video frame or a framebuffer, costs only the pixel
+ *  copy.
+ *
+ *  A converter may be used by one thread at a time.
+ *
+ *  \return A converter to pass to SDL_RunPixelConverter(), or NULL if there
+ *          was an error.
+ *
+ *  \sa SDL_RunPixelConverter
+ *  \sa SDL_FreePixelConverter
+ */
+extern DECLSPEC SDL_PixelConverter *SDLCALL SDL_CreatePixelConverter(Uint32 src_format,
+                                                                     Uint32 dst_format,
+                                                                     int width, int height);
+
+/**
+ * \brief Convert a block of pixels with a converter from
+ *        SDL_CreatePixelConverter().
+ *
+ *  \return 0 on success, or -1 if there was an error
+ */
+extern DECLSPEC int SDLCALL SDL_RunPixelConverter(SDL_PixelConverter * converter,
+                                                  const void * src, int src_pitch,
+                                                  void * dst, int dst_pitch);
+
+/**
+ * \brief Convert part of a block of pixels with a converter from
+ *        SDL_CreatePixelConverter().
+ *
+ *  \param converter The converter to use.
+ *  \param rect      The part of the block to convert, clipped to the size of
+ *                   the converter, or NULL to convert all of it.
+ *  \param src       The top left of the whole source block.
+ *  \param src_pitch The source pitch.
+ *  \param dst       The top left of the whole destination block.
+ *  \param dst_pitch The destination pitch.
+ *
+ *  Only the pixels under \c rect are read and written.  Parts of a YUV image
+ *  can't be converted, only the whole image.
+ *
+ *  \return 0 on success, or -1 if there was an error
+ *
+ *  \sa SDL_RunPixelConverter
+ */
+extern DECLSPEC int SDLCALL SDL_RunPixelConverterRect(SDL_PixelConverter * converter,
+                                                      const SDL_Rect * rect,
+                                                      const void * src, int src_pitch,
+                                                      void * dst, int dst_pitch);
+
+/**
+ * \brief Free a converter created by SDL_CreatePixelConverter().
+ */
+extern DECLSPEC void SDLCALL SDL_FreePixelConverter(SDL_PixelConverter * converter);
+
 /**
  *  Performs a fast fill of the given rectangle with \c color.
  *
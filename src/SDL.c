@@ -31,9 +31,11 @@
 #include "SDL_revision.h"
 #include "SDL_assert_c.h"
 #include "events/SDL_events_c.h"
+#include "file/SDL_asyncio_c.h"
 #include "haptic/SDL_haptic_c.h"
 #include "joystick/SDL_joystick_c.h"
 #include "sensor/SDL_sensor_c.h"
+#include "thread/SDL_jobs_c.h"
 
 /* Initialization/Cleanup routines */
 #if !SDL_TIMERS_DISABLED
@@ -375,18 +377,24 @@ SDL_Quit(void)
 {
     SDL_bInMainQuit = SDL_TRUE;
 
+    /* Finish queued reads while their callbacks can still use SDL */
+    SDL_AsyncIOQuit();
+
     /* Quit all subsystems */
 #if SDL_VIDEO_DRIVER_WINDOWS
     SDL_HelperWindowDestroy();
 #endif
     SDL_QuitSubSystem(SDL_INIT_EVERYTHING);
 
+    SDL_JobsQuit();
+
 #if !SDL_TIMERS_DISABLED
     SDL_TicksQuit();
 #endif
 
     SDL_ClearHints();
     SDL_AssertionsQuit();
+    SDL_LogSetAsync(SDL_FALSE);
     SDL_LogResetPriorities();
 
     /* Now that every subsystem has been quit, we reset the subsystem refcount
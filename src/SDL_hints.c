@@ -22,11 +22,22 @@
 
 #include "SDL_hints.h"
 #include "SDL_error.h"
+#include "SDL_atomic.h"
+#include "SDL_hints_c.h"
 
 
-/* Assuming there aren't many hints set and they aren't being queried in
-   critical performance paths, we'll just use linked lists here.
+/* Hints are kept in a small hash table keyed by name.  Each entry holds
+   its own copy of the name and of the environment variable of the same
+   name, which is read once when the entry is created.  Anything that
+   changes a value bumps SDL_hint_version, which is how SDL_HintCache
+   knows its parsed values are stale.
+
+   Hints are read from any thread, so reading never creates an entry.
+   Entries are only added by SDL_SetHint() and SDL_AddHintCallback(),
+   under SDL_hints_lock, and are fully built before they're linked in.
  */
+#define SDL_HINT_BUCKETS    64
+
 typedef struct SDL_HintWatch {
     SDL_HintCallback callback;
     void *userdata;
@@ -35,19 +46,117 @@ typedef struct SDL_HintWatch {
 
 typedef struct SDL_Hint {
     char *name;
+    Uint32 hash;
     char *value;
+    char *env;
     SDL_HintPriority priority;
     SDL_HintWatch *callbacks;
     struct SDL_Hint *next;
 } SDL_Hint;
 
-static SDL_Hint *SDL_hints;
+static SDL_Hint *SDL_hints[SDL_HINT_BUCKETS];
+static SDL_SpinLock SDL_hints_lock;
+
+SDL_atomic_t SDL_hint_version = { 1 };
+
+static Uint32
+SDL_HashHintName(const char *name)
+{
+    Uint32 hash = 2166136261u;
+
+    while (*name) {
+        hash = (hash ^ (Uint8)*name++) * 16777619u;
+    }
+    return hash;
+}
+
+static SDL_Hint *
+SDL_FindHintInBucket(SDL_Hint *hint, const char *name, Uint32 hash)
+{
+    for ( ; hint; hint = hint->next) {
+        if (hint->hash == hash && SDL_strcmp(name, hint->name) == 0) {
+            return hint;
+        }
+    }
+    return NULL;
+}
+
+/* Find the entry for a hint, creating it if asked to */
+static SDL_Hint *
+SDL_FindHint(const char *name, SDL_bool create)
+{
+    const Uint32 hash = SDL_HashHintName(name);
+    SDL_Hint **bucket = &SDL_hints[hash % SDL_HINT_BUCKETS];
+    SDL_Hint *hint, *found;
+    const char *env;
+
+    hint = SDL_FindHintInBucket(*bucket, name, hash);
+    if (hint || !create) {
+        return hint;
+    }
+
+    hint = (SDL_Hint *)SDL_malloc(sizeof(*hint));
+    if (!hint) {
+        return NULL;
+    }
+    hint->name = SDL_strdup(name);
+    if (!hint->name) {
+        SDL_free(hint);
+        return NULL;
+    }
+    hint->hash = hash;
+    hint->value = NULL;
+    env = SDL_getenv(name);
+    hint->env = env ? SDL_strdup(env) : NULL;
+    hint->priority = SDL_HINT_DEFAULT;
+    hint->callbacks = NULL;
+
+    /* Another thread may have added it while this one was allocating */
+    SDL_AtomicLock(&SDL_hints_lock);
+    found = SDL_FindHintInBucket(*bucket, name, hash);
+    if (!found) {
+        hint->next = *bucket;
+        SDL_MemoryBarrierRelease();
+        *bucket = hint;
+    }
+    SDL_AtomicUnlock(&SDL_hints_lock);
+
+    if (found) {
+        SDL_free(hint->name);
+        SDL_free(hint->env);
+        SDL_free(hint);
+        return found;
+    }
+    return hint;
+}
+
+/* The environment wins over hints that aren't set with SDL_HINT_OVERRIDE */
+static const char *
+SDL_GetHintValue(const SDL_Hint *hint)
+{
+    if (!hint->env || hint->priority == SDL_HINT_OVERRIDE) {
+        return hint->value;
+    }
+    return hint->env;
+}
+
+/* Returns -1 if the value doesn't say either way */
+static int
+SDL_ParseHintBoolean(const char *value)
+{
+    if (!value || !*value) {
+        return -1;
+    }
+    if (*value == '0' || SDL_strcasecmp(value, "false") == 0) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
 
 SDL_bool
 SDL_SetHintWithPriority(const char *name, const char *value,
                         SDL_HintPriority priority)
 {
-    const char *env;
     SDL_Hint *hint;
     SDL_HintWatch *entry;
 
@@ -55,42 +164,28 @@ SDL_SetHintWithPriority(const char *name, const char *value,
         return SDL_FALSE;
     }
 
-    env = SDL_getenv(name);
-    if (env && priority < SDL_HINT_OVERRIDE) {
+    hint = SDL_FindHint(name, SDL_TRUE);
+    if (!hint) {
         return SDL_FALSE;
     }
-
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            if (priority < hint->priority) {
-                return SDL_FALSE;
-            }
-            if (!hint->value || !value || SDL_strcmp(hint->value, value) != 0) {
-                for (entry = hint->callbacks; entry; ) {
-                    /* Save the next entry in case this one is deleted */
-                    SDL_HintWatch *next = entry->next;
-                    entry->callback(entry->userdata, name, hint->value, value);
-                    entry = next;
-                }
-                SDL_free(hint->value);
-                hint->value = value ? SDL_strdup(value) : NULL;
-            }
-            hint->priority = priority;
-            return SDL_TRUE;
-        }
+    if (hint->env && priority < SDL_HINT_OVERRIDE) {
+        return SDL_FALSE;
     }
-
-    /* Couldn't find the hint, add a new one */
-    hint = (SDL_Hint *)SDL_malloc(sizeof(*hint));
-    if (!hint) {
+    if (priority < hint->priority) {
         return SDL_FALSE;
     }
-    hint->name = SDL_strdup(name);
-    hint->value = value ? SDL_strdup(value) : NULL;
+    if (!hint->value || SDL_strcmp(hint->value, value) != 0) {
+        for (entry = hint->callbacks; entry; ) {
+            /* Save the next entry in case this one is deleted */
+            SDL_HintWatch *next = entry->next;
+            entry->callback(entry->userdata, name, hint->value, value);
+            entry = next;
+        }
+        SDL_free(hint->value);
+        hint->value = SDL_strdup(value);
+    }
     hint->priority = priority;
-    hint->callbacks = NULL;
-    hint->next = SDL_hints;
-    SDL_hints = hint;
+    SDL_AtomicIncRef(&SDL_hint_version);
     return SDL_TRUE;
 }
 
@@ -103,32 +198,43 @@ SDL_SetHint(const char *name, const char *value)
 const char *
 SDL_GetHint(const char *name)
 {
-    const char *env;
     SDL_Hint *hint;
 
-    env = SDL_getenv(name);
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            if (!env || hint->priority == SDL_HINT_OVERRIDE) {
-                return hint->value;
-            }
-            break;
-        }
+    if (!name) {
+        return NULL;
     }
-    return env;
+
+    hint = SDL_FindHint(name, SDL_FALSE);
+    if (!hint) {
+        return SDL_getenv(name);
+    }
+    return SDL_GetHintValue(hint);
 }
 
 SDL_bool
 SDL_GetHintBoolean(const char *name, SDL_bool default_value)
 {
-    const char *hint = SDL_GetHint(name);
-    if (!hint || !*hint) {
-        return default_value;
-    }
-    if (*hint == '0' || SDL_strcasecmp(hint, "false") == 0) {
-        return SDL_FALSE;
+    const int value = SDL_ParseHintBoolean(SDL_GetHint(name));
+
+    return (value < 0) ? default_value : (SDL_bool)value;
+}
+
+void
+SDL_RefreshHintCache(SDL_HintCache *cache)
+{
+    const int version = SDL_AtomicGet(&SDL_hint_version);
+    const char *value = SDL_GetHint(cache->name);
+
+    cache->value = value;
+    cache->boolean = SDL_ParseHintBoolean(value);
+    if (value && *value) {
+        cache->int_value = SDL_atoi(value);
+        cache->float_value = (float)SDL_atof(value);
+    } else {
+        cache->int_value = 0;
+        cache->float_value = 0.0f;
     }
-    return SDL_TRUE;
+    cache->version = version;
 }
 
 void
@@ -157,25 +263,11 @@ SDL_AddHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
     entry->callback = callback;
     entry->userdata = userdata;
 
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            break;
-        }
-    }
+    hint = SDL_FindHint(name, SDL_TRUE);
     if (!hint) {
-        /* Need to add a hint entry for this watcher */
-        hint = (SDL_Hint *)SDL_malloc(sizeof(*hint));
-        if (!hint) {
-            SDL_OutOfMemory();
-            SDL_free(entry);
-            return;
-        }
-        hint->name = SDL_strdup(name);
-        hint->value = NULL;
-        hint->priority = SDL_HINT_DEFAULT;
-        hint->callbacks = NULL;
-        hint->next = SDL_hints;
-        SDL_hints = hint;
+        SDL_OutOfMemory();
+        SDL_free(entry);
+        return;
     }
 
     /* Add it to the callbacks for this hint */
@@ -193,23 +285,23 @@ SDL_DelHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
     SDL_Hint *hint;
     SDL_HintWatch *entry, *prev;
 
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            prev = NULL;
-            for (entry = hint->callbacks; entry; entry = entry->next) {
-                if (callback == entry->callback && userdata == entry->userdata) {
-                    if (prev) {
-                        prev->next = entry->next;
-                    } else {
-                        hint->callbacks = entry->next;
-                    }
-                    SDL_free(entry);
-                    break;
-                }
-                prev = entry;
+    hint = SDL_FindHint(name, SDL_FALSE);
+    if (!hint) {
+        return;
+    }
+
+    prev = NULL;
+    for (entry = hint->callbacks; entry; entry = entry->next) {
+        if (callback == entry->callback && userdata == entry->userdata) {
+            if (prev) {
+                prev->next = entry->next;
+            } else {
+                hint->callbacks = entry->next;
             }
-            return;
+            SDL_free(entry);
+            break;
         }
+        prev = entry;
     }
 }
 
@@ -217,20 +309,25 @@ void SDL_ClearHints(void)
 {
     SDL_Hint *hint;
     SDL_HintWatch *entry;
+    int i;
 
-    while (SDL_hints) {
-        hint = SDL_hints;
-        SDL_hints = hint->next;
+    for (i = 0; i < SDL_HINT_BUCKETS; ++i) {
+        while (SDL_hints[i]) {
+            hint = SDL_hints[i];
+            SDL_hints[i] = hint->next;
 
-        SDL_free(hint->name);
-        SDL_free(hint->value);
-        for (entry = hint->callbacks; entry; ) {
-            SDL_HintWatch *freeable = entry;
-            entry = entry->next;
-            SDL_free(freeable);
+            SDL_free(hint->name);
+            SDL_free(hint->value);
+            SDL_free(hint->env);
+            for (entry = hint->callbacks; entry; ) {
+                SDL_HintWatch *freeable = entry;
+                entry = entry->next;
+                SDL_free(freeable);
+            }
+            SDL_free(hint);
         }
-        SDL_free(hint);
     }
+    SDL_AtomicIncRef(&SDL_hint_version);
 }
 
 /* vi: set ts=4 sw=4 expandtab: */
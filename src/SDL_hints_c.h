@@ -0,0 +1,88 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef SDL_hints_c_h_
+#define SDL_hints_c_h_
+
+#include "SDL_atomic.h"
+
+/* A hint value that is parsed once and kept until any hint changes.
+   Use these for hints that are read on hot paths:
+
+    static SDL_HintCache cache = SDL_HINT_CACHE_INIT(SDL_HINT_FOO);
+    if (SDL_GetHintBooleanCached(&cache, SDL_FALSE)) ...
+ */
+typedef struct SDL_HintCache
+{
+    const char *name;
+    int version;
+    const char *value;
+    int boolean;            /* -1 if the hint is unset or empty */
+    int int_value;
+    float float_value;
+} SDL_HintCache;
+
+#define SDL_HINT_CACHE_INIT(name) { name, 0, NULL, -1, 0, 0.0f }
+
+/* Bumped whenever a hint is set or the hints are cleared */
+extern SDL_atomic_t SDL_hint_version;
+
+extern void SDL_RefreshHintCache(SDL_HintCache *cache);
+
+SDL_FORCE_INLINE const char *
+SDL_GetHintCached(SDL_HintCache *cache)
+{
+    if (cache->version != SDL_AtomicGet(&SDL_hint_version)) {
+        SDL_RefreshHintCache(cache);
+    }
+    return cache->value;
+}
+
+SDL_FORCE_INLINE SDL_bool
+SDL_GetHintBooleanCached(SDL_HintCache *cache, SDL_bool default_value)
+{
+    if (cache->version != SDL_AtomicGet(&SDL_hint_version)) {
+        SDL_RefreshHintCache(cache);
+    }
+    return (cache->boolean < 0) ? default_value : (SDL_bool)cache->boolean;
+}
+
+SDL_FORCE_INLINE int
+SDL_GetHintIntCached(SDL_HintCache *cache, int default_value)
+{
+    if (cache->version != SDL_AtomicGet(&SDL_hint_version)) {
+        SDL_RefreshHintCache(cache);
+    }
+    return (cache->boolean < 0) ? default_value : cache->int_value;
+}
+
+SDL_FORCE_INLINE float
+SDL_GetHintFloatCached(SDL_HintCache *cache, float default_value)
+{
+    if (cache->version != SDL_AtomicGet(&SDL_hint_version)) {
+        SDL_RefreshHintCache(cache);
+    }
+    return (cache->boolean < 0) ? default_value : cache->float_value;
+}
+
+#endif /* SDL_hints_c_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -59,6 +59,38 @@
 
 #include "SDL_config.h"
 
+#if SDL_MEMORY_ACCOUNTING
+/* Account SDL's own allocations to the subsystem that made them.  The build
+   defines SDL_MEMORY_TAG for the sources of the subsystems it tracks. */
+#include "SDL_stdinc.h"
+#include "SDL_memstats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+extern void *SDL_TaggedMalloc(size_t size, SDL_MemoryTag tag);
+extern void *SDL_TaggedCalloc(size_t nmemb, size_t size, SDL_MemoryTag tag);
+extern void *SDL_TaggedRealloc(void *ptr, size_t size, SDL_MemoryTag tag);
+extern void SDLCALL SDL_TaggedFree(void *ptr);
+#ifdef __cplusplus
+}
+#endif
+
+#ifndef SDL_MALLOC_IMPLEMENTATION
+#ifndef SDL_MEMORY_TAG
+#define SDL_MEMORY_TAG SDL_MEMORY_TAG_STDLIB
+#endif
+#undef SDL_malloc
+#undef SDL_calloc
+#undef SDL_realloc
+#undef SDL_free
+#define SDL_malloc(size) SDL_TaggedMalloc(size, SDL_MEMORY_TAG)
+#define SDL_calloc(nmemb, size) SDL_TaggedCalloc(nmemb, size, SDL_MEMORY_TAG)
+#define SDL_realloc(ptr, size) SDL_TaggedRealloc(ptr, size, SDL_MEMORY_TAG)
+#define SDL_free SDL_TaggedFree
+#endif
+#endif /* SDL_MEMORY_ACCOUNTING */
+
 #endif /* SDL_internal_h_ */
 
 /* vi: set ts=4 sw=4 expandtab: */
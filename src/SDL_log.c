@@ -28,6 +28,12 @@
 
 #include "SDL_error.h"
 #include "SDL_log.h"
+#include "SDL_atomic.h"
+#include "SDL_mutex.h"
+#include "SDL_thread.h"
+#include "SDL_timer.h"
+#include "thread/SDL_systhread.h"
+#include "atomic/SDL_atomic_c.h"
 
 #if HAVE_STDIO_H
 #include <stdio.h>
@@ -42,6 +48,14 @@
 #define DEFAULT_APPLICATION_PRIORITY    SDL_LOG_PRIORITY_INFO
 #define DEFAULT_TEST_PRIORITY           SDL_LOG_PRIORITY_VERBOSE
 
+/* Asynchronous logging keeps a fixed pool of records, messages that don't
+   fit in a record's buffer are truncated. */
+#define SDL_LOG_ASYNC_RECORDS           128
+#define SDL_LOG_ASYNC_TEXT_SIZE         256
+
+/* How long SDL_LogFlush() waits for the log thread before writing anyway */
+#define SDL_LOG_FLUSH_TIMEOUT           100
+
 typedef struct SDL_LogLevel
 {
     int category;
@@ -49,6 +63,14 @@ typedef struct SDL_LogLevel
     struct SDL_LogLevel *next;
 } SDL_LogLevel;
 
+typedef struct SDL_LogRecord
+{
+    SDL_AtomicStackNode node;
+    int category;
+    SDL_LogPriority priority;
+    char text[SDL_LOG_ASYNC_TEXT_SIZE];
+} SDL_LogRecord;
+
 /* The default log output function */
 static void SDLCALL SDL_LogOutput(void *userdata, int category, SDL_LogPriority priority, const char *message);
 
@@ -60,6 +82,18 @@ static SDL_LogPriority SDL_test_priority = DEFAULT_TEST_PRIORITY;
 static SDL_LogOutputFunction SDL_log_function = SDL_LogOutput;
 static void *SDL_log_userdata = NULL;
 
+static SDL_atomic_t SDL_log_async_active;
+static SDL_atomic_t SDL_log_async_users;
+static SDL_atomic_t SDL_log_async_running;
+static SDL_atomic_t SDL_log_dropped;
+static int SDL_log_dropped_reported;
+static SDL_LogRecord *SDL_log_records;
+static SDL_AtomicStack SDL_log_free_records;
+static SDL_AtomicQueue *SDL_log_queue;
+static SDL_sem *SDL_log_wakeup;
+static SDL_mutex *SDL_log_output_lock;
+static SDL_Thread *SDL_log_thread;
+
 static const char *SDL_priority_prefixes[SDL_NUM_LOG_PRIORITIES] = {
     NULL,
     "VERBOSE",
@@ -261,11 +295,211 @@ GetCategoryPrefix(int category)
 }
 #endif /* __ANDROID__ */
 
+/* Chop off a final endline, returning the new length of the message */
+static size_t
+SDL_LogChopEndline(char *message)
+{
+    size_t len = SDL_strlen(message);
+
+    if ((len > 0) && (message[len-1] == '\n')) {
+        message[--len] = '\0';
+        if ((len > 0) && (message[len-1] == '\r')) {  /* catch "\r\n", too. */
+            message[--len] = '\0';
+        }
+    }
+    return len;
+}
+
+/* Format a message into a free record and queue it for the log thread.
+   The arguments can't outlive the call, so the message is formatted here
+   and only the output is deferred. */
+static void
+SDL_LogQueueMessage(int category, SDL_LogPriority priority, const char *fmt, va_list ap)
+{
+    SDL_LogRecord *record;
+    int len;
+
+    record = (SDL_LogRecord *)SDL_AtomicStackPop(&SDL_log_free_records);
+    if (!record) {
+        SDL_AtomicIncRef(&SDL_log_dropped);
+        return;
+    }
+    record->category = category;
+    record->priority = priority;
+
+    /* Don't go to the heap for long messages, mark them as cut short instead */
+    len = SDL_vsnprintf(record->text, sizeof(record->text), fmt, ap);
+    if (len >= (int)sizeof(record->text)) {
+        SDL_strlcpy(&record->text[sizeof(record->text) - 4], "...", 4);
+    } else {
+        SDL_LogChopEndline(record->text);
+    }
+
+    /* The queue holds every record, so this can't fail */
+    SDL_AtomicQueuePush(SDL_log_queue, record);
+    SDL_SemPost(SDL_log_wakeup);
+}
+
+/* Write out every queued message, with the output lock held unless the
+   lock couldn't be had. Returns the number written. */
+static int
+SDL_LogWriteQueue(void)
+{
+    void *item;
+    int count = 0;
+    int dropped;
+
+    while (SDL_AtomicQueuePop(SDL_log_queue, &item)) {
+        SDL_LogRecord *record = (SDL_LogRecord *)item;
+
+        if (SDL_log_function) {
+            SDL_log_function(SDL_log_userdata, record->category, record->priority, record->text);
+        }
+        SDL_AtomicStackPush(&SDL_log_free_records, &record->node);
+        ++count;
+    }
+
+    dropped = SDL_AtomicGet(&SDL_log_dropped);
+    if (dropped != SDL_log_dropped_reported && SDL_log_function) {
+        char message[64];
+
+        SDL_snprintf(message, sizeof(message), "%d log messages were dropped", dropped - SDL_log_dropped_reported);
+        SDL_log_function(SDL_log_userdata, SDL_LOG_CATEGORY_SYSTEM, SDL_LOG_PRIORITY_WARN, message);
+        SDL_log_dropped_reported = dropped;
+    }
+    return count;
+}
+
+static int
+SDL_LogDrainQueue(void)
+{
+    int count;
+
+    SDL_LockMutex(SDL_log_output_lock);
+    count = SDL_LogWriteQueue();
+    SDL_UnlockMutex(SDL_log_output_lock);
+
+    return count;
+}
+
+static int SDLCALL
+SDL_LogThread(void *data)
+{
+    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_LOW);
+
+    while (SDL_AtomicGet(&SDL_log_async_running)) {
+        SDL_SemWait(SDL_log_wakeup);
+        SDL_LogDrainQueue();
+    }
+    return 0;
+}
+
+static void
+SDL_LogStopAsync(void)
+{
+    if (SDL_log_thread) {
+        SDL_AtomicSet(&SDL_log_async_running, 0);
+        SDL_SemPost(SDL_log_wakeup);
+        SDL_WaitThread(SDL_log_thread, NULL);
+        SDL_log_thread = NULL;
+    }
+    if (SDL_log_queue) {
+        SDL_LogDrainQueue();
+        SDL_DestroyAtomicQueue(SDL_log_queue);
+        SDL_log_queue = NULL;
+    }
+    if (SDL_log_wakeup) {
+        SDL_DestroySemaphore(SDL_log_wakeup);
+        SDL_log_wakeup = NULL;
+    }
+    if (SDL_log_output_lock) {
+        SDL_DestroyMutex(SDL_log_output_lock);
+        SDL_log_output_lock = NULL;
+    }
+    SDL_zero(SDL_log_free_records);
+    SDL_free(SDL_log_records);
+    SDL_log_records = NULL;
+}
+
+int
+SDL_LogSetAsync(SDL_bool enabled)
+{
+    int i;
+
+    if (enabled == (SDL_AtomicGet(&SDL_log_async_active) != 0)) {
+        return 0;
+    }
+
+    if (!enabled) {
+        /* Wait for threads that are queuing a message right now */
+        SDL_AtomicSet(&SDL_log_async_active, 0);
+        while (SDL_AtomicGet(&SDL_log_async_users) > 0) {
+            SDL_Delay(0);
+        }
+        SDL_LogStopAsync();
+        return 0;
+    }
+
+    SDL_log_records = (SDL_LogRecord *)SDL_calloc(SDL_LOG_ASYNC_RECORDS, sizeof(*SDL_log_records));
+    SDL_log_queue = SDL_CreateAtomicQueue(SDL_LOG_ASYNC_RECORDS);
+    SDL_log_wakeup = SDL_CreateSemaphore(0);
+    SDL_log_output_lock = SDL_CreateMutex();
+    if (!SDL_log_records || !SDL_log_queue || !SDL_log_wakeup || !SDL_log_output_lock) {
+        SDL_LogStopAsync();
+        return SDL_OutOfMemory();
+    }
+    for (i = 0; i < SDL_LOG_ASYNC_RECORDS; ++i) {
+        SDL_AtomicStackPush(&SDL_log_free_records, &SDL_log_records[i].node);
+    }
+
+    SDL_AtomicSet(&SDL_log_async_running, 1);
+    SDL_log_thread = SDL_CreateThreadInternal(SDL_LogThread, "SDLLog", 0, NULL);
+    if (!SDL_log_thread) {
+        SDL_AtomicSet(&SDL_log_async_running, 0);
+        SDL_LogStopAsync();
+        return -1;
+    }
+
+    SDL_AtomicSet(&SDL_log_async_active, 1);
+    return 0;
+}
+
+void
+SDL_LogFlush(void)
+{
+    if (SDL_AtomicGet(&SDL_log_async_active)) {
+        SDL_AtomicIncRef(&SDL_log_async_users);
+        if (SDL_AtomicGet(&SDL_log_async_active)) {
+            /* This is called on the way down after a crash, when the log
+               thread may never let go of the lock, so only wait a little
+               while before writing the messages out without it. */
+            const Uint32 timeout = SDL_GetTicks() + SDL_LOG_FLUSH_TIMEOUT;
+            SDL_bool locked;
+
+            locked = (SDL_TryLockMutex(SDL_log_output_lock) == 0);
+            while (!locked && !SDL_TICKS_PASSED(SDL_GetTicks(), timeout)) {
+                SDL_Delay(1);
+                locked = (SDL_TryLockMutex(SDL_log_output_lock) == 0);
+            }
+            SDL_LogWriteQueue();
+            if (locked) {
+                SDL_UnlockMutex(SDL_log_output_lock);
+            }
+        }
+        (void)SDL_AtomicDecRef(&SDL_log_async_users);
+    }
+}
+
+int
+SDL_LogGetDroppedCount(void)
+{
+    return SDL_AtomicGet(&SDL_log_dropped);
+}
+
 void
 SDL_LogMessageV(int category, SDL_LogPriority priority, const char *fmt, va_list ap)
 {
     char *message;
-    size_t len;
 
     /* Nothing to do if we don't have an output function */
     if (!SDL_log_function) {
@@ -282,6 +516,21 @@ SDL_LogMessageV(int category, SDL_LogPriority priority, const char *fmt, va_list
         return;
     }
 
+    /* Hand the message to the log thread if asynchronous logging is on */
+    if (SDL_AtomicGet(&SDL_log_async_active)) {
+        SDL_bool queued = SDL_FALSE;
+
+        SDL_AtomicIncRef(&SDL_log_async_users);
+        if (SDL_AtomicGet(&SDL_log_async_active)) {
+            SDL_LogQueueMessage(category, priority, fmt, ap);
+            queued = SDL_TRUE;
+        }
+        (void)SDL_AtomicDecRef(&SDL_log_async_users);
+        if (queued) {
+            return;
+        }
+    }
+
     /* !!! FIXME: why not just "char message[SDL_MAX_LOG_MESSAGE];" ? */
     message = SDL_stack_alloc(char, SDL_MAX_LOG_MESSAGE);
     if (!message) {
@@ -291,13 +540,7 @@ SDL_LogMessageV(int category, SDL_LogPriority priority, const char *fmt, va_list
     SDL_vsnprintf(message, SDL_MAX_LOG_MESSAGE, fmt, ap);
 
     /* Chop off final endline. */
-    len = SDL_strlen(message);
-    if ((len > 0) && (message[len-1] == '\n')) {
-        message[--len] = '\0';
-        if ((len > 0) && (message[len-1] == '\r')) {  /* catch "\r\n", too. */
-            message[--len] = '\0';
-        }
-    }
+    SDL_LogChopEndline(message);
 
     SDL_log_function(SDL_log_userdata, category, priority, message);
     SDL_stack_free(message);
@@ -0,0 +1,97 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+#ifndef SDL_atomic_c_h_
+#define SDL_atomic_c_h_
+
+#include "SDL_atomic.h"
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <xmmintrin.h>
+#endif
+
+/* "REP NOP" is PAUSE, coded for tools that don't know it by that name. */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+    #define PAUSE_INSTRUCTION() __asm__ __volatile__("pause\n")  /* Some assemblers can't do REP NOP, so go with PAUSE. */
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    #define PAUSE_INSTRUCTION() _mm_pause()  /* this is actually "rep nop" and not a SIMD instruction. No inline asm in MSVC x86-64! */
+#elif defined(__WATCOMC__) && defined(__386__)
+    /* watcom assembler rejects PAUSE if CPU < i686, and it refuses REP NOP as an invalid combination. Hardcode the bytes.  */
+    extern _inline void PAUSE_INSTRUCTION(void);
+    #pragma aux PAUSE_INSTRUCTION = "db 0f3h,90h"
+#else
+    #define PAUSE_INSTRUCTION()
+#endif
+
+/* The top of the stack and its ABA counter are swapped together, with
+   CMPXCHG8B on 32-bit x86, so the pair must not straddle a cache line.
+   SDL embeds stacks in its own structures, applications create them.
+ */
+#if defined(_MSC_VER)
+#if defined(_M_IX86) || defined(_M_ARM)
+#define SDL_ATOMIC_STACK_ALIGN  __declspec(align(8))
+#else
+#define SDL_ATOMIC_STACK_ALIGN  __declspec(align(16))
+#endif
+#elif defined(__GNUC__) || defined(__clang__)
+#define SDL_ATOMIC_STACK_ALIGN  __attribute__((aligned(2 * sizeof(void *))))
+#else
+#define SDL_ATOMIC_STACK_ALIGN
+#endif
+
+struct SDL_AtomicStack
+{
+    SDL_ATOMIC_STACK_ALIGN SDL_AtomicStackNode *head;
+    size_t tag;
+    SDL_SpinLock lock;
+};
+
+/* The longest run of PAUSE instructions we'll do before giving up the CPU */
+#define SDL_SPIN_BACKOFF_LIMIT  64
+
+/* Returns SDL_TRUE if spinning on a lock can help, which it can't when the
+   thread holding it can't be running on another CPU at the same time.
+ */
+extern SDL_bool SDL_ShouldSpin(void);
+
+/* Spin for a while, twice as long as the last time this was called with
+   the same counter (which should start at 1).  Returns SDL_FALSE without
+   spinning once the limit is reached, and the caller should block instead.
+ */
+SDL_FORCE_INLINE SDL_bool
+SDL_SpinBackoff(int *backoff)
+{
+    int i;
+
+    if (*backoff > SDL_SPIN_BACKOFF_LIMIT) {
+        return SDL_FALSE;
+    }
+    for (i = 0; i < *backoff; ++i) {
+        PAUSE_INSTRUCTION();
+    }
+    *backoff *= 2;
+    return SDL_TRUE;
+}
+
+#endif /* SDL_atomic_c_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
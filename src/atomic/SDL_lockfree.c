@@ -0,0 +1,399 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+#include "SDL_atomic.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_error.h"
+#include "SDL_atomic_c.h"
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1500)
+#include <intrin.h>
+#endif
+
+/* The stack's ABA counter has to change atomically with the top pointer.
+   Pick how to do that:
+
+   - On 64-bit platforms where user space pointers fit in 48 bits, the
+     counter lives in the top 16 bits of the head pointer.
+   - On 32-bit x86 the pointer and counter are swapped together with
+     CMPXCHG8B.
+   - Everywhere else the stack is protected by a spinlock.
+
+   Android on ARM64 is excluded because it puts tags in the top byte of
+   heap pointers.
+ */
+#if (defined(__x86_64__) || defined(_M_X64) || (defined(__aarch64__) && !defined(__ANDROID__)))
+#define SDL_STACK_PACKED_TAG 1
+#define SDL_STACK_POINTER_BITS 48
+#define SDL_STACK_POINTER_MASK ((((Uint64)1) << SDL_STACK_POINTER_BITS) - 1)
+#elif defined(__i386__) && (defined(__GNUC__) || defined(__clang__)) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)
+#define SDL_STACK_DOUBLE_CAS 1
+#elif defined(_MSC_VER) && (_MSC_VER >= 1500) && defined(_M_IX86)
+#define SDL_STACK_DOUBLE_CAS 1
+#endif
+
+
+/* Bounded MPMC queue, after Dmitry Vyukov's design.  Each cell carries a
+   sequence number that says whether it's ready to be written (equal to the
+   enqueue position) or read (equal to the dequeue position + 1), so the
+   producers and consumers only contend on their own position counter.
+ */
+typedef struct
+{
+    SDL_atomic_t sequence;
+    void *data;
+} SDL_AtomicQueueCell;
+
+struct SDL_AtomicQueue
+{
+    SDL_AtomicQueueCell *cells;
+    Uint32 mask;
+
+    /* Padding to keep the producer and consumer positions on separate cache lines */
+    char cache_pad1[SDL_CACHELINE_SIZE];
+    SDL_atomic_t enqueue_pos;
+    char cache_pad2[SDL_CACHELINE_SIZE];
+    SDL_atomic_t dequeue_pos;
+    char cache_pad3[SDL_CACHELINE_SIZE];
+};
+
+SDL_AtomicQueue *
+SDL_CreateAtomicQueue(Uint32 capacity)
+{
+    SDL_AtomicQueue *queue;
+    Uint32 size = 2;
+    Uint32 i;
+
+    if (capacity > 0x40000000) {
+        SDL_InvalidParamError("capacity");
+        return NULL;
+    }
+    while (size < capacity) {
+        size *= 2;
+    }
+
+    queue = (SDL_AtomicQueue *)SDL_calloc(1, sizeof(*queue));
+    if (!queue) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    queue->cells = (SDL_AtomicQueueCell *)SDL_malloc(size * sizeof(*queue->cells));
+    if (!queue->cells) {
+        SDL_free(queue);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    queue->mask = size - 1;
+    for (i = 0; i < size; ++i) {
+        SDL_AtomicSet(&queue->cells[i].sequence, (int)i);
+        queue->cells[i].data = NULL;
+    }
+    SDL_AtomicSet(&queue->enqueue_pos, 0);
+    SDL_AtomicSet(&queue->dequeue_pos, 0);
+    return queue;
+}
+
+SDL_bool
+SDL_AtomicQueuePush(SDL_AtomicQueue *queue, void *item)
+{
+    SDL_AtomicQueueCell *cell;
+    Uint32 pos;
+
+    if (!queue) {
+        return SDL_FALSE;
+    }
+
+    pos = (Uint32)SDL_AtomicGet(&queue->enqueue_pos);
+    for ( ; ; ) {
+        Sint32 delta;
+
+        cell = &queue->cells[pos & queue->mask];
+        delta = (Sint32)((Uint32)SDL_AtomicGet(&cell->sequence) - pos);
+        if (delta == 0) {
+            if (SDL_AtomicCAS(&queue->enqueue_pos, (int)pos, (int)(pos + 1))) {
+                break;
+            }
+        } else if (delta < 0) {
+            /* The cell still holds an item from the last lap, we're full */
+            return SDL_FALSE;
+        }
+        pos = (Uint32)SDL_AtomicGet(&queue->enqueue_pos);
+    }
+
+    cell->data = item;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&cell->sequence, (int)(pos + 1));
+    return SDL_TRUE;
+}
+
+SDL_bool
+SDL_AtomicQueuePop(SDL_AtomicQueue *queue, void **item)
+{
+    SDL_AtomicQueueCell *cell;
+    Uint32 pos;
+
+    if (!queue) {
+        return SDL_FALSE;
+    }
+
+    pos = (Uint32)SDL_AtomicGet(&queue->dequeue_pos);
+    for ( ; ; ) {
+        Sint32 delta;
+
+        cell = &queue->cells[pos & queue->mask];
+        delta = (Sint32)((Uint32)SDL_AtomicGet(&cell->sequence) - (pos + 1));
+        if (delta == 0) {
+            if (SDL_AtomicCAS(&queue->dequeue_pos, (int)pos, (int)(pos + 1))) {
+                break;
+            }
+        } else if (delta < 0) {
+            /* Nothing has been written to this cell yet, we're empty */
+            return SDL_FALSE;
+        }
+        pos = (Uint32)SDL_AtomicGet(&queue->dequeue_pos);
+    }
+
+    SDL_MemoryBarrierAcquire();
+    if (item) {
+        *item = cell->data;
+    }
+    SDL_AtomicSet(&cell->sequence, (int)(pos + queue->mask + 1));
+    return SDL_TRUE;
+}
+
+void
+SDL_DestroyAtomicQueue(SDL_AtomicQueue *queue)
+{
+    if (queue) {
+        SDL_free(queue->cells);
+        SDL_free(queue);
+    }
+}
+
+
+SDL_AtomicStack *
+SDL_CreateAtomicStack(void)
+{
+    SDL_AtomicStack *stack = (SDL_AtomicStack *)SDL_calloc(1, sizeof(*stack));
+
+    if (!stack) {
+        SDL_OutOfMemory();
+    }
+    return stack;
+}
+
+void
+SDL_DestroyAtomicStack(SDL_AtomicStack *stack)
+{
+    SDL_free(stack);
+}
+
+#if SDL_STACK_PACKED_TAG
+
+SDL_FORCE_INLINE SDL_AtomicStackNode *
+GetHeadNode(void *head)
+{
+    return (SDL_AtomicStackNode *)(uintptr_t)((Uint64)(uintptr_t)head & SDL_STACK_POINTER_MASK);
+}
+
+SDL_FORCE_INLINE void *
+MakeHead(SDL_AtomicStackNode *node, void *oldhead)
+{
+    const Uint64 tag = ((Uint64)(uintptr_t)oldhead >> SDL_STACK_POINTER_BITS) + 1;
+    return (void *)(uintptr_t)((Uint64)(uintptr_t)node | (tag << SDL_STACK_POINTER_BITS));
+}
+
+void
+SDL_AtomicStackPush(SDL_AtomicStack *stack, SDL_AtomicStackNode *node)
+{
+    void *head;
+
+    do {
+        head = SDL_AtomicGetPtr((void **)&stack->head);
+        node->next = GetHeadNode(head);
+    } while (!SDL_AtomicCASPtr((void **)&stack->head, head, MakeHead(node, head)));
+}
+
+SDL_AtomicStackNode *
+SDL_AtomicStackPop(SDL_AtomicStack *stack)
+{
+    SDL_AtomicStackNode *node;
+    void *head;
+
+    do {
+        head = SDL_AtomicGetPtr((void **)&stack->head);
+        node = GetHeadNode(head);
+        if (!node) {
+            return NULL;
+        }
+        /* The node may be popped by someone else before this read, but the
+           tag will have changed too and the swap below will fail.
+         */
+    } while (!SDL_AtomicCASPtr((void **)&stack->head, head, MakeHead(node->next, head)));
+
+    return node;
+}
+
+SDL_AtomicStackNode *
+SDL_AtomicStackPopAll(SDL_AtomicStack *stack)
+{
+    void *head;
+
+    do {
+        head = SDL_AtomicGetPtr((void **)&stack->head);
+        if (!GetHeadNode(head)) {
+            return NULL;
+        }
+    } while (!SDL_AtomicCASPtr((void **)&stack->head, head, MakeHead(NULL, head)));
+
+    return GetHeadNode(head);
+}
+
+#elif SDL_STACK_DOUBLE_CAS
+
+SDL_COMPILE_TIME_ASSERT(stack_head, sizeof(SDL_AtomicStackNode *) == 4 && sizeof(size_t) == 4);
+SDL_COMPILE_TIME_ASSERT(stack_align, (sizeof(SDL_AtomicStack) % 8) == 0);
+
+/* The head pointer is the low half and the tag the high half, on x86 */
+SDL_FORCE_INLINE Uint64
+MakeHead(SDL_AtomicStackNode *node, size_t tag)
+{
+    return (Uint64)(uintptr_t)node | ((Uint64)tag << 32);
+}
+
+SDL_FORCE_INLINE SDL_bool
+CompareAndSwapHead(SDL_AtomicStack *stack, Uint64 oldval, Uint64 newval)
+{
+#if defined(_MSC_VER)
+    return (_InterlockedCompareExchange64((volatile __int64 *)&stack->head, (__int64)newval, (__int64)oldval) == (__int64)oldval);
+#else
+    return __sync_bool_compare_and_swap((volatile Uint64 *)&stack->head, oldval, newval);
+#endif
+}
+
+/* Read the head before the tag: if they change in between, the tag we see
+   is newer than the head and the swap fails instead of matching.  These are
+   plain reads, SDL_AtomicGetPtr() may be emulated with a lock and a write
+   that would race with the swap.  Loads aren't reordered with other loads
+   on x86, so only the compiler needs holding back.
+ */
+SDL_FORCE_INLINE Uint64
+ReadHead(SDL_AtomicStack *stack, SDL_AtomicStackNode **node)
+{
+    size_t tag;
+
+    *node = *(SDL_AtomicStackNode * volatile *)&stack->head;
+    SDL_CompilerBarrier();
+    tag = *(volatile size_t *)&stack->tag;
+    return MakeHead(*node, tag);
+}
+
+SDL_FORCE_INLINE size_t
+NextTag(Uint64 head)
+{
+    return (size_t)(head >> 32) + 1;
+}
+
+void
+SDL_AtomicStackPush(SDL_AtomicStack *stack, SDL_AtomicStackNode *node)
+{
+    SDL_AtomicStackNode *top;
+    Uint64 head;
+
+    do {
+        head = ReadHead(stack, &top);
+        node->next = top;
+    } while (!CompareAndSwapHead(stack, head, MakeHead(node, NextTag(head))));
+}
+
+SDL_AtomicStackNode *
+SDL_AtomicStackPop(SDL_AtomicStack *stack)
+{
+    SDL_AtomicStackNode *top;
+    Uint64 head;
+
+    do {
+        head = ReadHead(stack, &top);
+        if (!top) {
+            return NULL;
+        }
+    } while (!CompareAndSwapHead(stack, head, MakeHead(top->next, NextTag(head))));
+
+    return top;
+}
+
+SDL_AtomicStackNode *
+SDL_AtomicStackPopAll(SDL_AtomicStack *stack)
+{
+    SDL_AtomicStackNode *top;
+    Uint64 head;
+
+    do {
+        head = ReadHead(stack, &top);
+        if (!top) {
+            return NULL;
+        }
+    } while (!CompareAndSwapHead(stack, head, MakeHead(NULL, NextTag(head))));
+
+    return top;
+}
+
+#else
+
+void
+SDL_AtomicStackPush(SDL_AtomicStack *stack, SDL_AtomicStackNode *node)
+{
+    SDL_AtomicLock(&stack->lock);
+    node->next = stack->head;
+    stack->head = node;
+    SDL_AtomicUnlock(&stack->lock);
+}
+
+SDL_AtomicStackNode *
+SDL_AtomicStackPop(SDL_AtomicStack *stack)
+{
+    SDL_AtomicStackNode *node;
+
+    SDL_AtomicLock(&stack->lock);
+    node = stack->head;
+    if (node) {
+        stack->head = node->next;
+    }
+    SDL_AtomicUnlock(&stack->lock);
+    return node;
+}
+
+SDL_AtomicStackNode *
+SDL_AtomicStackPopAll(SDL_AtomicStack *stack)
+{
+    SDL_AtomicStackNode *node;
+
+    SDL_AtomicLock(&stack->lock);
+    node = stack->head;
+    stack->head = NULL;
+    SDL_AtomicUnlock(&stack->lock);
+    return node;
+}
+
+#endif /* SDL_STACK_PACKED_TAG */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -27,6 +27,7 @@
 
 
 static int ReadChunk(SDL_RWops * src, Chunk * chunk);
+static void FreeChunk(Chunk * chunk);
 
 struct MS_ADPCM_decodestate
 {
@@ -455,16 +456,19 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
     int samplesize;
 
     /* WAV magic header */
+    Uint32 riff[2] = { 0, 0 };
     Uint32 RIFFchunk;
     Uint32 wavelen = 0;
     Uint32 WAVEmagic;
     Uint32 headerDiff = 0;
 
     /* FMT chunk */
+    Chunk fmt_chunk;
     WaveFMT *format = NULL;
     WaveExtensibleFMT *ext = NULL;
 
     SDL_zero(chunk);
+    SDL_zero(fmt_chunk);
 
     /* Make sure we are passed a valid data source */
     was_error = 0;
@@ -474,8 +478,9 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
     }
 
     /* Check the magic header */
-    RIFFchunk = SDL_ReadLE32(src);
-    wavelen = SDL_ReadLE32(src);
+    SDL_ReadLE32Array(src, riff, SDL_arraysize(riff));
+    RIFFchunk = riff[0];
+    wavelen = riff[1];
     if (wavelen == WAVE) {      /* The RIFFchunk has already been read */
         WAVEmagic = wavelen;
         wavelen = RIFFchunk;
@@ -491,10 +496,8 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
     headerDiff += sizeof(Uint32);       /* for WAVE */
 
     /* Read the audio data format chunk */
-    chunk.data = NULL;
     do {
-        SDL_free(chunk.data);
-        chunk.data = NULL;
+        FreeChunk(&chunk);
         lenread = ReadChunk(src, &chunk);
         if (lenread < 0) {
             was_error = 1;
@@ -505,8 +508,10 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
     } while ((chunk.magic == FACT) || (chunk.magic == LIST) || (chunk.magic == BEXT) || (chunk.magic == JUNK));
 
     /* Decode the audio data format */
-    format = (WaveFMT *) chunk.data;
-    if (chunk.magic != FMT) {
+    fmt_chunk = chunk;
+    chunk.allocated = NULL;
+    format = (WaveFMT *) fmt_chunk.data;
+    if (fmt_chunk.magic != FMT) {
         SDL_SetError("Complex WAVE files not supported");
         was_error = 1;
         goto done;
@@ -611,18 +616,17 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
     /* Read the audio data chunk */
     *audio_buf = NULL;
     do {
-        SDL_free(*audio_buf);
-        *audio_buf = NULL;
+        FreeChunk(&chunk);
         lenread = ReadChunk(src, &chunk);
         if (lenread < 0) {
             was_error = 1;
             goto done;
         }
-        *audio_len = lenread;
-        *audio_buf = chunk.data;
         if (chunk.magic != DATA)
             headerDiff += lenread + 2 * sizeof(Uint32);
     } while (chunk.magic != DATA);
+    *audio_len = lenread;
+    *audio_buf = chunk.allocated;
     headerDiff += 2 * sizeof(Uint32);   /* for the data chunk and len */
 
     if (MS_ADPCM_encoded) {
@@ -650,7 +654,7 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
     *audio_len &= ~(samplesize - 1);
 
   done:
-    SDL_free(format);
+    FreeChunk(&fmt_chunk);
     if (src) {
         if (freesrc) {
             SDL_RWclose(src);
@@ -677,18 +681,43 @@ SDL_FreeWAV(Uint8 * audio_buf)
 static int
 ReadChunk(SDL_RWops * src, Chunk * chunk)
 {
-    chunk->magic = SDL_ReadLE32(src);
-    chunk->length = SDL_ReadLE32(src);
-    chunk->data = (Uint8 *) SDL_malloc(chunk->length);
-    if (chunk->data == NULL) {
+    const void *direct;
+    size_t available;
+    Uint32 header[2] = { 0, 0 };
+
+    SDL_ReadLE32Array(src, header, SDL_arraysize(header));
+    chunk->magic = header[0];
+    chunk->length = header[1];
+    chunk->data = chunk->allocated = NULL;
+
+    /* Header chunks of memory streams are parsed in place, the audio data
+       is returned to the application so it always gets its own copy. */
+    direct = SDL_RWGetPointer(src, &available);
+    if (direct && chunk->magic != DATA && available >= chunk->length &&
+        ((uintptr_t) direct % sizeof(Uint32)) == 0) {
+        chunk->data = (Uint8 *) direct;
+        SDL_RWseek(src, chunk->length, RW_SEEK_CUR);
+        return (chunk->length);
+    }
+
+    chunk->allocated = (Uint8 *) SDL_malloc(chunk->length);
+    if (chunk->allocated == NULL) {
         return SDL_OutOfMemory();
     }
-    if (SDL_RWread(src, chunk->data, chunk->length, 1) != 1) {
-        SDL_free(chunk->data);
-        chunk->data = NULL;
+    if (SDL_RWread(src, chunk->allocated, chunk->length, 1) != 1) {
+        SDL_free(chunk->allocated);
+        chunk->allocated = NULL;
         return SDL_Error(SDL_EFREAD);
     }
+    chunk->data = chunk->allocated;
     return (chunk->length);
 }
 
+static void
+FreeChunk(Chunk * chunk)
+{
+    SDL_free(chunk->allocated);
+    chunk->data = chunk->allocated = NULL;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
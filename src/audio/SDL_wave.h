@@ -63,6 +63,7 @@ typedef struct Chunk
     Uint32 magic;
     Uint32 length;
     Uint8 *data;
+    Uint8 *allocated;   /* NULL if data points into a memory stream */
 } Chunk;
 
 typedef struct WaveExtensibleFMT
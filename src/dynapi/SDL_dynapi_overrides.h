@@ -714,3 +714,60 @@
 #define SDL_RenderCopyExF SDL_RenderCopyExF_REAL
 #define SDL_GetTouchDeviceType SDL_GetTouchDeviceType_REAL
 #define SDL_UIKitRunApp SDL_UIKitRunApp_REAL
+#define SDL_GetJobWorkerCount SDL_GetJobWorkerCount_REAL
+#define SDL_CreateJobGroup SDL_CreateJobGroup_REAL
+#define SDL_SubmitJob SDL_SubmitJob_REAL
+#define SDL_WaitJobGroup SDL_WaitJobGroup_REAL
+#define SDL_DestroyJobGroup SDL_DestroyJobGroup_REAL
+#define SDL_ParallelFor SDL_ParallelFor_REAL
+#define SDL_CreateRWLock SDL_CreateRWLock_REAL
+#define SDL_LockRWLockForReading SDL_LockRWLockForReading_REAL
+#define SDL_LockRWLockForWriting SDL_LockRWLockForWriting_REAL
+#define SDL_TryLockRWLockForReading SDL_TryLockRWLockForReading_REAL
+#define SDL_TryLockRWLockForWriting SDL_TryLockRWLockForWriting_REAL
+#define SDL_UnlockRWLock SDL_UnlockRWLock_REAL
+#define SDL_DestroyRWLock SDL_DestroyRWLock_REAL
+#define SDL_CreateAtomicQueue SDL_CreateAtomicQueue_REAL
+#define SDL_AtomicQueuePush SDL_AtomicQueuePush_REAL
+#define SDL_AtomicQueuePop SDL_AtomicQueuePop_REAL
+#define SDL_DestroyAtomicQueue SDL_DestroyAtomicQueue_REAL
+#define SDL_AtomicStackPush SDL_AtomicStackPush_REAL
+#define SDL_AtomicStackPop SDL_AtomicStackPop_REAL
+#define SDL_AtomicStackPopAll SDL_AtomicStackPopAll_REAL
+#define SDL_GetMemoryTagName SDL_GetMemoryTagName_REAL
+#define SDL_GetMemoryStats SDL_GetMemoryStats_REAL
+#define SDL_DumpMemoryStats SDL_DumpMemoryStats_REAL
+#define SDL_LogSetAsync SDL_LogSetAsync_REAL
+#define SDL_LogFlush SDL_LogFlush_REAL
+#define SDL_LogGetDroppedCount SDL_LogGetDroppedCount_REAL
+#define SDL_CreateBufferedRW SDL_CreateBufferedRW_REAL
+#define SDL_RWFromFileMapped SDL_RWFromFileMapped_REAL
+#define SDL_RWGetPointer SDL_RWGetPointer_REAL
+#define SDL_ReadAsync SDL_ReadAsync_REAL
+#define SDL_ReadFileAsync SDL_ReadFileAsync_REAL
+#define SDL_WaitAsyncIO SDL_WaitAsyncIO_REAL
+#define SDL_OpenPack SDL_OpenPack_REAL
+#define SDL_OpenPackRW SDL_OpenPackRW_REAL
+#define SDL_RWFromPack SDL_RWFromPack_REAL
+#define SDL_ClosePack SDL_ClosePack_REAL
+#define SDL_RWFromCompressed SDL_RWFromCompressed_REAL
+#define SDL_CompressRW SDL_CompressRW_REAL
+#define SDL_ReadLE16Array SDL_ReadLE16Array_REAL
+#define SDL_ReadBE16Array SDL_ReadBE16Array_REAL
+#define SDL_ReadLE32Array SDL_ReadLE32Array_REAL
+#define SDL_ReadBE32Array SDL_ReadBE32Array_REAL
+#define SDL_ReadLE64Array SDL_ReadLE64Array_REAL
+#define SDL_ReadBE64Array SDL_ReadBE64Array_REAL
+#define SDL_WriteLE16Array SDL_WriteLE16Array_REAL
+#define SDL_WriteBE16Array SDL_WriteBE16Array_REAL
+#define SDL_WriteLE32Array SDL_WriteLE32Array_REAL
+#define SDL_WriteBE32Array SDL_WriteBE32Array_REAL
+#define SDL_WriteLE64Array SDL_WriteLE64Array_REAL
+#define SDL_WriteBE64Array SDL_WriteBE64Array_REAL
+#define SDL_LoadBMPFormat_RW SDL_LoadBMPFormat_RW_REAL
+#define SDL_CreatePixelConverter SDL_CreatePixelConverter_REAL
+#define SDL_RunPixelConverter SDL_RunPixelConverter_REAL
+#define SDL_FreePixelConverter SDL_FreePixelConverter_REAL
+#define SDL_RunPixelConverterRect SDL_RunPixelConverterRect_REAL
+#define SDL_CreateAtomicStack SDL_CreateAtomicStack_REAL
+#define SDL_DestroyAtomicStack SDL_DestroyAtomicStack_REAL
@@ -770,3 +770,60 @@ SDL_DYNAPI_PROC(SDL_TouchDeviceType,SDL_GetTouchDeviceType,(SDL_TouchID a),(a),r
 #ifdef __IPHONEOS__
 SDL_DYNAPI_PROC(int,SDL_UIKitRunApp,(int a, char *b, SDL_main_func c),(a,b,c),return)
 #endif
+SDL_DYNAPI_PROC(int,SDL_GetJobWorkerCount,(void),(),return)
+SDL_DYNAPI_PROC(SDL_JobGroup*,SDL_CreateJobGroup,(void),(),return)
+SDL_DYNAPI_PROC(int,SDL_SubmitJob,(SDL_JobGroup *a, SDL_JobFunction b, void *c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_WaitJobGroup,(SDL_JobGroup *a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyJobGroup,(SDL_JobGroup *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_ParallelFor,(int a, int b, int c, SDL_ParallelForFunction d, void *e),(a,b,c,d,e),return)
+SDL_DYNAPI_PROC(SDL_rwlock*,SDL_CreateRWLock,(void),(),return)
+SDL_DYNAPI_PROC(int,SDL_LockRWLockForReading,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_LockRWLockForWriting,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_TryLockRWLockForReading,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_TryLockRWLockForWriting,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_UnlockRWLock,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyRWLock,(SDL_rwlock *a),(a),)
+SDL_DYNAPI_PROC(SDL_AtomicQueue*,SDL_CreateAtomicQueue,(Uint32 a),(a),return)
+SDL_DYNAPI_PROC(SDL_bool,SDL_AtomicQueuePush,(SDL_AtomicQueue *a, void *b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_bool,SDL_AtomicQueuePop,(SDL_AtomicQueue *a, void **b),(a,b),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyAtomicQueue,(SDL_AtomicQueue *a),(a),)
+SDL_DYNAPI_PROC(void,SDL_AtomicStackPush,(SDL_AtomicStack *a, SDL_AtomicStackNode *b),(a,b),)
+SDL_DYNAPI_PROC(SDL_AtomicStackNode*,SDL_AtomicStackPop,(SDL_AtomicStack *a),(a),return)
+SDL_DYNAPI_PROC(SDL_AtomicStackNode*,SDL_AtomicStackPopAll,(SDL_AtomicStack *a),(a),return)
+SDL_DYNAPI_PROC(const char*,SDL_GetMemoryTagName,(SDL_MemoryTag a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_GetMemoryStats,(SDL_MemoryTag a, SDL_MemoryStats *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_DumpMemoryStats,(SDL_RWops *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_LogSetAsync,(SDL_bool a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_LogFlush,(void),(),)
+SDL_DYNAPI_PROC(int,SDL_LogGetDroppedCount,(void),(),return)
+SDL_DYNAPI_PROC(SDL_RWops*,SDL_CreateBufferedRW,(SDL_RWops *a, size_t b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(SDL_RWops*,SDL_RWFromFileMapped,(const char *a),(a),return)
+SDL_DYNAPI_PROC(const void*,SDL_RWGetPointer,(SDL_RWops *a, size_t *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_ReadAsync,(SDL_RWops *a, Sint64 b, void *c, size_t d, SDL_AsyncIOCallback e, void *f),(a,b,c,d,e,f),return)
+SDL_DYNAPI_PROC(int,SDL_ReadFileAsync,(const char *a, Sint64 b, void *c, size_t d, SDL_AsyncIOCallback e, void *f),(a,b,c,d,e,f),return)
+SDL_DYNAPI_PROC(void,SDL_WaitAsyncIO,(void),(),)
+SDL_DYNAPI_PROC(SDL_Pack*,SDL_OpenPack,(const char *a),(a),return)
+SDL_DYNAPI_PROC(SDL_Pack*,SDL_OpenPackRW,(SDL_RWops *a, int b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_RWops*,SDL_RWFromPack,(SDL_Pack *a, const char *b),(a,b),return)
+SDL_DYNAPI_PROC(void,SDL_ClosePack,(SDL_Pack *a),(a),)
+SDL_DYNAPI_PROC(SDL_RWops*,SDL_RWFromCompressed,(SDL_RWops *a, int b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_CompressRW,(SDL_RWops *a, SDL_RWops *b, size_t c),(a,b,c),return)
+SDL_DYNAPI_PROC(size_t,SDL_ReadLE16Array,(SDL_RWops *a, Uint16 *b, size_t c),(a,b,c),return)
+SDL_DYNAPI_PROC(size_t,SDL_ReadBE16Array,(SDL_RWops *a, Uint16 *b, size_t c),(a,b,c),return)
+SDL_DYNAPI_PROC(size_t,SDL_ReadLE32Array,(SDL_RWops *a, Uint32 *b, size_t c),(a,b,c),return)
+SDL_DYNAPI_PROC(size_t,SDL_ReadBE32Array,(SDL_RWops *a, Uint32 *b, size_t c),(a,b,c),return)
+SDL_DYNAPI_PROC(size_t,SDL_ReadLE64Array,(SDL_RWops *a, Uint64 *b, size_t c),(a,b,c),return)
+SDL_DYNAPI_PROC(size_t,SDL_ReadBE64Array,(SDL_RWops *a, Uint64 *b, size_t c),(a,b,c),return)
+SDL_DYNAPI_PROC(size_t,SDL_WriteLE16Array,(SDL_RWops *a, const Uint16 *b, size_t c),(a,b,c),return)
+SDL_DYNAPI_PROC(size_t,SDL_WriteBE16Array,(SDL_RWops *a, const Uint16 *b, size_t c),(a,b,c),return)
+SDL_DYNAPI_PROC(size_t,SDL_WriteLE32Array,(SDL_RWops *a, const Uint32 *b, size_t c),(a,b,c),return)
+SDL_DYNAPI_PROC(size_t,SDL_WriteBE32Array,(SDL_RWops *a, const Uint32 *b, size_t c),(a,b,c),return)
+SDL_DYNAPI_PROC(size_t,SDL_WriteLE64Array,(SDL_RWops *a, const Uint64 *b, size_t c),(a,b,c),return)
+SDL_DYNAPI_PROC(size_t,SDL_WriteBE64Array,(SDL_RWops *a, const Uint64 *b, size_t c),(a,b,c),return)
+SDL_DYNAPI_PROC(SDL_Surface*,SDL_LoadBMPFormat_RW,(SDL_RWops *a, int b, Uint32 c),(a,b,c),return)
+SDL_DYNAPI_PROC(SDL_PixelConverter*,SDL_CreatePixelConverter,(Uint32 a, Uint32 b, int c, int d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(int,SDL_RunPixelConverter,(SDL_PixelConverter *a, const void *b, int c, void *d, int e),(a,b,c,d,e),return)
+SDL_DYNAPI_PROC(void,SDL_FreePixelConverter,(SDL_PixelConverter *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_RunPixelConverterRect,(SDL_PixelConverter *a, const SDL_Rect *b, const void *c, int d, void *e, int f),(a,b,c,d,e,f),return)
+SDL_DYNAPI_PROC(SDL_AtomicStack*,SDL_CreateAtomicStack,(void),(),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyAtomicStack,(SDL_AtomicStack *a),(a),)
@@ -143,6 +143,11 @@ SDL_LogEvent(const SDL_Event *event)
         SDL_EVENT_CASE(SDL_RENDER_TARGETS_RESET) break;
         SDL_EVENT_CASE(SDL_RENDER_DEVICE_RESET) break;
 
+        SDL_EVENT_CASE(SDL_ASYNCIOCOMPLETE)
+            SDL_snprintf(details, sizeof (details), " (timestamp=%u result=%d userdata=%p buffer=%p)",
+                (uint) event->user.timestamp, (int) event->user.code, event->user.data1, event->user.data2);
+            break;
+
         SDL_EVENT_CASE(SDL_WINDOWEVENT) {
             char name2[64];
             switch(event->window.event) {
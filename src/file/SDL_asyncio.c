@@ -0,0 +1,398 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+/* Asynchronous reads, serviced by a single I/O thread */
+
+#include "SDL_atomic.h"
+#include "SDL_events.h"
+#include "SDL_mutex.h"
+#include "SDL_thread.h"
+#include "../thread/SDL_systhread.h"
+#include "SDL_asyncio_c.h"
+
+/* How many reads in a row may be taken from one stream while reads of
+   other streams are waiting */
+#define SDL_ASYNCIO_MAX_STREAK  16
+
+typedef struct SDL_AsyncRead
+{
+    struct SDL_AsyncRead *next;
+    SDL_RWops *context;     /* NULL for reads of a file by name */
+    char *file;
+    Sint64 offset;
+    void *buffer;
+    size_t size;
+    SDL_AsyncIOCallback callback;
+    void *userdata;
+} SDL_AsyncRead;
+
+typedef struct
+{
+    SDL_SpinLock init_lock;
+    SDL_bool initialized;
+    SDL_mutex *lock;
+    SDL_sem *work;          /* posted once for each queued read */
+    SDL_sem *idle;          /* posted for each waiter when the queue drains */
+    SDL_Thread *thread;
+    SDL_threadID thread_id;
+    SDL_bool quit;
+
+    /* Queued reads in submission order, protected by lock */
+    SDL_AsyncRead *pending;
+    SDL_AsyncRead **tail;
+    int outstanding;        /* queued reads plus the one in progress */
+    int waiters;
+
+    /* Owned by the I/O thread */
+    SDL_RWops *head_context;    /* the stream of the last read */
+    char *head_file;            /* or the name of the file that is open */
+    SDL_RWops *file;
+    Sint64 head_position;       /* where the last read ended */
+    int streak;
+} SDL_AsyncIO;
+
+static SDL_AsyncIO asyncio;
+
+static SDL_bool
+SDL_AsyncReadAtHead(const SDL_AsyncRead *read)
+{
+    if (read->context) {
+        return (read->context == asyncio.head_context);
+    }
+    return (!asyncio.head_context && asyncio.head_file && SDL_strcmp(read->file, asyncio.head_file) == 0);
+}
+
+/* Choose the next read, called with the lock held.
+
+   Reads of the stream that was read last are served in order of offset,
+   sweeping forward from where the last read ended and then starting over
+   from the lowest offset, so a batch of reads submitted in any order
+   costs one pass through the file.  Once the stream runs out of reads,
+   or has had its turn for SDL_ASYNCIO_MAX_STREAK reads, the oldest read
+   is taken so no stream is starved.
+ */
+static SDL_AsyncRead **
+SDL_PickAsyncRead(void)
+{
+    SDL_AsyncRead **link;
+    SDL_AsyncRead **ahead = NULL;
+    SDL_AsyncRead **behind = NULL;
+
+    if (asyncio.streak < SDL_ASYNCIO_MAX_STREAK) {
+        for (link = &asyncio.pending; *link; link = &(*link)->next) {
+            const SDL_AsyncRead *read = *link;
+            if (!SDL_AsyncReadAtHead(read)) {
+                continue;
+            }
+            if (read->offset >= asyncio.head_position) {
+                if (!ahead || read->offset < (*ahead)->offset) {
+                    ahead = link;
+                }
+            } else {
+                if (!behind || read->offset < (*behind)->offset) {
+                    behind = link;
+                }
+            }
+        }
+    }
+
+    if (ahead) {
+        ++asyncio.streak;
+        return ahead;
+    }
+    if (behind) {
+        ++asyncio.streak;
+        return behind;
+    }
+    asyncio.streak = 0;
+    return &asyncio.pending;
+}
+
+static void
+SDL_CloseAsyncFile(void)
+{
+    if (asyncio.file) {
+        SDL_RWclose(asyncio.file);
+        asyncio.file = NULL;
+    }
+    SDL_free(asyncio.head_file);
+    asyncio.head_file = NULL;
+}
+
+static Sint64
+SDL_PerformAsyncRead(SDL_AsyncRead *read)
+{
+    SDL_RWops *context = read->context;
+    size_t total = 0;
+
+    if (context) {
+        asyncio.head_context = context;
+    } else {
+        if (asyncio.head_context || !asyncio.head_file || SDL_strcmp(read->file, asyncio.head_file) != 0) {
+            SDL_CloseAsyncFile();
+            asyncio.file = SDL_RWFromFile(read->file, "rb");
+            /* The file stays open for the reads of it that follow */
+            asyncio.head_file = read->file;
+            read->file = NULL;
+        }
+        asyncio.head_context = NULL;
+        context = asyncio.file;
+    }
+    asyncio.head_position = read->offset;
+
+    if (!context || SDL_RWseek(context, read->offset, RW_SEEK_SET) < 0) {
+        return -1;
+    }
+    while (total < read->size) {
+        size_t amount = SDL_RWread(context, (Uint8 *)read->buffer + total, 1, read->size - total);
+        if (amount == 0) {
+            break;
+        }
+        total += amount;
+    }
+    asyncio.head_position += total;
+    return (Sint64)total;
+}
+
+static void
+SDL_CompleteAsyncRead(SDL_AsyncRead *read, Sint64 result)
+{
+    if (read->callback) {
+        read->callback(read->userdata, read->buffer, result);
+    } else {
+        SDL_Event event;
+
+        SDL_zero(event);
+        event.type = SDL_ASYNCIOCOMPLETE;
+        event.user.code = (Sint32)result;
+        event.user.data1 = read->userdata;
+        event.user.data2 = read->buffer;
+        SDL_PushEvent(&event);
+    }
+    SDL_free(read->file);
+    SDL_free(read);
+}
+
+static int SDLCALL
+SDL_AsyncIOThread(void *data)
+{
+    for ( ; ; ) {
+        SDL_AsyncRead **link;
+        SDL_AsyncRead *read;
+        SDL_bool drained;
+        Sint64 result;
+
+        SDL_SemWait(asyncio.work);
+
+        SDL_LockMutex(asyncio.lock);
+        if (!asyncio.pending) {
+            SDL_bool quit = asyncio.quit;
+            SDL_UnlockMutex(asyncio.lock);
+            if (quit) {
+                break;
+            }
+            continue;
+        }
+        link = SDL_PickAsyncRead();
+        read = *link;
+        *link = read->next;
+        if (!*link) {
+            asyncio.tail = link;
+        }
+        SDL_UnlockMutex(asyncio.lock);
+
+        result = SDL_PerformAsyncRead(read);
+        SDL_CompleteAsyncRead(read, result);
+
+        SDL_LockMutex(asyncio.lock);
+        drained = (--asyncio.outstanding == 0);
+        if (drained) {
+            while (asyncio.waiters > 0) {
+                --asyncio.waiters;
+                SDL_SemPost(asyncio.idle);
+            }
+        }
+        SDL_UnlockMutex(asyncio.lock);
+
+        if (drained) {
+            /* Don't hold on to files nobody is reading */
+            SDL_CloseAsyncFile();
+            asyncio.head_context = NULL;
+            asyncio.streak = 0;
+        }
+    }
+
+    SDL_CloseAsyncFile();
+    return 0;
+}
+
+static int
+SDL_InitAsyncIO(void)
+{
+    int retval = 0;
+
+    SDL_AtomicLock(&asyncio.init_lock);
+    if (!asyncio.initialized) {
+        asyncio.lock = SDL_CreateMutex();
+        asyncio.work = SDL_CreateSemaphore(0);
+        asyncio.idle = SDL_CreateSemaphore(0);
+        asyncio.tail = &asyncio.pending;
+        asyncio.quit = SDL_FALSE;
+        if (asyncio.lock && asyncio.work && asyncio.idle) {
+            asyncio.thread = SDL_CreateThreadInternal(SDL_AsyncIOThread, "SDLAsyncIO", 0, NULL);
+        }
+        if (asyncio.thread) {
+            asyncio.thread_id = SDL_GetThreadID(asyncio.thread);
+            asyncio.initialized = SDL_TRUE;
+        } else {
+            if (asyncio.lock) {
+                SDL_DestroyMutex(asyncio.lock);
+                asyncio.lock = NULL;
+            }
+            if (asyncio.work) {
+                SDL_DestroySemaphore(asyncio.work);
+                asyncio.work = NULL;
+            }
+            if (asyncio.idle) {
+                SDL_DestroySemaphore(asyncio.idle);
+                asyncio.idle = NULL;
+            }
+            retval = -1;
+        }
+    }
+    SDL_AtomicUnlock(&asyncio.init_lock);
+
+    return retval;
+}
+
+static int
+SDL_QueueAsyncRead(SDL_RWops *context, const char *file, Sint64 offset,
+                   void *buffer, size_t size,
+                   SDL_AsyncIOCallback callback, void *userdata)
+{
+    SDL_AsyncRead *read;
+
+    if (offset < 0) {
+        return SDL_InvalidParamError("offset");
+    }
+    if (!buffer && size > 0) {
+        return SDL_InvalidParamError("buffer");
+    }
+    if (SDL_InitAsyncIO() < 0) {
+        return -1;
+    }
+
+    read = (SDL_AsyncRead *)SDL_calloc(1, sizeof(*read));
+    if (!read) {
+        return SDL_OutOfMemory();
+    }
+    if (file) {
+        read->file = SDL_strdup(file);
+        if (!read->file) {
+            SDL_free(read);
+            return SDL_OutOfMemory();
+        }
+    }
+    read->context = context;
+    read->offset = offset;
+    read->buffer = buffer;
+    read->size = size;
+    read->callback = callback;
+    read->userdata = userdata;
+
+    SDL_LockMutex(asyncio.lock);
+    *asyncio.tail = read;
+    asyncio.tail = &read->next;
+    ++asyncio.outstanding;
+    SDL_UnlockMutex(asyncio.lock);
+
+    SDL_SemPost(asyncio.work);
+    return 0;
+}
+
+int
+SDL_ReadAsync(SDL_RWops *context, Sint64 offset, void *buffer, size_t size,
+              SDL_AsyncIOCallback callback, void *userdata)
+{
+    if (!context) {
+        return SDL_InvalidParamError("context");
+    }
+    return SDL_QueueAsyncRead(context, NULL, offset, buffer, size, callback, userdata);
+}
+
+int
+SDL_ReadFileAsync(const char *file, Sint64 offset, void *buffer, size_t size,
+                  SDL_AsyncIOCallback callback, void *userdata)
+{
+    if (!file || !*file) {
+        return SDL_InvalidParamError("file");
+    }
+    return SDL_QueueAsyncRead(NULL, file, offset, buffer, size, callback, userdata);
+}
+
+void
+SDL_WaitAsyncIO(void)
+{
+    SDL_bool wait = SDL_FALSE;
+
+    if (!asyncio.initialized) {
+        return;
+    }
+    /* A callback waiting for itself to finish would never return */
+    if (SDL_ThreadID() == asyncio.thread_id) {
+        return;
+    }
+
+    SDL_LockMutex(asyncio.lock);
+    if (asyncio.outstanding > 0) {
+        ++asyncio.waiters;
+        wait = SDL_TRUE;
+    }
+    SDL_UnlockMutex(asyncio.lock);
+
+    if (wait) {
+        SDL_SemWait(asyncio.idle);
+    }
+}
+
+void
+SDL_AsyncIOQuit(void)
+{
+    if (!asyncio.initialized) {
+        return;
+    }
+
+    SDL_WaitAsyncIO();
+
+    SDL_LockMutex(asyncio.lock);
+    asyncio.quit = SDL_TRUE;
+    SDL_UnlockMutex(asyncio.lock);
+    SDL_SemPost(asyncio.work);
+    SDL_WaitThread(asyncio.thread, NULL);
+
+    SDL_DestroyMutex(asyncio.lock);
+    SDL_DestroySemaphore(asyncio.work);
+    SDL_DestroySemaphore(asyncio.idle);
+    SDL_zero(asyncio);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,630 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+/* Block compressed streams
+
+   A compressed stream is laid out as follows, with all values
+   little-endian:
+
+     header      "SDLZ", version, block size (32-bit each) and the
+                 uncompressed size (64-bit)
+     blocks      the compressed size of each block (32-bit), with the top
+                 bit set if the block is stored uncompressed
+     data        the blocks, one after another
+
+   Every block but the last holds block size bytes once decompressed.
+
+   Blocks are coded as a series of sequences in the style of LZ4.  Each
+   sequence starts with a token byte, holding the number of literal bytes
+   that follow in its high nibble and the length of the match after them,
+   minus 4, in its low nibble.  A nibble of 15 is followed by bytes that
+   are added to it, up to and including the first one that isn't 255.
+   The literals come next, then the offset of the match back into the
+   output as 16 bits and the rest of the match length.  The last sequence
+   of a block has literals only.
+ */
+
+#include "SDL_endian.h"
+#include "SDL_rwops.h"
+
+#define SDL_COMPRESSED_MAGIC        0x5A4C4453  /* "SDLZ" */
+#define SDL_COMPRESSED_VERSION      1
+#define SDL_COMPRESSED_HEADER_SIZE  24
+#define SDL_COMPRESSED_STORED       0x80000000u
+#define SDL_COMPRESSED_MIN_BLOCK    256
+#define SDL_COMPRESSED_MAX_BLOCK    (4 * 1024 * 1024)
+
+#ifndef SIZE_MAX
+#define SIZE_MAX ((size_t)-1)
+#endif
+
+#define SDL_LZ_MIN_MATCH    4
+#define SDL_LZ_MAX_OFFSET   65535
+#define SDL_LZ_HASH_BITS    12
+
+typedef struct SDL_RWDecompressor
+{
+    SDL_RWops *src;
+    int freesrc;
+    Sint64 size;
+    Sint64 pos;
+    Sint64 src_pos;         /* where src is positioned, or -1 if unknown */
+    Uint32 block_size;
+    Uint32 num_blocks;
+    Uint32 *sizes;          /* compressed size of each block */
+    Sint64 *offsets;        /* where each block starts in src */
+    Uint32 cached;          /* the block held in block, or num_blocks */
+    Uint8 *block;
+    Uint8 *packed;
+} SDL_RWDecompressor;
+
+static Uint32
+SDL_LZRead32(const Uint8 *data)
+{
+    Uint32 value;
+    SDL_memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static void
+SDL_LZWriteLength(Uint8 **op, size_t length)
+{
+    Uint8 *out = *op;
+    while (length >= 255) {
+        *out++ = 255;
+        length -= 255;
+    }
+    *out++ = (Uint8)length;
+    *op = out;
+}
+
+/* Compresses a block, returning the compressed size, or 0 if it doesn't
+   fit in capacity bytes */
+static size_t
+SDL_LZCompressBlock(const Uint8 *src, size_t size, Uint8 *dst, size_t capacity, Uint32 *table)
+{
+    const Uint8 *ip = src;
+    const Uint8 *anchor = src;
+    const Uint8 *iend = src + size;
+    Uint8 *op = dst;
+    Uint8 *oend = dst + capacity;
+    size_t literals;
+
+    SDL_memset(table, 0xFF, sizeof(Uint32) << SDL_LZ_HASH_BITS);
+
+    /* Leave the last bytes as literals so the match search can read four
+       bytes at a time without running off the end */
+    if (size > 12) {
+        const Uint8 *mflimit = iend - 12;
+        const Uint8 *matchlimit = iend - 5;
+
+        while (ip < mflimit) {
+            const Uint32 sequence = SDL_LZRead32(ip);
+            const Uint32 hash = (sequence * 2654435761u) >> (32 - SDL_LZ_HASH_BITS);
+            const Uint32 candidate = table[hash];
+            const Uint32 position = (Uint32)(ip - src);
+            const Uint8 *ref;
+            size_t length, offset;
+            Uint8 *token;
+
+            table[hash] = position;
+            if (candidate == 0xFFFFFFFF || position - candidate > SDL_LZ_MAX_OFFSET ||
+                SDL_LZRead32(src + candidate) != sequence) {
+                /* Skip faster through data that doesn't compress */
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            ref = src + candidate;
+            length = SDL_LZ_MIN_MATCH;
+            while (ip + length < matchlimit && ref[length] == ip[length]) {
+                ++length;
+            }
+            offset = (size_t)(ip - ref);
+            literals = (size_t)(ip - anchor);
+
+            if ((size_t)(oend - op) < 1 + literals / 255 + 1 + literals + 2 + length / 255 + 1) {
+                return 0;
+            }
+            token = op++;
+            if (literals >= 15) {
+                *token = 15 << 4;
+                SDL_LZWriteLength(&op, literals - 15);
+            } else {
+                *token = (Uint8)(literals << 4);
+            }
+            SDL_memcpy(op, anchor, literals);
+            op += literals;
+            *op++ = (Uint8)offset;
+            *op++ = (Uint8)(offset >> 8);
+            if (length - SDL_LZ_MIN_MATCH >= 15) {
+                *token |= 15;
+                SDL_LZWriteLength(&op, length - SDL_LZ_MIN_MATCH - 15);
+            } else {
+                *token |= (Uint8)(length - SDL_LZ_MIN_MATCH);
+            }
+
+            ip += length;
+            anchor = ip;
+        }
+    }
+
+    literals = (size_t)(iend - anchor);
+    if ((size_t)(oend - op) < 1 + literals / 255 + 1 + literals) {
+        return 0;
+    }
+    if (literals >= 15) {
+        *op++ = 15 << 4;
+        SDL_LZWriteLength(&op, literals - 15);
+    } else {
+        *op++ = (Uint8)(literals << 4);
+    }
+    SDL_memcpy(op, anchor, literals);
+    op += literals;
+
+    return (size_t)(op - dst);
+}
+
+/* Decompresses a block, returning the decompressed size, or -1 if the
+   data is corrupt */
+static Sint64
+SDL_LZDecompressBlock(const Uint8 *src, size_t size, Uint8 *dst, size_t capacity)
+{
+    const Uint8 *ip = src;
+    const Uint8 *iend = src + size;
+    Uint8 *op = dst;
+    Uint8 *oend = dst + capacity;
+
+    while (ip < iend) {
+        const Uint8 token = *ip++;
+        size_t literals = token >> 4;
+        size_t length, offset;
+        const Uint8 *ref;
+
+        if (literals == 15) {
+            Uint8 b;
+            do {
+                if (ip >= iend) {
+                    return -1;
+                }
+                b = *ip++;
+                literals += b;
+            } while (b == 255);
+        }
+        if (literals > (size_t)(iend - ip) || literals > (size_t)(oend - op)) {
+            return -1;
+        }
+        SDL_memcpy(op, ip, literals);
+        ip += literals;
+        op += literals;
+
+        if (ip == iend) {
+            break;
+        }
+
+        if (iend - ip < 2) {
+            return -1;
+        }
+        offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - dst)) {
+            return -1;
+        }
+
+        length = token & 15;
+        if (length == 15) {
+            Uint8 b;
+            do {
+                if (ip >= iend) {
+                    return -1;
+                }
+                b = *ip++;
+                length += b;
+            } while (b == 255);
+        }
+        length += SDL_LZ_MIN_MATCH;
+        if (length > (size_t)(oend - op)) {
+            return -1;
+        }
+
+        ref = op - offset;
+        if (offset >= length) {
+            SDL_memcpy(op, ref, length);
+            op += length;
+        } else {
+            /* The match overlaps the bytes it produces */
+            while (length--) {
+                *op++ = *ref++;
+            }
+        }
+    }
+    return (Sint64)(op - dst);
+}
+
+/* Decompresses block index into dst, which holds a whole block */
+static int
+SDL_LoadCompressedBlock(SDL_RWDecompressor *rwz, Uint32 index, Uint8 *dst)
+{
+    const Uint32 packed_size = rwz->sizes[index] & ~SDL_COMPRESSED_STORED;
+    const SDL_bool stored = (rwz->sizes[index] & SDL_COMPRESSED_STORED) ? SDL_TRUE : SDL_FALSE;
+    const Sint64 start = (Sint64)index * rwz->block_size;
+    const size_t expected = (size_t)SDL_min(rwz->size - start, (Sint64)rwz->block_size);
+    Uint8 *packed = stored ? dst : rwz->packed;
+
+    if (stored && packed_size != expected) {
+        return SDL_SetError("Compressed stream is corrupt");
+    }
+    if (rwz->src_pos != rwz->offsets[index] &&
+        SDL_RWseek(rwz->src, rwz->offsets[index], RW_SEEK_SET) != rwz->offsets[index]) {
+        rwz->src_pos = -1;
+        return -1;
+    }
+    if (SDL_RWread(rwz->src, packed, 1, packed_size) != packed_size) {
+        rwz->src_pos = -1;
+        return SDL_SetError("Compressed stream is truncated");
+    }
+    rwz->src_pos = rwz->offsets[index] + packed_size;
+
+    if (stored) {
+        return 0;
+    }
+    if (SDL_LZDecompressBlock(packed, packed_size, dst, expected) != (Sint64)expected) {
+        return SDL_SetError("Compressed stream is corrupt");
+    }
+    return 0;
+}
+
+static Sint64 SDLCALL
+compressed_size(SDL_RWops * context)
+{
+    SDL_RWDecompressor *rwz = (SDL_RWDecompressor *) context->hidden.unknown.data1;
+    return rwz->size;
+}
+
+static Sint64 SDLCALL
+compressed_seek(SDL_RWops * context, Sint64 offset, int whence)
+{
+    SDL_RWDecompressor *rwz = (SDL_RWDecompressor *) context->hidden.unknown.data1;
+    Sint64 newpos;
+
+    switch (whence) {
+    case RW_SEEK_SET:
+        newpos = offset;
+        break;
+    case RW_SEEK_CUR:
+        newpos = rwz->pos + offset;
+        break;
+    case RW_SEEK_END:
+        newpos = rwz->size + offset;
+        break;
+    default:
+        return SDL_SetError("Unknown value for 'whence'");
+    }
+    if (newpos < 0) {
+        newpos = 0;
+    }
+    if (newpos > rwz->size) {
+        newpos = rwz->size;
+    }
+    /* Blocks are only decompressed once they're read from */
+    rwz->pos = newpos;
+    return newpos;
+}
+
+static size_t SDLCALL
+compressed_read(SDL_RWops * context, void *ptr, size_t size, size_t maxnum)
+{
+    SDL_RWDecompressor *rwz = (SDL_RWDecompressor *) context->hidden.unknown.data1;
+    Uint8 *dst = (Uint8 *) ptr;
+    size_t total, done = 0;
+
+    if (size == 0 || maxnum == 0) {
+        return 0;
+    }
+    total = size * maxnum;
+    if ((Sint64)total > rwz->size - rwz->pos || total / size != maxnum) {
+        total = (size_t)(rwz->size - rwz->pos);
+    }
+    total -= total % size;
+
+    while (done < total) {
+        const Uint32 index = (Uint32)(rwz->pos / rwz->block_size);
+        const size_t offset = (size_t)(rwz->pos % rwz->block_size);
+        const size_t block_end = (size_t)SDL_min(rwz->size - (Sint64)index * rwz->block_size, (Sint64)rwz->block_size);
+        size_t amount = SDL_min(total - done, block_end - offset);
+
+        if (index != rwz->cached && offset == 0 && amount == rwz->block_size) {
+            /* A whole block is wanted, decompress it straight to the caller */
+            if (SDL_LoadCompressedBlock(rwz, index, dst + done) < 0) {
+                break;
+            }
+        } else {
+            if (index != rwz->cached) {
+                rwz->cached = rwz->num_blocks;
+                if (SDL_LoadCompressedBlock(rwz, index, rwz->block) < 0) {
+                    break;
+                }
+                rwz->cached = index;
+            }
+            SDL_memcpy(dst + done, rwz->block + offset, amount);
+        }
+        done += amount;
+        rwz->pos += amount;
+    }
+
+    /* Only whole objects are reported, leave the position after them */
+    rwz->pos -= done % size;
+    return done / size;
+}
+
+static size_t SDLCALL
+compressed_write(SDL_RWops * context, const void *ptr, size_t size, size_t num)
+{
+    SDL_SetError("Can't write to a compressed stream, use SDL_CompressRW()");
+    return 0;
+}
+
+static int SDLCALL
+compressed_close(SDL_RWops * context)
+{
+    int retval = 0;
+
+    if (context) {
+        SDL_RWDecompressor *rwz = (SDL_RWDecompressor *) context->hidden.unknown.data1;
+        if (rwz->freesrc) {
+            retval = SDL_RWclose(rwz->src);
+        }
+        SDL_free(rwz->sizes);
+        SDL_free(rwz->offsets);
+        SDL_free(rwz->block);
+        SDL_free(rwz->packed);
+        SDL_free(rwz);
+        SDL_FreeRW(context);
+    }
+    return retval;
+}
+
+SDL_RWops *
+SDL_RWFromCompressed(SDL_RWops * src, int freesrc)
+{
+    SDL_RWDecompressor *rwz = NULL;
+    SDL_RWops *rwops = NULL;
+    Uint8 header[SDL_COMPRESSED_HEADER_SIZE];
+    Sint64 num_blocks, offset, src_size;
+    Uint32 i;
+
+    if (!src) {
+        SDL_InvalidParamError("src");
+        return NULL;
+    }
+
+    offset = SDL_RWtell(src);
+    if (offset < 0 || SDL_RWread(src, header, sizeof(header), 1) != 1) {
+        SDL_SetError("Couldn't read compressed stream header");
+        goto error;
+    }
+    if (SDL_SwapLE32(SDL_LZRead32(&header[0])) != SDL_COMPRESSED_MAGIC) {
+        SDL_SetError("Not a compressed stream");
+        goto error;
+    }
+    if (SDL_SwapLE32(SDL_LZRead32(&header[4])) != SDL_COMPRESSED_VERSION) {
+        SDL_SetError("Unsupported compressed stream version");
+        goto error;
+    }
+
+    rwz = (SDL_RWDecompressor *) SDL_calloc(1, sizeof(*rwz));
+    if (!rwz) {
+        SDL_OutOfMemory();
+        goto error;
+    }
+    rwz->block_size = SDL_SwapLE32(SDL_LZRead32(&header[8]));
+    rwz->size = (Sint64)(SDL_SwapLE32(SDL_LZRead32(&header[12])) |
+                         ((Uint64)SDL_SwapLE32(SDL_LZRead32(&header[16])) << 32));
+    if (rwz->block_size < SDL_COMPRESSED_MIN_BLOCK || rwz->block_size > SDL_COMPRESSED_MAX_BLOCK ||
+        rwz->size < 0 || rwz->size > SDL_MAX_SINT64 - rwz->block_size) {
+        SDL_SetError("Corrupt compressed stream header");
+        goto error;
+    }
+
+    /* The header is untrusted: the block table has to fit in memory, and
+       in the source, which holds a 32-bit size for every block */
+    num_blocks = (rwz->size + rwz->block_size - 1) / rwz->block_size;
+    if (num_blocks >= SDL_MAX_SINT32 ||
+        (Uint64)num_blocks + 1 > SIZE_MAX / sizeof(Sint64)) {
+        SDL_SetError("Corrupt compressed stream header");
+        goto error;
+    }
+    src_size = SDL_RWsize(src);
+    if (src_size >= 0 &&
+        num_blocks * (Sint64)sizeof(Uint32) > src_size - offset - SDL_COMPRESSED_HEADER_SIZE) {
+        SDL_SetError("Compressed stream is truncated");
+        goto error;
+    }
+    rwz->num_blocks = (Uint32)num_blocks;
+    rwz->cached = rwz->num_blocks;
+
+    rwz->sizes = (Uint32 *) SDL_malloc(((size_t)rwz->num_blocks + 1) * sizeof(Uint32));
+    rwz->offsets = (Sint64 *) SDL_malloc(((size_t)rwz->num_blocks + 1) * sizeof(Sint64));
+    rwz->block = (Uint8 *) SDL_malloc(rwz->block_size);
+    rwz->packed = (Uint8 *) SDL_malloc(rwz->block_size);
+    if (!rwz->sizes || !rwz->offsets || !rwz->block || !rwz->packed) {
+        SDL_OutOfMemory();
+        goto error;
+    }
+    if (rwz->num_blocks > 0 &&
+        SDL_RWread(src, rwz->sizes, sizeof(Uint32), rwz->num_blocks) != rwz->num_blocks) {
+        SDL_SetError("Couldn't read compressed stream block table");
+        goto error;
+    }
+
+    offset += SDL_COMPRESSED_HEADER_SIZE + (Sint64)rwz->num_blocks * sizeof(Uint32);
+    for (i = 0; i < rwz->num_blocks; ++i) {
+        rwz->sizes[i] = SDL_SwapLE32(rwz->sizes[i]);
+        if ((rwz->sizes[i] & ~SDL_COMPRESSED_STORED) > rwz->block_size) {
+            SDL_SetError("Corrupt compressed stream block table");
+            goto error;
+        }
+        rwz->offsets[i] = offset;
+        offset += rwz->sizes[i] & ~SDL_COMPRESSED_STORED;
+    }
+    rwz->offsets[rwz->num_blocks] = offset;
+    rwz->src_pos = rwz->num_blocks ? rwz->offsets[0] : -1;
+
+    rwops = SDL_AllocRW();
+    if (!rwops) {
+        goto error;
+    }
+    rwz->src = src;
+    rwz->freesrc = freesrc;
+    rwops->size = compressed_size;
+    rwops->seek = compressed_seek;
+    rwops->read = compressed_read;
+    rwops->write = compressed_write;
+    rwops->close = compressed_close;
+    rwops->hidden.unknown.data1 = rwz;
+    rwops->type = SDL_RWOPS_COMPRESSED;
+    return rwops;
+
+error:
+    if (rwz) {
+        SDL_free(rwz->sizes);
+        SDL_free(rwz->offsets);
+        SDL_free(rwz->block);
+        SDL_free(rwz->packed);
+        SDL_free(rwz);
+    }
+    if (freesrc) {
+        SDL_RWclose(src);
+    }
+    return NULL;
+}
+
+int
+SDL_CompressRW(SDL_RWops * src, SDL_RWops * dst, size_t block_size)
+{
+    Uint8 header[SDL_COMPRESSED_HEADER_SIZE];
+    Uint32 *sizes = NULL;
+    Uint32 *table = NULL;
+    Uint8 *block = NULL;
+    Uint8 *packed = NULL;
+    Sint64 size, start, num_blocks, header_pos;
+    Uint32 i, value;
+    int retval = -1;
+
+    if (!src) {
+        return SDL_InvalidParamError("src");
+    }
+    if (!dst) {
+        return SDL_InvalidParamError("dst");
+    }
+    if (block_size == 0) {
+        block_size = SDL_RWOPS_DEFAULT_COMPRESSED_BLOCK_SIZE;
+    }
+    if (block_size < SDL_COMPRESSED_MIN_BLOCK || block_size > SDL_COMPRESSED_MAX_BLOCK) {
+        return SDL_InvalidParamError("block_size");
+    }
+
+    start = SDL_RWtell(src);
+    size = SDL_RWsize(src);
+    if (start < 0 || size < 0) {
+        return SDL_SetError("Can't compress a stream of unknown size");
+    }
+    size -= start;
+    header_pos = SDL_RWtell(dst);
+    if (header_pos < 0) {
+        return SDL_SetError("Can't compress to a stream that can't seek");
+    }
+    num_blocks = (size + block_size - 1) / block_size;
+    if (num_blocks >= SDL_MAX_SINT32) {
+        return SDL_SetError("Stream is too large to compress with this block size");
+    }
+
+    sizes = (Uint32 *) SDL_calloc((size_t)num_blocks + 1, sizeof(Uint32));
+    table = (Uint32 *) SDL_malloc(sizeof(Uint32) << SDL_LZ_HASH_BITS);
+    block = (Uint8 *) SDL_malloc(block_size);
+    packed = (Uint8 *) SDL_malloc(block_size);
+    if (!sizes || !table || !block || !packed) {
+        SDL_OutOfMemory();
+        goto done;
+    }
+
+    value = SDL_SwapLE32(SDL_COMPRESSED_MAGIC);
+    SDL_memcpy(&header[0], &value, 4);
+    value = SDL_SwapLE32(SDL_COMPRESSED_VERSION);
+    SDL_memcpy(&header[4], &value, 4);
+    value = SDL_SwapLE32((Uint32)block_size);
+    SDL_memcpy(&header[8], &value, 4);
+    value = SDL_SwapLE32((Uint32)((Uint64)size & 0xFFFFFFFF));
+    SDL_memcpy(&header[12], &value, 4);
+    value = SDL_SwapLE32((Uint32)((Uint64)size >> 32));
+    SDL_memcpy(&header[16], &value, 4);
+    SDL_memset(&header[20], 0, 4);
+
+    /* The block table is filled in once the blocks have been written */
+    if (SDL_RWwrite(dst, header, sizeof(header), 1) != 1 ||
+        (num_blocks > 0 && SDL_RWwrite(dst, sizes, sizeof(Uint32), (size_t)num_blocks) != (size_t)num_blocks)) {
+        goto done;
+    }
+
+    for (i = 0; i < (Uint32)num_blocks; ++i) {
+        const size_t amount = (size_t)SDL_min(size - (Sint64)i * block_size, (Sint64)block_size);
+        size_t packed_size;
+
+        if (SDL_RWread(src, block, 1, amount) != amount) {
+            SDL_SetError("Couldn't read block %u to compress", (unsigned int)i);
+            goto done;
+        }
+        /* Keep the block as it is unless compressing saves something */
+        packed_size = SDL_LZCompressBlock(block, amount, packed, amount - 1, table);
+        if (packed_size == 0) {
+            if (SDL_RWwrite(dst, block, 1, amount) != amount) {
+                goto done;
+            }
+            sizes[i] = SDL_SwapLE32((Uint32)amount | SDL_COMPRESSED_STORED);
+        } else {
+            if (SDL_RWwrite(dst, packed, 1, packed_size) != packed_size) {
+                goto done;
+            }
+            sizes[i] = SDL_SwapLE32((Uint32)packed_size);
+        }
+    }
+
+    if (num_blocks > 0) {
+        const Sint64 end = SDL_RWtell(dst);
+        if (end < 0 ||
+            SDL_RWseek(dst, header_pos + SDL_COMPRESSED_HEADER_SIZE, RW_SEEK_SET) < 0 ||
+            SDL_RWwrite(dst, sizes, sizeof(Uint32), (size_t)num_blocks) != (size_t)num_blocks ||
+            SDL_RWseek(dst, end, RW_SEEK_SET) < 0) {
+            goto done;
+        }
+    }
+    retval = 0;
+
+done:
+    SDL_free(sizes);
+    SDL_free(table);
+    SDL_free(block);
+    SDL_free(packed);
+    return retval;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,392 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+/* Read-only streams over the entries of a pack file
+
+   A pack file is laid out as follows, with all values little-endian:
+
+     header      "SDLP", version, entry count, bucket count,
+                 name table size, alignment, two reserved words
+                 (eight 32-bit words)
+     buckets     bucket count + 1 32-bit entry indices
+     entries     24 bytes each: name hash, name offset, name length,
+                 data size (32-bit each) and data offset (64-bit)
+     names       the entry names, not terminated
+     data        each entry starting on an alignment boundary
+
+   The bucket count is a power of two.  Entries are sorted by bucket, the
+   bucket of an entry being the FNV-1a hash of its name masked by the
+   bucket count minus one, and bucket b holds the entries from index
+   buckets[b] up to buckets[b + 1].  The whole directory is read with one
+   call when the pack is opened and entries are looked up in place.
+ */
+
+#include "SDL_atomic.h"
+#include "SDL_endian.h"
+#include "SDL_mutex.h"
+#include "SDL_rwops.h"
+
+#define SDL_PACK_MAGIC          0x504C4453  /* "SDLP" */
+#define SDL_PACK_VERSION        1
+#define SDL_PACK_HEADER_SIZE    32
+#define SDL_PACK_ENTRY_SIZE     24
+
+/* Keep a corrupt header from asking for an absurd allocation */
+#define SDL_PACK_MAX_ENTRIES    (1 << 20)
+#define SDL_PACK_MAX_BUCKETS    (1 << 20)
+#define SDL_PACK_MAX_NAMES      (64 * 1024 * 1024)
+
+struct SDL_Pack
+{
+    SDL_RWops *src;
+    int freesrc;
+    SDL_atomic_t refcount;  /* one for the pack and one for each open entry */
+    SDL_mutex *lock;        /* serializes use of src */
+    Sint64 position;        /* where src is positioned, or -1 if unknown */
+    Sint64 size;
+    Uint32 num_entries;
+    Uint32 bucket_mask;
+    Uint32 names_size;
+    Uint8 *directory;
+    const Uint8 *entries;
+    const char *names;
+};
+
+typedef struct SDL_PackStream
+{
+    SDL_Pack *pack;
+    Sint64 base;
+    Sint64 size;
+    Sint64 pos;
+} SDL_PackStream;
+
+static Uint32
+SDL_PackRead32(const Uint8 *data)
+{
+    Uint32 value;
+    SDL_memcpy(&value, data, sizeof(value));
+    return SDL_SwapLE32(value);
+}
+
+static Uint64
+SDL_PackRead64(const Uint8 *data)
+{
+    Uint64 value;
+    SDL_memcpy(&value, data, sizeof(value));
+    return SDL_SwapLE64(value);
+}
+
+static Uint32
+SDL_PackHash(const char *name)
+{
+    Uint32 hash = 2166136261u;
+
+    while (*name) {
+        hash ^= (Uint8)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void
+SDL_ReleasePack(SDL_Pack *pack)
+{
+    if (SDL_AtomicDecRef(&pack->refcount)) {
+        if (pack->freesrc) {
+            SDL_RWclose(pack->src);
+        }
+        SDL_DestroyMutex(pack->lock);
+        SDL_free(pack->directory);
+        SDL_free(pack);
+    }
+}
+
+static Sint64 SDLCALL
+pack_size(SDL_RWops * context)
+{
+    SDL_PackStream *stream = (SDL_PackStream *) context->hidden.unknown.data1;
+    return stream->size;
+}
+
+static Sint64 SDLCALL
+pack_seek(SDL_RWops * context, Sint64 offset, int whence)
+{
+    SDL_PackStream *stream = (SDL_PackStream *) context->hidden.unknown.data1;
+    Sint64 newpos;
+
+    switch (whence) {
+    case RW_SEEK_SET:
+        newpos = offset;
+        break;
+    case RW_SEEK_CUR:
+        newpos = stream->pos + offset;
+        break;
+    case RW_SEEK_END:
+        newpos = stream->size + offset;
+        break;
+    default:
+        return SDL_SetError("Unknown value for 'whence'");
+    }
+    if (newpos < 0) {
+        newpos = 0;
+    }
+    if (newpos > stream->size) {
+        newpos = stream->size;
+    }
+    stream->pos = newpos;
+    return newpos;
+}
+
+static size_t SDLCALL
+pack_read(SDL_RWops * context, void *ptr, size_t size, size_t maxnum)
+{
+    SDL_PackStream *stream = (SDL_PackStream *) context->hidden.unknown.data1;
+    SDL_Pack *pack = stream->pack;
+    const Sint64 wanted = stream->base + stream->pos;
+    size_t total, amount;
+
+    if (size == 0 || maxnum == 0) {
+        return 0;
+    }
+    total = size * maxnum;
+    if ((Sint64)total > stream->size - stream->pos || total / size != maxnum) {
+        total = (size_t)(stream->size - stream->pos);
+    }
+    total -= total % size;
+    if (total == 0) {
+        return 0;
+    }
+
+    SDL_LockMutex(pack->lock);
+    /* Reading entries in the order they are stored needs no seeking */
+    if (pack->position != wanted && SDL_RWseek(pack->src, wanted, RW_SEEK_SET) != wanted) {
+        pack->position = -1;
+        SDL_UnlockMutex(pack->lock);
+        return 0;
+    }
+    amount = SDL_RWread(pack->src, ptr, 1, total);
+    pack->position = wanted + amount;
+    SDL_UnlockMutex(pack->lock);
+
+    stream->pos += amount;
+    return amount / size;
+}
+
+static size_t SDLCALL
+pack_write(SDL_RWops * context, const void *ptr, size_t size, size_t num)
+{
+    SDL_SetError("Can't write to a pack file entry");
+    return 0;
+}
+
+static int SDLCALL
+pack_close(SDL_RWops * context)
+{
+    if (context) {
+        SDL_PackStream *stream = (SDL_PackStream *) context->hidden.unknown.data1;
+        SDL_ReleasePack(stream->pack);
+        SDL_free(stream);
+        SDL_FreeRW(context);
+    }
+    return 0;
+}
+
+SDL_Pack *
+SDL_OpenPackRW(SDL_RWops * src, int freesrc)
+{
+    Uint8 header[SDL_PACK_HEADER_SIZE];
+    Uint32 num_buckets;
+    size_t buckets_size, entries_size, directory_size;
+    SDL_Pack *pack = NULL;
+
+    if (!src) {
+        SDL_InvalidParamError("src");
+        return NULL;
+    }
+
+    if (SDL_RWseek(src, 0, RW_SEEK_SET) != 0 ||
+        SDL_RWread(src, header, sizeof(header), 1) != 1) {
+        SDL_SetError("Couldn't read pack file header");
+        goto error;
+    }
+    if (SDL_PackRead32(&header[0]) != SDL_PACK_MAGIC) {
+        SDL_SetError("Not a pack file");
+        goto error;
+    }
+    if (SDL_PackRead32(&header[4]) != SDL_PACK_VERSION) {
+        SDL_SetError("Unsupported pack file version %u", (unsigned int)SDL_PackRead32(&header[4]));
+        goto error;
+    }
+
+    pack = (SDL_Pack *) SDL_calloc(1, sizeof(*pack));
+    if (!pack) {
+        SDL_OutOfMemory();
+        goto error;
+    }
+    pack->num_entries = SDL_PackRead32(&header[8]);
+    num_buckets = SDL_PackRead32(&header[12]);
+    pack->names_size = SDL_PackRead32(&header[16]);
+    if (pack->num_entries > SDL_PACK_MAX_ENTRIES ||
+        num_buckets == 0 || num_buckets > SDL_PACK_MAX_BUCKETS ||
+        (num_buckets & (num_buckets - 1)) != 0 ||
+        pack->names_size > SDL_PACK_MAX_NAMES) {
+        SDL_SetError("Corrupt pack file header");
+        goto error;
+    }
+    pack->bucket_mask = num_buckets - 1;
+
+    buckets_size = (num_buckets + 1) * sizeof(Uint32);
+    entries_size = pack->num_entries * SDL_PACK_ENTRY_SIZE;
+    directory_size = buckets_size + entries_size + pack->names_size;
+    pack->directory = (Uint8 *) SDL_malloc(directory_size);
+    if (!pack->directory) {
+        SDL_OutOfMemory();
+        goto error;
+    }
+    if (SDL_RWread(src, pack->directory, directory_size, 1) != 1) {
+        SDL_SetError("Couldn't read pack file directory");
+        goto error;
+    }
+    pack->entries = pack->directory + buckets_size;
+    pack->names = (const char *)pack->entries + entries_size;
+
+    pack->size = SDL_RWsize(src);
+    pack->lock = SDL_CreateMutex();
+    if (pack->size < 0 || !pack->lock) {
+        goto error;
+    }
+    pack->src = src;
+    pack->freesrc = freesrc;
+    pack->position = SDL_PACK_HEADER_SIZE + directory_size;
+    SDL_AtomicSet(&pack->refcount, 1);
+    return pack;
+
+error:
+    if (pack) {
+        SDL_DestroyMutex(pack->lock);
+        SDL_free(pack->directory);
+        SDL_free(pack);
+    }
+    if (freesrc) {
+        SDL_RWclose(src);
+    }
+    return NULL;
+}
+
+SDL_Pack *
+SDL_OpenPack(const char *file)
+{
+    SDL_RWops *src = SDL_RWFromFile(file, "rb");
+    if (!src) {
+        return NULL;
+    }
+    return SDL_OpenPackRW(src, 1);
+}
+
+SDL_RWops *
+SDL_RWFromPack(SDL_Pack * pack, const char *name)
+{
+    Uint32 hash, bucket, first, last, i;
+    size_t length;
+
+    if (!pack) {
+        SDL_InvalidParamError("pack");
+        return NULL;
+    }
+    if (!name) {
+        SDL_InvalidParamError("name");
+        return NULL;
+    }
+
+    hash = SDL_PackHash(name);
+    length = SDL_strlen(name);
+    bucket = hash & pack->bucket_mask;
+    first = SDL_PackRead32(pack->directory + bucket * sizeof(Uint32));
+    last = SDL_PackRead32(pack->directory + (bucket + 1) * sizeof(Uint32));
+    if (first > last || last > pack->num_entries) {
+        SDL_SetError("Corrupt pack file directory");
+        return NULL;
+    }
+
+    for (i = first; i < last; ++i) {
+        const Uint8 *entry = pack->entries + i * SDL_PACK_ENTRY_SIZE;
+        const Uint32 name_offset = SDL_PackRead32(&entry[4]);
+        const Uint32 name_length = SDL_PackRead32(&entry[8]);
+
+        if (SDL_PackRead32(&entry[0]) != hash || name_length != length) {
+            continue;
+        }
+        if (name_offset > pack->names_size || name_length > pack->names_size - name_offset) {
+            SDL_SetError("Corrupt pack file directory");
+            return NULL;
+        }
+        if (SDL_memcmp(pack->names + name_offset, name, length) == 0) {
+            const Sint64 size = SDL_PackRead32(&entry[12]);
+            const Uint64 offset = SDL_PackRead64(&entry[16]);
+            SDL_PackStream *stream;
+            SDL_RWops *rwops;
+
+            if (offset > (Uint64)pack->size || size > pack->size - (Sint64)offset) {
+                SDL_SetError("Pack file entry '%s' is truncated", name);
+                return NULL;
+            }
+
+            stream = (SDL_PackStream *) SDL_malloc(sizeof(*stream));
+            if (!stream) {
+                SDL_OutOfMemory();
+                return NULL;
+            }
+            rwops = SDL_AllocRW();
+            if (!rwops) {
+                SDL_free(stream);
+                return NULL;
+            }
+            stream->pack = pack;
+            stream->base = (Sint64)offset;
+            stream->size = size;
+            stream->pos = 0;
+            SDL_AtomicIncRef(&pack->refcount);
+
+            rwops->size = pack_size;
+            rwops->seek = pack_seek;
+            rwops->read = pack_read;
+            rwops->write = pack_write;
+            rwops->close = pack_close;
+            rwops->hidden.unknown.data1 = stream;
+            rwops->type = SDL_RWOPS_PACK;
+            return rwops;
+        }
+    }
+
+    SDL_SetError("Pack file has no entry '%s'", name);
+    return NULL;
+}
+
+void
+SDL_ClosePack(SDL_Pack * pack)
+{
+    if (pack) {
+        SDL_ReleasePack(pack);
+    }
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
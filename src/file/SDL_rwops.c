@@ -40,13 +40,27 @@
 #include <limits.h>
 #endif
 
+#if defined(HAVE_MPROTECT) && !defined(__WIN32__)
+#define SDL_RWOPS_MMAP  1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 /* This file provides a general interface for SDL to read and write
    data sources.  It can easily be extended to files, memory, etc.
 */
 
+#include "SDL_cpuinfo.h"
 #include "SDL_endian.h"
+#include "SDL_hints.h"
 #include "SDL_rwops.h"
 
+#ifdef __SSE2__
+#define HAVE_SSE2_INTRINSICS 1
+#endif
+
 #ifdef __APPLE__
 #include "cocoa/SDL_rwopsbundlesupport.h"
 #endif /* __APPLE__ */
@@ -504,6 +518,283 @@ mem_close(SDL_RWops * context)
     return 0;
 }
 
+#if SDL_RWOPS_MMAP || defined(__WIN32__)
+static int SDLCALL
+mapped_close(SDL_RWops * context)
+{
+    if (context) {
+#if SDL_RWOPS_MMAP
+        munmap(context->hidden.mem.base, (size_t)(context->hidden.mem.stop - context->hidden.mem.base));
+#else
+        UnmapViewOfFile(context->hidden.mem.base);
+#endif
+        SDL_FreeRW(context);
+    }
+    return 0;
+}
+#endif
+
+static int SDLCALL
+loaded_close(SDL_RWops * context)
+{
+    if (context) {
+        SDL_free(context->hidden.mem.base);
+        SDL_FreeRW(context);
+    }
+    return 0;
+}
+
+
+/* Functions to buffer reads and writes to another SDL_RWops */
+
+/* The buffer holds either data read ahead from the source or data waiting
+   to be written to it, never both.  When reading, buffer[0..fill) holds
+   the source data starting at offset base and the source is positioned
+   at base + fill.  When writing, buffer[0..pos) is pending and the source
+   is positioned at base.  Either way the stream position is base + pos.
+ */
+typedef struct SDL_RWBuffer
+{
+    SDL_RWops *src;
+    int freesrc;
+    SDL_bool writing;
+    Sint64 base;
+    size_t pos;
+    size_t fill;
+    size_t capacity;
+    Uint8 *buffer;
+} SDL_RWBuffer;
+
+static int
+buffered_flush(SDL_RWBuffer *rwbuf)
+{
+    if (rwbuf->writing) {
+        const size_t pending = rwbuf->pos;
+
+        rwbuf->writing = SDL_FALSE;
+        rwbuf->pos = 0;
+        if (pending > 0) {
+            if (SDL_RWwrite(rwbuf->src, rwbuf->buffer, 1, pending) != pending) {
+                return -1;
+            }
+            rwbuf->base += pending;
+        }
+    }
+    return 0;
+}
+
+static Sint64 SDLCALL
+buffered_size(SDL_RWops * context)
+{
+    SDL_RWBuffer *rwbuf = (SDL_RWBuffer *) context->hidden.unknown.data1;
+
+    if (buffered_flush(rwbuf) < 0) {
+        return -1;
+    }
+    return SDL_RWsize(rwbuf->src);
+}
+
+static Sint64 SDLCALL
+buffered_seek(SDL_RWops * context, Sint64 offset, int whence)
+{
+    SDL_RWBuffer *rwbuf = (SDL_RWBuffer *) context->hidden.unknown.data1;
+    Sint64 target;
+
+    switch (whence) {
+    case RW_SEEK_SET:
+        target = offset;
+        break;
+    case RW_SEEK_CUR:
+        target = rwbuf->base + rwbuf->pos + offset;
+        break;
+    case RW_SEEK_END:
+        if (buffered_flush(rwbuf) < 0) {
+            return -1;
+        }
+        target = SDL_RWseek(rwbuf->src, offset, RW_SEEK_END);
+        if (target < 0) {
+            return -1;
+        }
+        rwbuf->base = target;
+        rwbuf->pos = rwbuf->fill = 0;
+        return target;
+    default:
+        return SDL_SetError("Unknown value for 'whence'");
+    }
+
+    /* Seeks that stay within the read-ahead data don't touch the source */
+    if (!rwbuf->writing && target >= rwbuf->base && target <= rwbuf->base + (Sint64)rwbuf->fill) {
+        rwbuf->pos = (size_t)(target - rwbuf->base);
+        return target;
+    }
+    if (target < 0) {
+        return SDL_SetError("Seek before the start of the stream");
+    }
+
+    if (buffered_flush(rwbuf) < 0) {
+        return -1;
+    }
+    target = SDL_RWseek(rwbuf->src, target, RW_SEEK_SET);
+    if (target < 0) {
+        return -1;
+    }
+    rwbuf->base = target;
+    rwbuf->pos = rwbuf->fill = 0;
+    return target;
+}
+
+static size_t SDLCALL
+buffered_read(SDL_RWops * context, void *ptr, size_t size, size_t maxnum)
+{
+    SDL_RWBuffer *rwbuf = (SDL_RWBuffer *) context->hidden.unknown.data1;
+    size_t total_need = size * maxnum;
+    size_t total_read = 0;
+
+    if (!total_need) {
+        return 0;
+    }
+    if (buffered_flush(rwbuf) < 0) {
+        return 0;
+    }
+
+    while (total_need > 0) {
+        size_t avail = rwbuf->fill - rwbuf->pos;
+
+        if (avail > 0) {
+            const size_t amount = SDL_min(avail, total_need);
+
+            SDL_memcpy(ptr, rwbuf->buffer + rwbuf->pos, amount);
+            rwbuf->pos += amount;
+            ptr = (Uint8 *) ptr + amount;
+            total_need -= amount;
+            total_read += amount;
+            continue;
+        }
+
+        /* The buffer is used up, move it along to the source position */
+        rwbuf->base += rwbuf->fill;
+        rwbuf->pos = rwbuf->fill = 0;
+
+        if (total_need >= rwbuf->capacity) {
+            /* Large reads go straight into the caller's memory */
+            avail = SDL_RWread(rwbuf->src, ptr, 1, total_need);
+            rwbuf->base += avail;
+            total_read += avail;
+            break;
+        }
+
+        rwbuf->fill = SDL_RWread(rwbuf->src, rwbuf->buffer, 1, rwbuf->capacity);
+        if (rwbuf->fill == 0) {
+            break;
+        }
+    }
+    return (total_read / size);
+}
+
+static size_t SDLCALL
+buffered_write(SDL_RWops * context, const void *ptr, size_t size, size_t num)
+{
+    SDL_RWBuffer *rwbuf = (SDL_RWBuffer *) context->hidden.unknown.data1;
+    size_t total_bytes = size * num;
+
+    if (!total_bytes) {
+        return 0;
+    }
+
+    if (!rwbuf->writing) {
+        /* Drop any read-ahead data and put the source where we are */
+        const Sint64 here = rwbuf->base + rwbuf->pos;
+
+        if (rwbuf->pos != rwbuf->fill) {
+            if (SDL_RWseek(rwbuf->src, here, RW_SEEK_SET) < 0) {
+                return 0;
+            }
+        }
+        rwbuf->base = here;
+        rwbuf->pos = rwbuf->fill = 0;
+        rwbuf->writing = SDL_TRUE;
+    }
+
+    if (rwbuf->pos + total_bytes > rwbuf->capacity) {
+        if (buffered_flush(rwbuf) < 0) {
+            return 0;
+        }
+        if (total_bytes >= rwbuf->capacity) {
+            /* Large writes go straight to the source */
+            const size_t written = SDL_RWwrite(rwbuf->src, ptr, size, num);
+            rwbuf->base += written * size;
+            return written;
+        }
+        rwbuf->writing = SDL_TRUE;
+    }
+
+    SDL_memcpy(rwbuf->buffer + rwbuf->pos, ptr, total_bytes);
+    rwbuf->pos += total_bytes;
+    return num;
+}
+
+static int SDLCALL
+buffered_close(SDL_RWops * context)
+{
+    SDL_RWBuffer *rwbuf = (SDL_RWBuffer *) context->hidden.unknown.data1;
+    int status = buffered_flush(rwbuf);
+
+    if (rwbuf->freesrc) {
+        if (SDL_RWclose(rwbuf->src) < 0) {
+            status = -1;
+        }
+    }
+    SDL_free(rwbuf);
+    SDL_FreeRW(context);
+    return status;
+}
+
+SDL_RWops *
+SDL_CreateBufferedRW(SDL_RWops * src, size_t buffer_size, int freesrc)
+{
+    SDL_RWBuffer *rwbuf;
+    SDL_RWops *rwops;
+
+    if (!src) {
+        SDL_InvalidParamError("src");
+        return NULL;
+    }
+    if (!buffer_size) {
+        buffer_size = SDL_RWOPS_DEFAULT_BUFFER_SIZE;
+    }
+
+    rwbuf = (SDL_RWBuffer *) SDL_malloc(sizeof(*rwbuf) + buffer_size);
+    if (!rwbuf) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    rwops = SDL_AllocRW();
+    if (!rwops) {
+        SDL_free(rwbuf);
+        return NULL;
+    }
+
+    rwbuf->src = src;
+    rwbuf->freesrc = freesrc;
+    rwbuf->writing = SDL_FALSE;
+    rwbuf->base = SDL_RWtell(src);
+    if (rwbuf->base < 0) {
+        rwbuf->base = 0;
+    }
+    rwbuf->pos = rwbuf->fill = 0;
+    rwbuf->capacity = buffer_size;
+    rwbuf->buffer = (Uint8 *) (rwbuf + 1);
+
+    rwops->size = buffered_size;
+    rwops->seek = buffered_seek;
+    rwops->read = buffered_read;
+    rwops->write = buffered_write;
+    rwops->close = buffered_close;
+    rwops->hidden.unknown.data1 = rwbuf;
+    rwops->type = SDL_RWOPS_BUFFERED;
+    return rwops;
+}
+
 
 /* Functions to create SDL_RWops structures from various data sources */
 
@@ -592,6 +883,18 @@ SDL_RWFromFile(const char *file, const char *mode)
     SDL_SetError("SDL not compiled with stdio support");
 #endif /* !HAVE_STDIO_H */
 
+    /* Appending writes ignore the stream position, so leave those alone */
+    if (rwops && !SDL_strchr(mode, 'a')) {
+        const char *hint = SDL_GetHint(SDL_HINT_RWOPS_BUFFER_SIZE);
+        const int buffer_size = hint ? SDL_atoi(hint) : 0;
+
+        if (buffer_size > 0) {
+            SDL_RWops *buffered = SDL_CreateBufferedRW(rwops, (size_t)buffer_size, 1);
+            if (buffered) {
+                rwops = buffered;
+            }
+        }
+    }
     return rwops;
 }
 
@@ -679,6 +982,124 @@ SDL_RWFromConstMem(const void *mem, int size)
     return rwops;
 }
 
+static SDL_RWops *
+SDL_RWFromReadOnlyData(void *data, size_t size, int (SDLCALL *close) (SDL_RWops *), Uint32 type)
+{
+    SDL_RWops *rwops = SDL_AllocRW();
+    if (rwops != NULL) {
+        rwops->size = mem_size;
+        rwops->seek = mem_seek;
+        rwops->read = mem_read;
+        rwops->write = mem_writeconst;
+        rwops->close = close;
+        rwops->hidden.mem.base = (Uint8 *) data;
+        rwops->hidden.mem.here = rwops->hidden.mem.base;
+        rwops->hidden.mem.stop = rwops->hidden.mem.base + size;
+        rwops->type = type;
+    }
+    return rwops;
+}
+
+SDL_RWops *
+SDL_RWFromFileMapped(const char *file)
+{
+    SDL_RWops *rwops;
+    void *data;
+    size_t size;
+
+    if (!file || !*file) {
+        SDL_InvalidParamError("file");
+        return NULL;
+    }
+
+#if SDL_RWOPS_MMAP
+    {
+        struct stat st;
+        int fd = open(file, O_RDONLY);
+
+        if (fd < 0) {
+            SDL_SetError("Couldn't open %s", file);
+            return NULL;
+        }
+        data = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+            st.st_size > 0 && (Uint64)st.st_size <= SDL_MAX_SINT32) {
+            size = (size_t)st.st_size;
+            data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+
+        if (data != MAP_FAILED) {
+            rwops = SDL_RWFromReadOnlyData(data, size, mapped_close, SDL_RWOPS_MAPPED);
+            if (!rwops) {
+                munmap(data, size);
+            }
+            return rwops;
+        }
+    }
+#elif defined(__WIN32__) && !defined(__WINRT__)
+    {
+        LPTSTR tstr = WIN_UTF8ToString(file);
+        HANDLE h = CreateFile(tstr, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        LARGE_INTEGER filesize;
+
+        SDL_free(tstr);
+        if (h == INVALID_HANDLE_VALUE) {
+            SDL_SetError("Couldn't open %s", file);
+            return NULL;
+        }
+        data = NULL;
+        if (GetFileSizeEx(h, &filesize) && filesize.QuadPart > 0 &&
+            filesize.QuadPart <= SDL_MAX_SINT32) {
+            HANDLE mapping = CreateFileMapping(h, NULL, PAGE_READONLY, 0, 0, NULL);
+
+            size = (size_t)filesize.QuadPart;
+            if (mapping) {
+                /* The view keeps the mapping alive after the handles close */
+                data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(h);
+
+        if (data) {
+            rwops = SDL_RWFromReadOnlyData(data, size, mapped_close, SDL_RWOPS_MAPPED);
+            if (!rwops) {
+                UnmapViewOfFile(data);
+            }
+            return rwops;
+        }
+    }
+#endif
+
+    /* Mapping isn't available for this file, so read it into memory */
+    data = SDL_LoadFile(file, &size);
+    if (!data) {
+        return NULL;
+    }
+    rwops = SDL_RWFromReadOnlyData(data, size, loaded_close, SDL_RWOPS_MEMORY_RO);
+    if (!rwops) {
+        SDL_free(data);
+    }
+    return rwops;
+}
+
+const void *
+SDL_RWGetPointer(SDL_RWops * context, size_t *available)
+{
+    if (!context || context->read != mem_read) {
+        if (available) {
+            *available = 0;
+        }
+        return NULL;
+    }
+    if (available) {
+        *available = (size_t)(context->hidden.mem.stop - context->hidden.mem.here);
+    }
+    return context->hidden.mem.here;
+}
+
 SDL_RWops *
 SDL_AllocRW(void)
 {
@@ -707,21 +1128,45 @@ SDL_LoadFile_RW(SDL_RWops * src, size_t *datasize, int freesrc)
     Sint64 size;
     size_t size_read, size_total;
     void *data = NULL, *newdata;
+    const void *direct;
 
     if (!src) {
         SDL_InvalidParamError("src");
         return NULL;
     }
 
+    /* Memory streams can be copied in one go */
+    direct = SDL_RWGetPointer(src, &size_total);
+    if (direct) {
+        data = SDL_malloc(size_total + 1);
+        if (!data) {
+            SDL_OutOfMemory();
+            goto done;
+        }
+        SDL_memcpy(data, direct, size_total);
+        SDL_RWseek(src, (Sint64)size_total, RW_SEEK_CUR);
+        goto finish;
+    }
+
     size = SDL_RWsize(src);
     if (size < 0) {
         size = FILE_CHUNK_SIZE;
     }
     data = SDL_malloc((size_t)(size + 1));
+    if (!data) {
+        SDL_OutOfMemory();
+        goto done;
+    }
 
     size_total = 0;
     for (;;) {
-        if ((((Sint64)size_total) + FILE_CHUNK_SIZE) > size) {
+        if (((Sint64)size_total) == size) {
+            /* Make sure the stream has ended before growing the buffer */
+            char probe;
+
+            if (SDL_RWread(src, &probe, 1, 1) == 0) {
+                break;
+            }
             size = (size_total + FILE_CHUNK_SIZE);
             newdata = SDL_realloc(data, (size_t)(size + 1));
             if (!newdata) {
@@ -731,6 +1176,8 @@ SDL_LoadFile_RW(SDL_RWops * src, size_t *datasize, int freesrc)
                 goto done;
             }
             data = newdata;
+            ((char *)data)[size_total++] = probe;
+            continue;
         }
 
         size_read = SDL_RWread(src, (char *)data+size_total, 1, (size_t)(size-size_total));
@@ -740,6 +1187,7 @@ SDL_LoadFile_RW(SDL_RWops * src, size_t *datasize, int freesrc)
         size_total += size_read;
     }
 
+finish:
     if (datasize) {
         *datasize = size_total;
     }
@@ -865,4 +1313,177 @@ SDL_WriteBE64(SDL_RWops * dst, Uint64 value)
     return SDL_RWwrite(dst, &swapped, sizeof (swapped), 1);
 }
 
+/* Functions for dynamically reading and writing endian-specific arrays */
+
+static void
+SDL_SwapArray(void *data, size_t size, size_t count)
+{
+    size_t i = 0;
+
+#if HAVE_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        __m128i *vec = (__m128i *) data;
+        const size_t nvec = (count * size) / sizeof (__m128i);
+
+        /* Swap the bytes of each 16-bit lane, then reverse the order of the
+           lanes within each value for the wider sizes */
+        for (i = 0; i < nvec; ++i) {
+            __m128i v = _mm_loadu_si128(&vec[i]);
+            v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+            if (size == sizeof (Uint32)) {
+                v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+                v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+            } else if (size == sizeof (Uint64)) {
+                v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+                v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+            }
+            _mm_storeu_si128(&vec[i], v);
+        }
+        i = (nvec * sizeof (__m128i)) / size;
+    }
+#endif
+
+    switch (size) {
+    case sizeof (Uint16): {
+        Uint16 *values = (Uint16 *) data;
+        for ( ; i < count; ++i) {
+            values[i] = SDL_Swap16(values[i]);
+        }
+        break;
+    }
+    case sizeof (Uint32): {
+        Uint32 *values = (Uint32 *) data;
+        for ( ; i < count; ++i) {
+            values[i] = SDL_Swap32(values[i]);
+        }
+        break;
+    }
+    case sizeof (Uint64): {
+        Uint64 *values = (Uint64 *) data;
+        for ( ; i < count; ++i) {
+            values[i] = SDL_Swap64(values[i]);
+        }
+        break;
+    }
+    }
+}
+
+static size_t
+SDL_ReadArray(SDL_RWops * src, void *dst, size_t size, size_t count, SDL_bool swap)
+{
+    const size_t amount = SDL_RWread(src, dst, size, count);
+
+    if (swap) {
+        SDL_SwapArray(dst, size, amount);
+    }
+    return amount;
+}
+
+static size_t
+SDL_WriteArray(SDL_RWops * dst, const void *src, size_t size, size_t count, SDL_bool swap)
+{
+    Uint64 buffer[64];
+    const size_t chunk = sizeof (buffer) / size;
+    size_t done = 0;
+
+    if (!swap) {
+        return SDL_RWwrite(dst, src, size, count);
+    }
+
+    /* Swap a chunk at a time into a scratch buffer, src must not change */
+    while (done < count) {
+        const size_t amount = SDL_min(count - done, chunk);
+        size_t written;
+
+        SDL_memcpy(buffer, (const Uint8 *) src + done * size, amount * size);
+        SDL_SwapArray(buffer, size, amount);
+        written = SDL_RWwrite(dst, buffer, size, amount);
+        done += written;
+        if (written != amount) {
+            break;
+        }
+    }
+    return done;
+}
+
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+#define SDL_SWAP_LE SDL_FALSE
+#define SDL_SWAP_BE SDL_TRUE
+#else
+#define SDL_SWAP_LE SDL_TRUE
+#define SDL_SWAP_BE SDL_FALSE
+#endif
+
+size_t
+SDL_ReadLE16Array(SDL_RWops * src, Uint16 * dst, size_t count)
+{
+    return SDL_ReadArray(src, dst, sizeof (*dst), count, SDL_SWAP_LE);
+}
+
+size_t
+SDL_ReadBE16Array(SDL_RWops * src, Uint16 * dst, size_t count)
+{
+    return SDL_ReadArray(src, dst, sizeof (*dst), count, SDL_SWAP_BE);
+}
+
+size_t
+SDL_ReadLE32Array(SDL_RWops * src, Uint32 * dst, size_t count)
+{
+    return SDL_ReadArray(src, dst, sizeof (*dst), count, SDL_SWAP_LE);
+}
+
+size_t
+SDL_ReadBE32Array(SDL_RWops * src, Uint32 * dst, size_t count)
+{
+    return SDL_ReadArray(src, dst, sizeof (*dst), count, SDL_SWAP_BE);
+}
+
+size_t
+SDL_ReadLE64Array(SDL_RWops * src, Uint64 * dst, size_t count)
+{
+    return SDL_ReadArray(src, dst, sizeof (*dst), count, SDL_SWAP_LE);
+}
+
+size_t
+SDL_ReadBE64Array(SDL_RWops * src, Uint64 * dst, size_t count)
+{
+    return SDL_ReadArray(src, dst, sizeof (*dst), count, SDL_SWAP_BE);
+}
+
+size_t
+SDL_WriteLE16Array(SDL_RWops * dst, const Uint16 * src, size_t count)
+{
+    return SDL_WriteArray(dst, src, sizeof (*src), count, SDL_SWAP_LE);
+}
+
+size_t
+SDL_WriteBE16Array(SDL_RWops * dst, const Uint16 * src, size_t count)
+{
+    return SDL_WriteArray(dst, src, sizeof (*src), count, SDL_SWAP_BE);
+}
+
+size_t
+SDL_WriteLE32Array(SDL_RWops * dst, const Uint32 * src, size_t count)
+{
+    return SDL_WriteArray(dst, src, sizeof (*src), count, SDL_SWAP_LE);
+}
+
+size_t
+SDL_WriteBE32Array(SDL_RWops * dst, const Uint32 * src, size_t count)
+{
+    return SDL_WriteArray(dst, src, sizeof (*src), count, SDL_SWAP_BE);
+}
+
+size_t
+SDL_WriteLE64Array(SDL_RWops * dst, const Uint64 * src, size_t count)
+{
+    return SDL_WriteArray(dst, src, sizeof (*src), count, SDL_SWAP_LE);
+}
+
+size_t
+SDL_WriteBE64Array(SDL_RWops * dst, const Uint64 * src, size_t count)
+{
+    return SDL_WriteArray(dst, src, sizeof (*src), count, SDL_SWAP_BE);
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
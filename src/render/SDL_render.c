@@ -28,6 +28,7 @@
 #include "SDL_render.h"
 #include "SDL_sysrender.h"
 #include "software/SDL_render_sw_c.h"
+#include "../SDL_hints_c.h"
 
 
 #define SDL_WINDOWRENDERDATA    "_SDL_WindowRenderData"
@@ -1074,7 +1075,8 @@ GetClosestSupportedFormat(SDL_Renderer * renderer, Uint32 format)
 
 static SDL_ScaleMode SDL_GetScaleMode(void)
 {
-    const char *hint = SDL_GetHint(SDL_HINT_RENDER_SCALE_QUALITY);
+    static SDL_HintCache scale_quality = SDL_HINT_CACHE_INIT(SDL_HINT_RENDER_SCALE_QUALITY);
+    const char *hint = SDL_GetHintCached(&scale_quality);
 
     if (!hint || SDL_strcasecmp(hint, "nearest") == 0) {
         return SDL_ScaleModeNearest;
@@ -1083,7 +1085,7 @@ static SDL_ScaleMode SDL_GetScaleMode(void)
     } else if (SDL_strcasecmp(hint, "best") == 0) {
         return SDL_ScaleModeBest;
     } else {
-        return (SDL_ScaleMode)SDL_atoi(hint);
+        return (SDL_ScaleMode)scale_quality.int_value;
     }
 }
 
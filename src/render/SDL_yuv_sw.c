@@ -338,9 +338,20 @@ SDL_SW_CopyYUVToRGB(SDL_SW_YUVTexture * swdata, const SDL_Rect * srcrect,
     int stretch;
 
     /* Make sure we're set up to display in the desired format */
-    if (target_format != swdata->target_format && swdata->display) {
+    if (target_format != swdata->target_format) {
         SDL_FreeSurface(swdata->display);
         swdata->display = NULL;
+        SDL_FreeSurface(swdata->stretch);
+        swdata->stretch = NULL;
+        SDL_FreePixelConverter(swdata->converter);
+        swdata->converter = NULL;
+        swdata->target_format = target_format;
+    }
+    if (!swdata->converter) {
+        swdata->converter = SDL_CreatePixelConverter(swdata->format, target_format, swdata->w, swdata->h);
+        if (!swdata->converter) {
+            return -1;
+        }
     }
 
     stretch = 0;
@@ -388,9 +399,8 @@ SDL_SW_CopyYUVToRGB(SDL_SW_YUVTexture * swdata, const SDL_Rect * srcrect,
         pixels = swdata->stretch->pixels;
         pitch = swdata->stretch->pitch;
     }
-    if (SDL_ConvertPixels(swdata->w, swdata->h, swdata->format,
-                          swdata->planes[0], swdata->pitches[0], 
-                          target_format, pixels, pitch) < 0) {
+    if (SDL_RunPixelConverter(swdata->converter, swdata->planes[0],
+                              swdata->pitches[0], pixels, pitch) < 0) {
         return -1;
     }
     if (stretch) {
@@ -407,6 +417,7 @@ SDL_SW_DestroyYUVTexture(SDL_SW_YUVTexture * swdata)
         SDL_free(swdata->pixels);
         SDL_FreeSurface(swdata->stretch);
         SDL_FreeSurface(swdata->display);
+        SDL_FreePixelConverter(swdata->converter);
         SDL_free(swdata);
     }
 }
@@ -42,6 +42,9 @@ struct SDL_SW_YUVTexture
     /* This is a temporary surface in case we have to stretch copy */
     SDL_Surface *stretch;
     SDL_Surface *display;
+
+    /* The conversion to target_format, kept from frame to frame */
+    SDL_PixelConverter *converter;
 };
 
 typedef struct SDL_SW_YUVTexture SDL_SW_YUVTexture;
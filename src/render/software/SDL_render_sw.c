@@ -554,11 +554,10 @@ PrepTextureForCopy(const SDL_RenderCommand *cmd)
     const SDL_BlendMode blend = cmd->data.draw.blend;
     SDL_Texture *texture = cmd->data.draw.texture;
     SDL_Surface *surface = (SDL_Surface *) texture->driverdata;
-    const SDL_bool colormod = ((r & g & b) != 0xFF);
-    const SDL_bool alphamod = (a != 0xFF);
-    const SDL_bool blending = ((blend == SDL_BLENDMODE_ADD) || (blend == SDL_BLENDMODE_MOD));
 
-    if (colormod || alphamod || blending) {
+    /* RLE surfaces carry color and alpha modulation and additive blending,
+       but MOD blending can't skip transparent pixels, so stop encoding */
+    if (blend == SDL_BLENDMODE_MOD) {
         SDL_SetSurfaceRLE(surface, 0);
     }
 
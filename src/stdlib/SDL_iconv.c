@@ -244,6 +244,261 @@ SDL_iconv_open(const char *tocode, const char *fromcode)
     return (SDL_iconv_t) - 1;
 }
 
+/* Fast paths between UTF-8 and UTF-16LE or UCS-4LE, the conversions used
+   most for text.  Runs of ASCII are handled 16 bytes at a time, and other
+   well-formed characters are decoded directly.  They stop at anything else,
+   such as an invalid sequence or the end of a buffer, and leave it to the
+   generic code so the results are exactly the same.
+ */
+SDL_FORCE_INLINE Uint32
+SDL_iconv_LoadLE32(const Uint8 *p)
+{
+    return ((Uint32) p[0]) | ((Uint32) p[1] << 8) |
+           ((Uint32) p[2] << 16) | ((Uint32) p[3] << 24);
+}
+
+/* Check whether 16 bytes are all zero under a little endian mask */
+SDL_FORCE_INLINE SDL_bool
+SDL_iconv_IsASCII16(const Uint8 *p, Uint32 mask)
+{
+    return ((SDL_iconv_LoadLE32(p) | SDL_iconv_LoadLE32(p + 4) |
+             SDL_iconv_LoadLE32(p + 8) | SDL_iconv_LoadLE32(p + 12)) & mask) == 0;
+}
+
+/* Convert UTF-8 to UTF-16LE (unit 2) or UCS-4LE (unit 4), returns the
+   number of characters converted */
+static size_t
+SDL_iconv_FromUTF8(const char **srcp, size_t *srclenp, char **dstp, size_t *dstlenp, const size_t unit)
+{
+    const Uint8 *src = (const Uint8 *) *srcp;
+    Uint8 *dst = (Uint8 *) *dstp;
+    size_t srclen = *srclenp;
+    size_t dstlen = *dstlenp;
+    size_t total = 0;
+    size_t i;
+
+    while (srclen > 0) {
+        const Uint8 c = src[0];
+        Uint32 ch;
+        size_t len;
+
+        if (c < 0x80) {
+            if (srclen >= 16 && dstlen >= 16 * unit && SDL_iconv_IsASCII16(src, 0x80808080)) {
+                if (unit == 2) {
+                    for (i = 0; i < 16; ++i) {
+                        dst[i * 2 + 0] = src[i];
+                        dst[i * 2 + 1] = 0;
+                    }
+                } else {
+                    for (i = 0; i < 16; ++i) {
+                        dst[i * 4 + 0] = src[i];
+                        dst[i * 4 + 1] = 0;
+                        dst[i * 4 + 2] = 0;
+                        dst[i * 4 + 3] = 0;
+                    }
+                }
+                src += 16;
+                srclen -= 16;
+                dst += 16 * unit;
+                dstlen -= 16 * unit;
+                total += 16;
+                continue;
+            }
+            ch = c;
+            len = 1;
+        } else if (c >= 0xC2 && c <= 0xDF) {
+            if (srclen < 2 || (src[1] & 0xC0) != 0x80) {
+                break;
+            }
+            ch = ((Uint32) (c & 0x1F) << 6) | (Uint32) (src[1] & 0x3F);
+            len = 2;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            if (srclen < 3 || (src[1] & 0xC0) != 0x80 || (src[2] & 0xC0) != 0x80) {
+                break;
+            }
+            ch = ((Uint32) (c & 0x0F) << 12) | ((Uint32) (src[1] & 0x3F) << 6) |
+                 (Uint32) (src[2] & 0x3F);
+            if (ch < 0x800 || (ch >= 0xD800 && ch <= 0xDFFF) || ch >= 0xFFFE) {
+                break;
+            }
+            len = 3;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            if (srclen < 4 || (src[1] & 0xC0) != 0x80 ||
+                (src[2] & 0xC0) != 0x80 || (src[3] & 0xC0) != 0x80) {
+                break;
+            }
+            ch = ((Uint32) (c & 0x07) << 18) | ((Uint32) (src[1] & 0x3F) << 12) |
+                 ((Uint32) (src[2] & 0x3F) << 6) | (Uint32) (src[3] & 0x3F);
+            if (ch < 0x10000 || ch > 0x10FFFF) {
+                break;
+            }
+            len = 4;
+        } else {
+            break;
+        }
+
+        if (unit == 4) {
+            if (dstlen < 4) {
+                break;
+            }
+            dst[0] = (Uint8) ch;
+            dst[1] = (Uint8) (ch >> 8);
+            dst[2] = (Uint8) (ch >> 16);
+            dst[3] = 0;
+            dst += 4;
+            dstlen -= 4;
+        } else if (ch < 0x10000) {
+            if (dstlen < 2) {
+                break;
+            }
+            dst[0] = (Uint8) ch;
+            dst[1] = (Uint8) (ch >> 8);
+            dst += 2;
+            dstlen -= 2;
+        } else {
+            Uint16 W1, W2;
+            if (dstlen < 4) {
+                break;
+            }
+            ch -= 0x10000;
+            W1 = 0xD800 | (Uint16) (ch >> 10);
+            W2 = 0xDC00 | (Uint16) (ch & 0x3FF);
+            dst[0] = (Uint8) W1;
+            dst[1] = (Uint8) (W1 >> 8);
+            dst[2] = (Uint8) W2;
+            dst[3] = (Uint8) (W2 >> 8);
+            dst += 4;
+            dstlen -= 4;
+        }
+        src += len;
+        srclen -= len;
+        ++total;
+    }
+
+    *srcp = (const char *) src;
+    *srclenp = srclen;
+    *dstp = (char *) dst;
+    *dstlenp = dstlen;
+    return total;
+}
+
+/* Convert UTF-16LE (unit 2) or UCS-4LE (unit 4) to UTF-8, returns the
+   number of characters converted */
+static size_t
+SDL_iconv_ToUTF8(const char **srcp, size_t *srclenp, char **dstp, size_t *dstlenp, const size_t unit)
+{
+    const Uint8 *src = (const Uint8 *) *srcp;
+    Uint8 *dst = (Uint8 *) *dstp;
+    size_t srclen = *srclenp;
+    size_t dstlen = *dstlenp;
+    size_t total = 0;
+    size_t i;
+
+    while (srclen >= unit) {
+        Uint32 ch;
+        size_t len;
+
+        if (srclen >= 16 && dstlen >= 16 / unit &&
+            SDL_iconv_IsASCII16(src, (unit == 2) ? 0xFF80FF80 : 0xFFFFFF80)) {
+            for (i = 0; i < 16 / unit; ++i) {
+                dst[i] = src[i * unit];
+            }
+            src += 16;
+            srclen -= 16;
+            dst += 16 / unit;
+            dstlen -= 16 / unit;
+            total += 16 / unit;
+            continue;
+        }
+
+        if (unit == 4) {
+            ch = SDL_iconv_LoadLE32(src);
+            if (ch > 0x10FFFF) {
+                break;
+            }
+            len = 4;
+        } else {
+            const Uint16 W1 = (Uint16) src[0] | ((Uint16) src[1] << 8);
+            if (W1 < 0xD800 || W1 > 0xDFFF) {
+                ch = W1;
+                len = 2;
+            } else {
+                Uint16 W2;
+                if (W1 > 0xDBFF || srclen < 4) {
+                    break;
+                }
+                W2 = (Uint16) src[2] | ((Uint16) src[3] << 8);
+                if (W2 < 0xDC00 || W2 > 0xDFFF) {
+                    break;
+                }
+                ch = (((Uint32) (W1 & 0x3FF) << 10) | (Uint32) (W2 & 0x3FF)) + 0x10000;
+                len = 4;
+            }
+        }
+
+        if (ch <= 0x7F) {
+            if (dstlen < 1) {
+                break;
+            }
+            dst[0] = (Uint8) ch;
+            dst += 1;
+            dstlen -= 1;
+        } else if (ch <= 0x7FF) {
+            if (dstlen < 2) {
+                break;
+            }
+            dst[0] = 0xC0 | (Uint8) (ch >> 6);
+            dst[1] = 0x80 | (Uint8) (ch & 0x3F);
+            dst += 2;
+            dstlen -= 2;
+        } else if (ch <= 0xFFFF) {
+            if (dstlen < 3) {
+                break;
+            }
+            dst[0] = 0xE0 | (Uint8) (ch >> 12);
+            dst[1] = 0x80 | (Uint8) ((ch >> 6) & 0x3F);
+            dst[2] = 0x80 | (Uint8) (ch & 0x3F);
+            dst += 3;
+            dstlen -= 3;
+        } else {
+            if (dstlen < 4) {
+                break;
+            }
+            dst[0] = 0xF0 | (Uint8) (ch >> 18);
+            dst[1] = 0x80 | (Uint8) ((ch >> 12) & 0x3F);
+            dst[2] = 0x80 | (Uint8) ((ch >> 6) & 0x3F);
+            dst[3] = 0x80 | (Uint8) (ch & 0x3F);
+            dst += 4;
+            dstlen -= 4;
+        }
+        src += len;
+        srclen -= len;
+        ++total;
+    }
+
+    *srcp = (const char *) src;
+    *srclenp = srclen;
+    *dstp = (char *) dst;
+    *dstlenp = dstlen;
+    return total;
+}
+
+/* Returns the unit size of the UTF-16LE or UCS-4LE side of a conversion
+   with a fast path, or 0 if there isn't one */
+static size_t
+SDL_iconv_FastUnit(int fmt)
+{
+    switch (fmt) {
+    case ENCODING_UTF16LE:
+        return 2;
+    case ENCODING_UTF32LE:
+    case ENCODING_UCS4LE:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
 size_t
 SDL_iconv(SDL_iconv_t cd,
           const char **inbuf, size_t * inbytesleft,
@@ -255,6 +510,7 @@ SDL_iconv(SDL_iconv_t cd,
     size_t srclen, dstlen;
     Uint32 ch = 0;
     size_t total;
+    size_t from_utf8 = 0, to_utf8 = 0;
 
     if (!inbuf || !*inbuf) {
         /* Reset the context */
@@ -340,8 +596,33 @@ SDL_iconv(SDL_iconv_t cd,
         break;
     }
 
+    if (cd->src_fmt == ENCODING_UTF8) {
+        from_utf8 = SDL_iconv_FastUnit(cd->dst_fmt);
+    } else if (cd->dst_fmt == ENCODING_UTF8) {
+        to_utf8 = SDL_iconv_FastUnit(cd->src_fmt);
+    }
+
     total = 0;
     while (srclen > 0) {
+        if (from_utf8 || to_utf8) {
+            size_t count;
+            if (from_utf8) {
+                count = SDL_iconv_FromUTF8(&src, &srclen, &dst, &dstlen, from_utf8);
+            } else {
+                count = SDL_iconv_ToUTF8(&src, &srclen, &dst, &dstlen, to_utf8);
+            }
+            if (count) {
+                *inbuf = src;
+                *inbytesleft = srclen;
+                *outbuf = dst;
+                *outbytesleft = dstlen;
+                total += count;
+                if (srclen == 0) {
+                    break;
+                }
+            }
+        }
+
         /* Decode a character */
         switch (cd->src_fmt) {
         case ENCODING_ASCII:
@@ -23,12 +23,16 @@
 #define SDL_DISABLE_ANALYZE_MACROS 1
 #endif
 
+/* The allocation functions are defined here, not remapped to tagged ones */
+#define SDL_MALLOC_IMPLEMENTATION 1
+
 #include "../SDL_internal.h"
 
 /* This file contains portable memory management functions for SDL */
 #include "SDL_stdinc.h"
 #include "SDL_atomic.h"
 #include "SDL_error.h"
+#include "SDL_memstats.h"
 
 #ifndef HAVE_MALLOC
 #define LACKS_SYS_TYPES_H
@@ -5315,6 +5319,628 @@ History:
 #define real_free dlfree
 #endif
 
+/* Size of the header SDL_MEMORY_ACCOUNTING puts in front of each block */
+#define SDL_MEMORY_HEADER_SIZE  16
+
+/* Put a slab allocator in front of the heap for small allocations, so the
+   small fixed-size objects SDL churns through (events, timers, audio queue
+   packets, render commands) don't each take the heap lock, and don't
+   fragment it.
+ */
+#ifndef SDL_MALLOC_SLAB
+#ifndef HAVE_MALLOC
+#define SDL_MALLOC_SLAB 1
+#else
+#define SDL_MALLOC_SLAB 0
+#endif
+#endif
+
+#if SDL_MALLOC_SLAB
+
+#include "SDL_cpuinfo.h"
+#include "../thread/SDL_thread_c.h"
+#include "SDL_malloc_c.h"
+
+/* Each page holds objects of one size, and starts with a small header that
+   keeps the page's free objects.  Pages are carved out of larger arenas from
+   the heap, aligned so any object's page can be found by masking its address.
+   Completely free pages go back to a shared list for any size class to use,
+   and once more than a few arenas' worth of pages are sitting free, arenas
+   that are entirely free are given back to the heap.
+ */
+#define SDL_SLAB_PAGE_SIZE      (16 * 1024)
+#define SDL_SLAB_HEADER_SIZE    64
+#define SDL_SLAB_ARENA_PAGES    16
+#define SDL_SLAB_MIN_FREE_PAGES (2 * SDL_SLAB_ARENA_PAGES)
+#define SDL_SLAB_MAX_PAGES      2048    /* 32 MB of small objects */
+#define SDL_SLAB_TABLE_SIZE     (SDL_SLAB_MAX_PAGES * 2)
+#define SDL_SLAB_NUM_CLASSES    13
+
+/* With memory accounting every block is a header bigger than what was asked
+   for, so the size classes grow to match, and requests of up to 512 bytes
+   still come from the slab.
+ */
+#if SDL_MEMORY_ACCOUNTING
+#define SDL_SLAB_EXTRA          SDL_MEMORY_HEADER_SIZE
+#else
+#define SDL_SLAB_EXTRA          0
+#endif
+#define SDL_SLAB_SIZE(size)     ((size) + SDL_SLAB_EXTRA)
+#define SDL_SLAB_MAX_SIZE       SDL_SLAB_SIZE(512)
+
+/* Number of objects moved between a thread's cache and the shared lists at a time */
+#define SDL_SLAB_BATCH          32
+
+/* Marks a page table entry whose arena went back to the heap */
+#define SDL_SLAB_DELETED        ((void *)1)
+
+static const Uint16 SDL_slab_sizes[SDL_SLAB_NUM_CLASSES] = {
+    SDL_SLAB_SIZE(16), SDL_SLAB_SIZE(32), SDL_SLAB_SIZE(48), SDL_SLAB_SIZE(64),
+    SDL_SLAB_SIZE(80), SDL_SLAB_SIZE(96), SDL_SLAB_SIZE(128), SDL_SLAB_SIZE(160),
+    SDL_SLAB_SIZE(192), SDL_SLAB_SIZE(256), SDL_SLAB_SIZE(320), SDL_SLAB_SIZE(384),
+    SDL_SLAB_SIZE(512)
+};
+
+/* Size class for each size (less the extra) in 16 byte units, rounded up */
+static const Uint8 SDL_slab_class_of[512 / 16 + 1] = {
+    0, 0, 1, 2, 3, 4, 5, 6, 6, 7, 7, 8, 8, 9, 9, 9, 9,
+    10, 10, 10, 10, 11, 11, 11, 11, 12, 12, 12, 12, 12, 12, 12, 12
+};
+
+typedef struct
+{
+    void *memory;               /* what the heap gave us */
+    Uint8 *pages;
+    int free_pages;
+} SDL_SlabArena;
+
+typedef struct SDL_SlabPage
+{
+    int size_class;
+    int num_objects;
+    int num_free;
+    void *objects;              /* free objects, linked through their first word */
+    struct SDL_SlabPage *prev;
+    struct SDL_SlabPage *next;
+    SDL_SlabArena *arena;
+} SDL_SlabPage;
+
+SDL_COMPILE_TIME_ASSERT(slab_header, sizeof(SDL_SlabPage) <= SDL_SLAB_HEADER_SIZE);
+
+typedef struct
+{
+    SDL_SpinLock lock;
+    SDL_SlabPage *pages;        /* pages of this class with free objects */
+
+    /* Padding to keep each size class on its own cache line */
+    char cache_pad[SDL_CACHELINE_SIZE];
+} SDL_SlabClass;
+
+static struct
+{
+    SDL_SlabClass classes[SDL_SLAB_NUM_CLASSES];
+
+    /* Everything below is protected by the lock */
+    SDL_SpinLock lock;
+    SDL_SlabPage *free_pages;   /* pages with no objects handed out */
+    int num_free_pages;
+    int num_pages;
+
+    /* Every page's address, for SDL_free() to recognize slab objects.
+       Lookups don't take the lock: a page is published before any of its
+       objects are handed out, and only removed once all of them are free.
+     */
+    void *pages[SDL_SLAB_TABLE_SIZE];
+    uintptr_t lowest_page;
+    uintptr_t highest_page;
+} SDL_slab;
+
+#ifdef SDL_THREAD_LOCAL
+typedef struct
+{
+    void *objects;
+    int count;
+} SDL_SlabCache;
+
+static SDL_THREAD_LOCAL SDL_SlabCache SDL_slab_cache[SDL_SLAB_NUM_CLASSES];
+static SDL_THREAD_LOCAL SDL_bool SDL_slab_cache_watched;
+#endif
+
+/* Returns the size class for an allocation of up to SDL_SLAB_MAX_SIZE bytes */
+SDL_FORCE_INLINE int
+SDL_SlabClassForSize(size_t size)
+{
+    /* The memory functions can still be called without a header in front */
+    if (size <= SDL_SLAB_EXTRA) {
+        return 0;
+    }
+    return SDL_slab_class_of[(size - SDL_SLAB_EXTRA + 15) / 16];
+}
+
+SDL_FORCE_INLINE Uint32
+SDL_SlabHash(uintptr_t page)
+{
+    return ((Uint32)(page / SDL_SLAB_PAGE_SIZE) * 2654435761u) & (SDL_SLAB_TABLE_SIZE - 1);
+}
+
+/* Returns the size class of a slab object, or -1 if it came from the heap */
+static int
+SDL_SlabClassOf(const void *ptr)
+{
+    const uintptr_t page = (uintptr_t)ptr & ~(uintptr_t)(SDL_SLAB_PAGE_SIZE - 1);
+    Uint32 i, n;
+
+    if (page < SDL_slab.lowest_page || page > SDL_slab.highest_page) {
+        return -1;
+    }
+    for (i = SDL_SlabHash(page), n = 0; n < SDL_SLAB_TABLE_SIZE; i = (i + 1) & (SDL_SLAB_TABLE_SIZE - 1), ++n) {
+        const uintptr_t entry = (uintptr_t)*(void * volatile *)&SDL_slab.pages[i];
+        if (entry == page) {
+            return ((SDL_SlabPage *)page)->size_class;
+        }
+        if (!entry) {
+            break;
+        }
+    }
+    return -1;
+}
+
+static void
+SDL_SlabLinkPage(SDL_SlabPage **list, SDL_SlabPage *page)
+{
+    page->prev = NULL;
+    page->next = *list;
+    if (page->next) {
+        page->next->prev = page;
+    }
+    *list = page;
+}
+
+static void
+SDL_SlabUnlinkPage(SDL_SlabPage **list, SDL_SlabPage *page)
+{
+    if (page->prev) {
+        page->prev->next = page->next;
+    } else {
+        *list = page->next;
+    }
+    if (page->next) {
+        page->next->prev = page->prev;
+    }
+}
+
+/* Get a new arena of free pages from the heap, called with the slab locked */
+static void
+SDL_SlabAddArena(void)
+{
+    SDL_SlabArena *arena;
+    Uint8 *memory;
+    Uint8 *page;
+    Uint32 i;
+    int n;
+
+    if (SDL_slab.num_pages + SDL_SLAB_ARENA_PAGES > SDL_SLAB_MAX_PAGES) {
+        return;
+    }
+
+    /* Over-allocate the arena so the pages in it can be aligned, the
+       bookkeeping goes in whatever is left over at the end.
+     */
+    memory = (Uint8 *)real_malloc((SDL_SLAB_ARENA_PAGES + 1) * SDL_SLAB_PAGE_SIZE + sizeof(SDL_SlabArena));
+    if (!memory) {
+        return;
+    }
+    arena = (SDL_SlabArena *)(memory + (SDL_SLAB_ARENA_PAGES + 1) * SDL_SLAB_PAGE_SIZE);
+    arena->memory = memory;
+    arena->pages = (Uint8 *)(((uintptr_t)memory + SDL_SLAB_PAGE_SIZE - 1) & ~(uintptr_t)(SDL_SLAB_PAGE_SIZE - 1));
+    arena->free_pages = SDL_SLAB_ARENA_PAGES;
+
+    /* Link the pages in reverse so they're handed out in address order */
+    for (n = SDL_SLAB_ARENA_PAGES - 1; n >= 0; --n) {
+        page = arena->pages + n * SDL_SLAB_PAGE_SIZE;
+        ((SDL_SlabPage *)page)->arena = arena;
+        SDL_SlabLinkPage(&SDL_slab.free_pages, (SDL_SlabPage *)page);
+
+        /* Publish the page, reusing the first deleted entry on the way */
+        for (i = SDL_SlabHash((uintptr_t)page); SDL_slab.pages[i] && SDL_slab.pages[i] != SDL_SLAB_DELETED; i = (i + 1) & (SDL_SLAB_TABLE_SIZE - 1)) {
+            continue;
+        }
+        SDL_AtomicSetPtr(&SDL_slab.pages[i], page);
+        if (!SDL_slab.lowest_page || (uintptr_t)page < SDL_slab.lowest_page) {
+            SDL_slab.lowest_page = (uintptr_t)page;
+        }
+        if ((uintptr_t)page > SDL_slab.highest_page) {
+            SDL_slab.highest_page = (uintptr_t)page;
+        }
+    }
+    SDL_slab.num_free_pages += SDL_SLAB_ARENA_PAGES;
+    SDL_slab.num_pages += SDL_SLAB_ARENA_PAGES;
+}
+
+/* Give an arena whose pages are all free back to the heap, called with the slab locked */
+static void
+SDL_SlabFreeArena(SDL_SlabArena *arena)
+{
+    Uint8 *page;
+    Uint32 i;
+    int n;
+
+    for (n = 0; n < SDL_SLAB_ARENA_PAGES; ++n) {
+        page = arena->pages + n * SDL_SLAB_PAGE_SIZE;
+        SDL_SlabUnlinkPage(&SDL_slab.free_pages, (SDL_SlabPage *)page);
+
+        for (i = SDL_SlabHash((uintptr_t)page); SDL_slab.pages[i] != page; i = (i + 1) & (SDL_SLAB_TABLE_SIZE - 1)) {
+            continue;
+        }
+
+        /* Lookups for other pages may need to probe past this entry, unless
+           it's at the end of a run, in which case the run can be shortened.
+         */
+        SDL_AtomicSetPtr(&SDL_slab.pages[i], SDL_SLAB_DELETED);
+        while (SDL_slab.pages[i] == SDL_SLAB_DELETED && !SDL_slab.pages[(i + 1) & (SDL_SLAB_TABLE_SIZE - 1)]) {
+            SDL_AtomicSetPtr(&SDL_slab.pages[i], NULL);
+            i = (i - 1) & (SDL_SLAB_TABLE_SIZE - 1);
+        }
+    }
+    SDL_slab.num_free_pages -= SDL_SLAB_ARENA_PAGES;
+    SDL_slab.num_pages -= SDL_SLAB_ARENA_PAGES;
+    real_free(arena->memory);
+}
+
+/* Get a free page for a size class, called with the class locked */
+static SDL_SlabPage *
+SDL_SlabGetPage(int size_class)
+{
+    const int size = SDL_slab_sizes[size_class];
+    SDL_SlabPage *page;
+    Uint8 *object;
+    void **link;
+
+    SDL_AtomicLock(&SDL_slab.lock);
+    if (!SDL_slab.free_pages) {
+        SDL_SlabAddArena();
+    }
+    page = SDL_slab.free_pages;
+    if (page) {
+        SDL_SlabUnlinkPage(&SDL_slab.free_pages, page);
+        --SDL_slab.num_free_pages;
+        --page->arena->free_pages;
+    }
+    SDL_AtomicUnlock(&SDL_slab.lock);
+
+    if (!page) {
+        return NULL;
+    }
+
+    /* Put the objects on the free list in address order */
+    page->size_class = size_class;
+    page->num_objects = 0;
+    link = &page->objects;
+    for (object = (Uint8 *)page + SDL_SLAB_HEADER_SIZE; object + size <= (Uint8 *)page + SDL_SLAB_PAGE_SIZE; object += size) {
+        *link = object;
+        link = (void **)object;
+        ++page->num_objects;
+    }
+    *link = NULL;
+    page->num_free = page->num_objects;
+    return page;
+}
+
+/* Give back a page with no objects handed out, called with the class locked */
+static void
+SDL_SlabPutPage(SDL_SlabPage *page)
+{
+    SDL_SlabArena *arena = page->arena;
+
+    SDL_AtomicLock(&SDL_slab.lock);
+    SDL_SlabLinkPage(&SDL_slab.free_pages, page);
+    ++SDL_slab.num_free_pages;
+    if (++arena->free_pages == SDL_SLAB_ARENA_PAGES &&
+        SDL_slab.num_free_pages - SDL_SLAB_ARENA_PAGES >= SDL_SLAB_MIN_FREE_PAGES) {
+        SDL_SlabFreeArena(arena);
+    }
+    SDL_AtomicUnlock(&SDL_slab.lock);
+}
+
+/* Take up to max objects from a size class, returns how many were taken */
+static int
+SDL_SlabTakeObjects(int size_class, void **objects, int max)
+{
+    SDL_SlabClass *slab_class = &SDL_slab.classes[size_class];
+    SDL_SlabPage *page;
+    void **link = objects;
+    int count = 0;
+
+    SDL_AtomicLock(&slab_class->lock);
+    while (count < max) {
+        page = slab_class->pages;
+        if (!page) {
+            /* Only start a new page if we have nothing to give */
+            if (count) {
+                break;
+            }
+            page = SDL_SlabGetPage(size_class);
+            if (!page) {
+                break;
+            }
+            SDL_SlabLinkPage(&slab_class->pages, page);
+        }
+        *link = page->objects;
+        link = (void **)page->objects;
+        page->objects = *link;
+        ++count;
+        if (--page->num_free == 0) {
+            SDL_SlabUnlinkPage(&slab_class->pages, page);
+        }
+    }
+    SDL_AtomicUnlock(&slab_class->lock);
+
+    *link = NULL;
+    return count;
+}
+
+/* Give a list of objects back to their pages */
+static void
+SDL_SlabReturnObjects(int size_class, void *objects)
+{
+    SDL_SlabClass *slab_class = &SDL_slab.classes[size_class];
+    SDL_SlabPage *page;
+    void *object;
+
+    SDL_AtomicLock(&slab_class->lock);
+    while (objects) {
+        object = objects;
+        objects = *(void **)object;
+
+        page = (SDL_SlabPage *)((uintptr_t)object & ~(uintptr_t)(SDL_SLAB_PAGE_SIZE - 1));
+        *(void **)object = page->objects;
+        page->objects = object;
+        if (page->num_free++ == 0) {
+            SDL_SlabLinkPage(&slab_class->pages, page);
+        }
+        if (page->num_free == page->num_objects) {
+            SDL_SlabUnlinkPage(&slab_class->pages, page);
+            SDL_SlabPutPage(page);
+        }
+    }
+    SDL_AtomicUnlock(&slab_class->lock);
+}
+
+#ifdef SDL_THREAD_LOCAL
+/* Threads SDL didn't create don't go through SDL_RunThread(), so have the
+   system flush their caches when they exit.
+ */
+#if SDL_THREAD_PTHREAD
+#include <pthread.h>
+
+static pthread_once_t SDL_slab_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t SDL_slab_key;
+static SDL_bool SDL_slab_key_valid;
+
+static void
+SDL_SlabThreadExit(void *unused)
+{
+    SDL_slab_cache_watched = SDL_FALSE;
+    SDL_FlushMemoryCache();
+}
+
+static void
+SDL_SlabCreateKey(void)
+{
+    SDL_slab_key_valid = (pthread_key_create(&SDL_slab_key, SDL_SlabThreadExit) == 0);
+}
+
+#elif defined(__WIN32__) && !defined(__WINRT__)
+#include "../core/windows/SDL_windows.h"
+
+/* Fiber local storage callbacks are run as threads exit, the functions are
+   looked up since they're only available on Windows Vista and newer.
+ */
+typedef VOID (WINAPI *SDL_FlsCallback)(PVOID);
+typedef DWORD (WINAPI *pfnFlsAlloc)(SDL_FlsCallback);
+typedef BOOL (WINAPI *pfnFlsSetValue)(DWORD, PVOID);
+
+#define SDL_SLAB_NO_FLS ((DWORD)0xFFFFFFFF)
+
+static SDL_SpinLock SDL_slab_fls_lock;
+static SDL_bool SDL_slab_fls_checked;
+static DWORD SDL_slab_fls = SDL_SLAB_NO_FLS;
+static pfnFlsSetValue SDL_slab_FlsSetValue;
+
+static VOID WINAPI
+SDL_SlabThreadExit(PVOID unused)
+{
+    SDL_slab_cache_watched = SDL_FALSE;
+    SDL_FlushMemoryCache();
+}
+#endif
+
+static void
+SDL_SlabWatchThread(void)
+{
+    SDL_slab_cache_watched = SDL_TRUE;
+#if SDL_THREAD_PTHREAD
+    pthread_once(&SDL_slab_key_once, SDL_SlabCreateKey);
+    if (SDL_slab_key_valid) {
+        pthread_setspecific(SDL_slab_key, &SDL_slab_cache_watched);
+    }
+#elif defined(__WIN32__) && !defined(__WINRT__)
+    SDL_AtomicLock(&SDL_slab_fls_lock);
+    if (!SDL_slab_fls_checked) {
+        HMODULE kernel32 = GetModuleHandle(TEXT("kernel32.dll"));
+        if (kernel32) {
+            pfnFlsAlloc pFlsAlloc = (pfnFlsAlloc)GetProcAddress(kernel32, "FlsAlloc");
+            SDL_slab_FlsSetValue = (pfnFlsSetValue)GetProcAddress(kernel32, "FlsSetValue");
+            if (pFlsAlloc && SDL_slab_FlsSetValue) {
+                SDL_slab_fls = pFlsAlloc(SDL_SlabThreadExit);
+            }
+        }
+        SDL_slab_fls_checked = SDL_TRUE;
+    }
+    SDL_AtomicUnlock(&SDL_slab_fls_lock);
+    if (SDL_slab_fls != SDL_SLAB_NO_FLS) {
+        SDL_slab_FlsSetValue(SDL_slab_fls, &SDL_slab_cache_watched);
+    }
+#endif
+}
+#endif /* SDL_THREAD_LOCAL */
+
+static void *
+SDL_SlabAlloc(int size_class)
+{
+    void *object;
+#ifdef SDL_THREAD_LOCAL
+    SDL_SlabCache *cache = &SDL_slab_cache[size_class];
+
+    if (!cache->objects) {
+        if (!SDL_slab_cache_watched) {
+            SDL_SlabWatchThread();
+        }
+        cache->count = SDL_SlabTakeObjects(size_class, &cache->objects, SDL_SLAB_BATCH);
+        if (!cache->objects) {
+            return NULL;
+        }
+    }
+    object = cache->objects;
+    cache->objects = *(void **)object;
+    --cache->count;
+#else
+    if (!SDL_SlabTakeObjects(size_class, &object, 1)) {
+        return NULL;
+    }
+#endif
+    return object;
+}
+
+static void
+SDL_SlabFree(int size_class, void *object)
+{
+#ifdef SDL_THREAD_LOCAL
+    SDL_SlabCache *cache = &SDL_slab_cache[size_class];
+
+    if (!SDL_slab_cache_watched) {
+        SDL_SlabWatchThread();
+    }
+    *(void **)object = cache->objects;
+    cache->objects = object;
+    if (++cache->count >= 2 * SDL_SLAB_BATCH) {
+        /* Keep the most recently freed (cache-warm) objects, and give the rest back */
+        void *keep;
+        int i;
+
+        keep = cache->objects;
+        for (i = 1; i < SDL_SLAB_BATCH; ++i) {
+            keep = *(void **)keep;
+        }
+        SDL_SlabReturnObjects(size_class, *(void **)keep);
+        *(void **)keep = NULL;
+        cache->count = SDL_SLAB_BATCH;
+    }
+#else
+    *(void **)object = NULL;
+    SDL_SlabReturnObjects(size_class, object);
+#endif
+}
+
+void
+SDL_FlushMemoryCache(void)
+{
+#ifdef SDL_THREAD_LOCAL
+    int i;
+
+    for (i = 0; i < SDL_SLAB_NUM_CLASSES; ++i) {
+        SDL_SlabCache *cache = &SDL_slab_cache[i];
+        if (cache->objects) {
+            SDL_SlabReturnObjects(i, cache->objects);
+            cache->objects = NULL;
+            cache->count = 0;
+        }
+    }
+#endif
+}
+
+static void *
+SDL_slab_malloc(size_t size)
+{
+    if (size <= SDL_SLAB_MAX_SIZE) {
+        void *mem = SDL_SlabAlloc(SDL_SlabClassForSize(size));
+        if (mem) {
+            return mem;
+        }
+    }
+    return real_malloc(size);
+}
+
+static void *
+SDL_slab_calloc(size_t nmemb, size_t size)
+{
+    if (size <= SDL_SLAB_MAX_SIZE && nmemb <= SDL_SLAB_MAX_SIZE / (size ? size : 1)) {
+        const size_t total = nmemb * size;
+        void *mem = SDL_SlabAlloc(SDL_SlabClassForSize(total));
+        if (mem) {
+            return SDL_memset(mem, 0, total);
+        }
+    }
+    return real_calloc(nmemb, size);
+}
+
+static void *
+SDL_slab_realloc(void *ptr, size_t size)
+{
+    const int size_class = ptr ? SDL_SlabClassOf(ptr) : -1;
+    void *mem;
+
+    if (size_class < 0) {
+        return real_realloc(ptr, size);
+    }
+
+    if (size <= SDL_slab_sizes[size_class]) {
+        return ptr;
+    }
+    mem = SDL_slab_malloc(size);
+    if (mem) {
+        SDL_memcpy(mem, ptr, SDL_slab_sizes[size_class]);
+        SDL_SlabFree(size_class, ptr);
+    }
+    return mem;
+}
+
+static void
+SDL_slab_free(void *ptr)
+{
+    int size_class;
+
+    if (!ptr) {
+        return;
+    }
+
+    size_class = SDL_SlabClassOf(ptr);
+    if (size_class < 0) {
+        real_free(ptr);
+    } else {
+        SDL_SlabFree(size_class, ptr);
+    }
+}
+
+#define default_malloc SDL_slab_malloc
+#define default_calloc SDL_slab_calloc
+#define default_realloc SDL_slab_realloc
+#define default_free SDL_slab_free
+
+#else
+
+void
+SDL_FlushMemoryCache(void)
+{
+}
+
+#define default_malloc real_malloc
+#define default_calloc real_calloc
+#define default_realloc real_realloc
+#define default_free real_free
+
+#endif /* SDL_MALLOC_SLAB */
+
 /* Memory functions used by SDL that can be replaced by the application */
 static struct
 {
@@ -5324,7 +5950,7 @@ static struct
     SDL_free_func free_func;
     SDL_atomic_t num_allocations;
 } s_mem = {
-    real_malloc, real_calloc, real_realloc, real_free, { 0 }
+    default_malloc, default_calloc, default_realloc, default_free, { 0 }
 };
 
 void SDL_GetMemoryFunctions(SDL_malloc_func *malloc_func,
@@ -5376,6 +6002,320 @@ int SDL_GetNumAllocations(void)
     return SDL_AtomicGet(&s_mem.num_allocations);
 }
 
+static const char *SDL_memory_tag_names[SDL_NUM_MEMORY_TAGS] = {
+    "app", "stdlib", "video", "render", "audio", "events", "joystick"
+};
+
+const char *SDL_GetMemoryTagName(SDL_MemoryTag tag)
+{
+    if ((unsigned int)tag >= SDL_NUM_MEMORY_TAGS) {
+        return NULL;
+    }
+    return SDL_memory_tag_names[tag];
+}
+
+#if SDL_MEMORY_ACCOUNTING
+
+/* Each block starts with a header recording its size and tag, which keeps
+   the block 16 byte aligned.  Every block handed out by SDL_malloc() and the
+   tagged functions has one, so SDL_free() and SDL_TaggedFree() can step back
+   to it without checking. */
+typedef union
+{
+    struct
+    {
+        size_t size;
+        Uint32 tag;
+    } info;
+    Uint8 padding[SDL_MEMORY_HEADER_SIZE];
+} SDL_MemoryHeader;
+
+SDL_COMPILE_TIME_ASSERT(memory_header, sizeof(SDL_MemoryHeader) == SDL_MEMORY_HEADER_SIZE);
+
+#define SDL_MEMORY_MAX_SIZE (~(size_t)0 - sizeof(SDL_MemoryHeader))
+
+/* The counters are ints so they can be updated atomically everywhere, which
+   limits the live and peak bytes of a tag to 2 GB. */
+typedef struct
+{
+    SDL_atomic_t live_bytes;
+    SDL_atomic_t peak_bytes;
+    SDL_atomic_t live_allocations;
+    SDL_atomic_t total_allocations;
+    SDL_atomic_t histogram[SDL_MEMORY_HISTOGRAM_BUCKETS];
+} SDL_MemoryCounters;
+
+static SDL_MemoryCounters SDL_memory_counters[SDL_NUM_MEMORY_TAGS];
+
+static int SDL_MemoryBucket(size_t size)
+{
+    size_t limit = 16;
+    int bucket = 0;
+
+    while (size > limit && bucket < SDL_MEMORY_HISTOGRAM_BUCKETS - 1) {
+        limit <<= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+static void SDL_AccountAllocation(SDL_MemoryTag tag, size_t size)
+{
+    SDL_MemoryCounters *counters = &SDL_memory_counters[tag];
+    const int live = SDL_AtomicAdd(&counters->live_bytes, (int)size) + (int)size;
+    int peak;
+
+    SDL_AtomicIncRef(&counters->live_allocations);
+    SDL_AtomicIncRef(&counters->histogram[SDL_MemoryBucket(size)]);
+
+    do {
+        peak = SDL_AtomicGet(&counters->peak_bytes);
+        if (live <= peak) {
+            break;
+        }
+    } while (!SDL_AtomicCAS(&counters->peak_bytes, peak, live));
+}
+
+static void SDL_AccountFree(SDL_MemoryTag tag, size_t size)
+{
+    SDL_MemoryCounters *counters = &SDL_memory_counters[tag];
+
+    SDL_AtomicAdd(&counters->live_bytes, -(int)size);
+    (void)SDL_AtomicDecRef(&counters->live_allocations);
+    (void)SDL_AtomicDecRef(&counters->histogram[SDL_MemoryBucket(size)]);
+}
+
+/* Fill in the header of a new block and return the memory after it */
+static void *SDL_TagMemory(void *block, size_t size, SDL_MemoryTag tag)
+{
+    SDL_MemoryHeader *header = (SDL_MemoryHeader *)block;
+
+    if ((unsigned int)tag >= SDL_NUM_MEMORY_TAGS) {
+        tag = SDL_MEMORY_TAG_STDLIB;
+    }
+    header->info.size = size;
+    header->info.tag = tag;
+
+    SDL_AtomicIncRef(&s_mem.num_allocations);
+    SDL_AtomicIncRef(&SDL_memory_counters[tag].total_allocations);
+    SDL_AccountAllocation(tag, size);
+    return header + 1;
+}
+
+static SDL_MemoryHeader *SDL_GetMemoryHeader(void *ptr)
+{
+    return (SDL_MemoryHeader *)ptr - 1;
+}
+
+void *SDL_TaggedMalloc(size_t size, SDL_MemoryTag tag)
+{
+    void *mem;
+
+    if (!size) {
+        size = 1;
+    }
+    if (size > SDL_MEMORY_MAX_SIZE) {
+        return NULL;
+    }
+
+    mem = s_mem.malloc_func(sizeof(SDL_MemoryHeader) + size);
+    if (!mem) {
+        return NULL;
+    }
+    return SDL_TagMemory(mem, size, tag);
+}
+
+void *SDL_TaggedCalloc(size_t nmemb, size_t size, SDL_MemoryTag tag)
+{
+    void *mem;
+
+    if (!nmemb || !size) {
+        nmemb = 1;
+        size = 1;
+    }
+    if (size > SDL_MEMORY_MAX_SIZE / nmemb) {
+        return NULL;
+    }
+    size *= nmemb;
+
+    mem = s_mem.calloc_func(1, sizeof(SDL_MemoryHeader) + size);
+    if (!mem) {
+        return NULL;
+    }
+    return SDL_TagMemory(mem, size, tag);
+}
+
+void *SDL_TaggedRealloc(void *ptr, size_t size, SDL_MemoryTag tag)
+{
+    SDL_MemoryHeader *header;
+    size_t old_size;
+
+    if (!ptr) {
+        return SDL_TaggedMalloc(size, tag);
+    }
+
+    if (size > SDL_MEMORY_MAX_SIZE) {
+        return NULL;
+    }
+
+    /* The block keeps the tag it was first allocated with */
+    header = SDL_GetMemoryHeader(ptr);
+    old_size = header->info.size;
+    header = (SDL_MemoryHeader *)s_mem.realloc_func(header, sizeof(SDL_MemoryHeader) + size);
+    if (!header) {
+        return NULL;
+    }
+    header->info.size = size;
+    SDL_AccountFree((SDL_MemoryTag)header->info.tag, old_size);
+    SDL_AccountAllocation((SDL_MemoryTag)header->info.tag, size);
+    return header + 1;
+}
+
+int SDL_GetMemoryStats(SDL_MemoryTag tag, SDL_MemoryStats *stats)
+{
+    SDL_MemoryCounters *counters;
+    int i;
+
+    if ((unsigned int)tag >= SDL_NUM_MEMORY_TAGS) {
+        return SDL_InvalidParamError("tag");
+    }
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    counters = &SDL_memory_counters[tag];
+    stats->live_bytes = (size_t)SDL_max(SDL_AtomicGet(&counters->live_bytes), 0);
+    stats->peak_bytes = (size_t)SDL_AtomicGet(&counters->peak_bytes);
+    stats->live_allocations = SDL_AtomicGet(&counters->live_allocations);
+    stats->total_allocations = SDL_AtomicGet(&counters->total_allocations);
+    for (i = 0; i < SDL_MEMORY_HISTOGRAM_BUCKETS; ++i) {
+        stats->histogram[i] = SDL_AtomicGet(&counters->histogram[i]);
+    }
+    return 0;
+}
+
+static int SDL_WriteMemoryStats(SDL_RWops *dst, const char *fmt, ...)
+{
+    char line[128];
+    va_list ap;
+    int len;
+
+    va_start(ap, fmt);
+    len = SDL_vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+    len = SDL_min(len, (int)sizeof(line) - 1);
+
+    if (SDL_RWwrite(dst, line, 1, len) != (size_t)len) {
+        return -1;
+    }
+    return 0;
+}
+
+int SDL_DumpMemoryStats(SDL_RWops *dst)
+{
+    SDL_MemoryStats stats;
+    int tag, i;
+
+    if (!dst) {
+        return SDL_InvalidParamError("dst");
+    }
+
+    if (SDL_WriteMemoryStats(dst, "%-10s %12s %12s %10s %12s\n",
+                             "tag", "live bytes", "peak bytes", "blocks", "allocations") < 0) {
+        return -1;
+    }
+    for (tag = 0; tag < SDL_NUM_MEMORY_TAGS; ++tag) {
+        SDL_GetMemoryStats((SDL_MemoryTag)tag, &stats);
+        if (SDL_WriteMemoryStats(dst, "%-10s %12u %12u %10d %12d\n",
+                                 SDL_GetMemoryTagName((SDL_MemoryTag)tag),
+                                 (unsigned int)stats.live_bytes,
+                                 (unsigned int)stats.peak_bytes,
+                                 stats.live_allocations,
+                                 stats.total_allocations) < 0) {
+            return -1;
+        }
+    }
+
+    /* Live blocks by size, one row per tag */
+    if (SDL_WriteMemoryStats(dst, "\n%-10s", "size <=") < 0) {
+        return -1;
+    }
+    for (i = 0; i < SDL_MEMORY_HISTOGRAM_BUCKETS - 1; ++i) {
+        const unsigned int limit = 16u << i;
+        if (limit >= 1024) {
+            if (SDL_WriteMemoryStats(dst, " %5uK", limit / 1024) < 0) {
+                return -1;
+            }
+        } else if (SDL_WriteMemoryStats(dst, " %6u", limit) < 0) {
+            return -1;
+        }
+    }
+    if (SDL_WriteMemoryStats(dst, " %6s\n", "more") < 0) {
+        return -1;
+    }
+    for (tag = 0; tag < SDL_NUM_MEMORY_TAGS; ++tag) {
+        SDL_GetMemoryStats((SDL_MemoryTag)tag, &stats);
+        if (SDL_WriteMemoryStats(dst, "%-10s", SDL_GetMemoryTagName((SDL_MemoryTag)tag)) < 0) {
+            return -1;
+        }
+        for (i = 0; i < SDL_MEMORY_HISTOGRAM_BUCKETS; ++i) {
+            if (SDL_WriteMemoryStats(dst, " %6d", stats.histogram[i]) < 0) {
+                return -1;
+            }
+        }
+        if (SDL_WriteMemoryStats(dst, "\n") < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void *SDL_malloc(size_t size)
+{
+    return SDL_TaggedMalloc(size, SDL_MEMORY_TAG_APP);
+}
+
+void *SDL_calloc(size_t nmemb, size_t size)
+{
+    return SDL_TaggedCalloc(nmemb, size, SDL_MEMORY_TAG_APP);
+}
+
+void *SDL_realloc(void *ptr, size_t size)
+{
+    return SDL_TaggedRealloc(ptr, size, SDL_MEMORY_TAG_APP);
+}
+
+void SDLCALL SDL_TaggedFree(void *ptr)
+{
+    SDL_MemoryHeader *header;
+
+    if (!ptr) {
+        return;
+    }
+
+    header = SDL_GetMemoryHeader(ptr);
+    SDL_AccountFree((SDL_MemoryTag)header->info.tag, header->info.size);
+    s_mem.free_func(header);
+    (void)SDL_AtomicDecRef(&s_mem.num_allocations);
+}
+
+void SDL_free(void *ptr)
+{
+    SDL_TaggedFree(ptr);
+}
+
+#else
+
+int SDL_GetMemoryStats(SDL_MemoryTag tag, SDL_MemoryStats *stats)
+{
+    return SDL_Unsupported();
+}
+
+int SDL_DumpMemoryStats(SDL_RWops *dst)
+{
+    return SDL_Unsupported();
+}
+
 void *SDL_malloc(size_t size)
 {
     void *mem;
@@ -5432,4 +6372,6 @@ void SDL_free(void *ptr)
     (void)SDL_AtomicDecRef(&s_mem.num_allocations);
 }
 
+#endif /* SDL_MEMORY_ACCOUNTING */
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -26,7 +26,35 @@
 
 /* This file contains portable string manipulation functions for SDL */
 
+/* On x86, copies and fills that are big enough to pay for the setup use
+   SSE, or string instructions on 32-bit CPUs, and the ones bigger than the
+   cache use non-temporal stores so they don't evict everything else.
+
+   This is only worth it where the C library versions are basic, desktop C
+   libraries already pick a tuned version for the CPU at runtime.
+ */
+#ifndef SDL_MEMCPY_TUNED
+#ifndef HAVE_MEMCPY
+#define SDL_MEMCPY_TUNED 1
+#else
+#define SDL_MEMCPY_TUNED 0
+#endif
+#endif
+
+/* This has to be decided before SDL_cpuinfo.h is included: it hides
+   __SSE__ from clang targeting MSVC, which is how nxdk builds for the
+   Xbox.  MSVC itself has the SSE intrinsics whatever the target CPU. */
+#if SDL_MEMCPY_TUNED && (defined(__SSE__) || (defined(_MSC_VER) && !defined(__clang__))) && \
+    (defined(i386) || defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64))
+#define SDL_MEMCPY_X86
+#if defined(i386) || defined(__i386__) || defined(_M_IX86)
+#define SDL_MEMCPY_STRING_OPS
+#endif
+#include <xmmintrin.h>
+#endif
+
 #include "SDL_stdinc.h"
+#include "SDL_cpuinfo.h"
 
 #if !defined(HAVE_VSSCANF) || !defined(HAVE_STRTOL) || !defined(HAVE_STRTOUL)  || !defined(HAVE_STRTOLL) || !defined(HAVE_STRTOULL) || !defined(HAVE_STRTOD)
 #define SDL_isupperhex(X)   (((X) >= 'A') && ((X) <= 'F'))
@@ -262,9 +290,227 @@ SDL_ScanFloat(const char *text, double *valuep)
 }
 #endif
 
+#ifdef SDL_MEMCPY_X86
+#define SDL_MEMCPY_STRING_SIZE  256
+#define SDL_MEMCPY_SSE_SIZE     4096
+#ifndef SDL_MEMCPY_STREAM_SIZE
+#define SDL_MEMCPY_STREAM_SIZE  (256 * 1024)
+#endif
+
+#ifdef SDL_MEMCPY_STRING_OPS
+#define SDL_MEMCPY_MIN_SIZE     SDL_MEMCPY_STRING_SIZE
+#else
+#define SDL_MEMCPY_MIN_SIZE     SDL_MEMCPY_SSE_SIZE
+#endif
+
+#ifdef SDL_MEMCPY_STRING_OPS
+static int SDL_memcpy_sse = -1;
+
+static SDL_bool
+SDL_MemcpyHasSSE(void)
+{
+    if (SDL_memcpy_sse < 0) {
+        /* In case detecting the CPU copies memory */
+        SDL_memcpy_sse = 0;
+        SDL_memcpy_sse = SDL_HasSSE() ? 1 : 0;
+    }
+    return SDL_memcpy_sse ? SDL_TRUE : SDL_FALSE;
+}
+#else
+/* Every 64-bit x86 CPU has SSE */
+#define SDL_MemcpyHasSSE()  SDL_TRUE
+#endif
+
+/* Copy 64 byte blocks to a 16 byte aligned destination */
+SDL_FORCE_INLINE void
+SDL_memcpySSEBlocks(Uint8 *dst, const Uint8 *src, size_t blocks, const SDL_bool aligned, const SDL_bool stream)
+{
+    __m128 values[4];
+
+    while (blocks--) {
+        if (stream) {
+            _mm_prefetch((const char *)src + 512, _MM_HINT_NTA);
+        }
+        if (aligned) {
+            values[0] = _mm_load_ps((const float *)(src + 0));
+            values[1] = _mm_load_ps((const float *)(src + 16));
+            values[2] = _mm_load_ps((const float *)(src + 32));
+            values[3] = _mm_load_ps((const float *)(src + 48));
+        } else {
+            values[0] = _mm_loadu_ps((const float *)(src + 0));
+            values[1] = _mm_loadu_ps((const float *)(src + 16));
+            values[2] = _mm_loadu_ps((const float *)(src + 32));
+            values[3] = _mm_loadu_ps((const float *)(src + 48));
+        }
+        if (stream) {
+            _mm_stream_ps((float *)(dst + 0), values[0]);
+            _mm_stream_ps((float *)(dst + 16), values[1]);
+            _mm_stream_ps((float *)(dst + 32), values[2]);
+            _mm_stream_ps((float *)(dst + 48), values[3]);
+        } else {
+            _mm_store_ps((float *)(dst + 0), values[0]);
+            _mm_store_ps((float *)(dst + 16), values[1]);
+            _mm_store_ps((float *)(dst + 32), values[2]);
+            _mm_store_ps((float *)(dst + 48), values[3]);
+        }
+        src += 64;
+        dst += 64;
+    }
+}
+
+/* Fill 64 byte blocks at a 16 byte aligned destination */
+SDL_FORCE_INLINE void
+SDL_memsetSSEBlocks(Uint8 *dst, __m128 value, size_t blocks, const SDL_bool stream)
+{
+    while (blocks--) {
+        if (stream) {
+            _mm_stream_ps((float *)(dst + 0), value);
+            _mm_stream_ps((float *)(dst + 16), value);
+            _mm_stream_ps((float *)(dst + 32), value);
+            _mm_stream_ps((float *)(dst + 48), value);
+        } else {
+            _mm_store_ps((float *)(dst + 0), value);
+            _mm_store_ps((float *)(dst + 16), value);
+            _mm_store_ps((float *)(dst + 32), value);
+            _mm_store_ps((float *)(dst + 48), value);
+        }
+        dst += 64;
+    }
+}
+
+/* len is at least SDL_MEMCPY_MIN_SIZE */
+static void
+SDL_memcpyX86(Uint8 *dst, const Uint8 *src, size_t len)
+{
+    if (len >= SDL_MEMCPY_SSE_SIZE && SDL_MemcpyHasSSE()) {
+        const size_t head = (16 - ((uintptr_t)dst & 15)) & 15;
+        size_t blocks;
+
+        if (head) {
+            SDL_memcpy(dst, src, head);
+            dst += head;
+            src += head;
+            len -= head;
+        }
+
+        blocks = len / 64;
+        if (len >= SDL_MEMCPY_STREAM_SIZE) {
+            if ((uintptr_t)src & 15) {
+                SDL_memcpySSEBlocks(dst, src, blocks, SDL_FALSE, SDL_TRUE);
+            } else {
+                SDL_memcpySSEBlocks(dst, src, blocks, SDL_TRUE, SDL_TRUE);
+            }
+            _mm_sfence();
+        } else {
+            if ((uintptr_t)src & 15) {
+                SDL_memcpySSEBlocks(dst, src, blocks, SDL_FALSE, SDL_FALSE);
+            } else {
+                SDL_memcpySSEBlocks(dst, src, blocks, SDL_TRUE, SDL_FALSE);
+            }
+        }
+        dst += blocks * 64;
+        src += blocks * 64;
+        len -= blocks * 64;
+
+        if (len) {
+            SDL_memcpy(dst, src, len);
+        }
+        return;
+    }
+
+#ifdef SDL_MEMCPY_STRING_OPS
+    {
+        size_t dwords;
+
+        /* Line up the destination, the source may stay unaligned */
+        while ((uintptr_t)dst & 3) {
+            *dst++ = *src++;
+            --len;
+        }
+        dwords = len / 4;
+        len &= 3;
+#if defined(__GNUC__) || defined(__clang__)
+        __asm__ __volatile__ (
+            "cld \n\t"
+            "rep ; movsl \n\t"
+            : "+D" (dst), "+S" (src), "+c" (dwords)
+            :
+            : "memory"
+        );
+#else
+        __movsd((unsigned long *)dst, (const unsigned long *)src, dwords);
+        dst += dwords * 4;
+        src += dwords * 4;
+#endif
+        while (len--) {
+            *dst++ = *src++;
+        }
+    }
+#endif /* SDL_MEMCPY_STRING_OPS */
+}
+
+/* len is at least SDL_MEMCPY_MIN_SIZE */
+static void
+SDL_memsetX86(Uint8 *dst, Uint8 value1, size_t len)
+{
+    const Uint32 value4 = value1 * 0x01010101u;
+
+    if (len >= SDL_MEMCPY_SSE_SIZE && SDL_MemcpyHasSSE()) {
+        const size_t head = (16 - ((uintptr_t)dst & 15)) & 15;
+        Uint32 pattern[4];
+        __m128 value;
+        size_t blocks;
+
+        /* Go through memory so the pattern isn't treated as a float */
+        pattern[0] = pattern[1] = pattern[2] = pattern[3] = value4;
+        value = _mm_loadu_ps((const float *)pattern);
+
+        if (head) {
+            SDL_memset(dst, value1, head);
+            dst += head;
+            len -= head;
+        }
+
+        blocks = len / 64;
+        if (len >= SDL_MEMCPY_STREAM_SIZE) {
+            SDL_memsetSSEBlocks(dst, value, blocks, SDL_TRUE);
+            _mm_sfence();
+        } else {
+            SDL_memsetSSEBlocks(dst, value, blocks, SDL_FALSE);
+        }
+        dst += blocks * 64;
+        len -= blocks * 64;
+
+        if (len) {
+            SDL_memset(dst, value1, len);
+        }
+        return;
+    }
+
+#ifdef SDL_MEMCPY_STRING_OPS
+    while ((uintptr_t)dst & 3) {
+        *dst++ = value1;
+        --len;
+    }
+    SDL_memset4(dst, value4, len / 4);
+    dst += len & ~(size_t)3;
+    len &= 3;
+    while (len--) {
+        *dst++ = value1;
+    }
+#endif
+}
+#endif /* SDL_MEMCPY_X86 */
+
 void *
 SDL_memset(SDL_OUT_BYTECAP(len) void *dst, int c, size_t len)
 {
+#ifdef SDL_MEMCPY_X86
+    if (len >= SDL_MEMCPY_MIN_SIZE) {
+        SDL_memsetX86((Uint8 *)dst, (Uint8)c, len);
+        return dst;
+    }
+#endif
 #if defined(HAVE_MEMSET)
     return memset(dst, c, len);
 #else
@@ -314,6 +560,12 @@ SDL_memset(SDL_OUT_BYTECAP(len) void *dst, int c, size_t len)
 void *
 SDL_memcpy(SDL_OUT_BYTECAP(len) void *dst, SDL_IN_BYTECAP(len) const void *src, size_t len)
 {
+#ifdef SDL_MEMCPY_X86
+    if (len >= SDL_MEMCPY_MIN_SIZE) {
+        SDL_memcpyX86((Uint8 *)dst, (const Uint8 *)src, len);
+        return dst;
+    }
+#endif
 #ifdef __GNUC__
     /* Presumably this is well tuned for speed.
        On my machine this is twice as fast as the C code below.
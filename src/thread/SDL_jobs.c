@@ -0,0 +1,627 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+/* A small work-stealing job system built on top of SDL threads */
+
+#include "SDL_cpuinfo.h"
+#include "SDL_hints.h"
+#include "SDL_thread.h"
+#include "SDL_timer.h"
+#include "SDL_systhread.h"
+#include "../atomic/SDL_atomic_c.h"
+#include "SDL_jobs_c.h"
+
+/* Keep the pool to a sane size on machines with lots of cores */
+#define SDL_MAX_JOB_WORKERS 32
+
+/* Initial number of jobs each queue can hold, it grows as needed */
+#define SDL_JOB_QUEUE_SIZE  64
+
+typedef struct SDL_Job
+{
+    SDL_AtomicStackNode link;   /* for the freelist */
+    SDL_JobFunction fn;
+    void *data;
+    SDL_JobGroup *group;
+} SDL_Job;
+
+struct SDL_JobGroup
+{
+    SDL_atomic_t pending;   /* jobs submitted but not yet completed */
+    SDL_atomic_t waiters;   /* threads sleeping on the done semaphore */
+    SDL_atomic_t busy;      /* threads still touching the group after completing a job */
+    void *done;             /* SDL_sem, created the first time a waiter needs to sleep */
+};
+
+/* A double-ended job queue.  The owning worker pushes and pops jobs at the
+   tail, so it works on the most recent (and cache-warm) job, while other
+   threads steal the oldest jobs from the head.
+ */
+typedef struct SDL_JobQueue
+{
+    SDL_SpinLock lock;
+    SDL_Job **jobs;
+    int capacity;   /* always a power of two */
+    int head;
+    int count;
+    SDL_Thread *thread;
+
+    /* Padding to keep each queue on its own cache line */
+    char cache_pad[SDL_CACHELINE_SIZE];
+} SDL_JobQueue;
+
+typedef struct
+{
+    SDL_SpinLock lock;
+    SDL_bool initialized;
+    int num_workers;
+    SDL_JobQueue *queues;   /* one per worker, plus one for other threads */
+    SDL_TLSID worker_id;
+    SDL_sem *wakeup;
+    SDL_atomic_t queued;
+    SDL_atomic_t sleepers;
+    SDL_atomic_t shutdown;
+
+    SDL_AtomicStack freelist;
+} SDL_JobPool;
+
+static SDL_JobPool SDL_job_pool;
+
+
+static SDL_Job *
+SDL_AllocJob(SDL_JobPool *pool)
+{
+    SDL_Job *job = (SDL_Job *)SDL_AtomicStackPop(&pool->freelist);
+
+    if (!job) {
+        job = (SDL_Job *)SDL_malloc(sizeof(*job));
+        if (!job) {
+            SDL_OutOfMemory();
+        }
+    }
+    return job;
+}
+
+static void
+SDL_FreeJob(SDL_JobPool *pool, SDL_Job *job)
+{
+    SDL_AtomicStackPush(&pool->freelist, &job->link);
+}
+
+static int
+SDL_PushJob(SDL_JobQueue *queue, SDL_Job *job)
+{
+    SDL_AtomicLock(&queue->lock);
+    if (queue->count == queue->capacity) {
+        const int capacity = queue->capacity ? queue->capacity * 2 : SDL_JOB_QUEUE_SIZE;
+        SDL_Job **jobs = (SDL_Job **)SDL_malloc(capacity * sizeof(*jobs));
+        int i;
+
+        if (!jobs) {
+            SDL_AtomicUnlock(&queue->lock);
+            return SDL_OutOfMemory();
+        }
+        for (i = 0; i < queue->count; ++i) {
+            jobs[i] = queue->jobs[(queue->head + i) & (queue->capacity - 1)];
+        }
+        SDL_free(queue->jobs);
+        queue->jobs = jobs;
+        queue->capacity = capacity;
+        queue->head = 0;
+    }
+    queue->jobs[(queue->head + queue->count) & (queue->capacity - 1)] = job;
+    ++queue->count;
+    SDL_AtomicUnlock(&queue->lock);
+    return 0;
+}
+
+static SDL_Job *
+SDL_PopJob(SDL_JobQueue *queue, SDL_bool steal)
+{
+    SDL_Job *job = NULL;
+
+    /* Don't bother taking the lock if there's obviously nothing to do */
+    if (queue->count == 0) {
+        return NULL;
+    }
+
+    SDL_AtomicLock(&queue->lock);
+    if (queue->count > 0) {
+        const int mask = (queue->capacity - 1);
+        if (steal) {
+            job = queue->jobs[queue->head];
+            queue->head = (queue->head + 1) & mask;
+        } else {
+            job = queue->jobs[(queue->head + queue->count - 1) & mask];
+        }
+        --queue->count;
+    }
+    SDL_AtomicUnlock(&queue->lock);
+    return job;
+}
+
+/* Get the next job for a thread, which is either a worker index or -1 */
+static SDL_Job *
+SDL_GetNextJob(SDL_JobPool *pool, int self)
+{
+    const int num_queues = pool->num_workers + 1;
+    SDL_Job *job = NULL;
+    int i, start;
+
+    if (self >= 0) {
+        job = SDL_PopJob(&pool->queues[self], SDL_FALSE);
+        start = self + 1;
+    } else {
+        start = 0;
+    }
+    for (i = 0; !job && i < num_queues; ++i) {
+        const int victim = (start + i) % num_queues;
+        if (victim != self) {
+            job = SDL_PopJob(&pool->queues[victim], SDL_TRUE);
+        }
+    }
+    if (job) {
+        SDL_AtomicAdd(&pool->queued, -1);
+    }
+    return job;
+}
+
+static void
+SDL_CompleteGroupJob(SDL_JobGroup *group)
+{
+    /* The waiting thread may return as soon as pending hits zero, so make
+       it wait for us to finish posting before it tears the group down.
+     */
+    SDL_AtomicIncRef(&group->busy);
+    if (SDL_AtomicDecRef(&group->pending)) {
+        int waiters = SDL_AtomicGet(&group->waiters);
+        while (waiters-- > 0) {
+            SDL_SemPost((SDL_sem *)SDL_AtomicGetPtr(&group->done));
+        }
+    }
+    SDL_AtomicAdd(&group->busy, -1);
+}
+
+static void
+SDL_RunJob(SDL_JobPool *pool, SDL_Job *job)
+{
+    const SDL_JobFunction fn = job->fn;
+    void *data = job->data;
+    SDL_JobGroup *group = job->group;
+
+    SDL_FreeJob(pool, job);
+
+    fn(data);
+
+    if (group) {
+        SDL_CompleteGroupJob(group);
+    }
+}
+
+static void
+SDL_WakeWorker(SDL_JobPool *pool)
+{
+    for ( ; ; ) {
+        const int sleepers = SDL_AtomicGet(&pool->sleepers);
+        if (sleepers <= 0) {
+            return;
+        }
+        if (SDL_AtomicCAS(&pool->sleepers, sleepers, sleepers - 1)) {
+            SDL_SemPost(pool->wakeup);
+            return;
+        }
+    }
+}
+
+static void
+SDL_SleepWorker(SDL_JobPool *pool)
+{
+    SDL_AtomicIncRef(&pool->sleepers);
+
+    if (SDL_AtomicGet(&pool->queued) > 0 || SDL_AtomicGet(&pool->shutdown)) {
+        /* Work showed up while we were getting ready to sleep.  Take ourselves
+           back off the sleeper count, unless a submitter already claimed us,
+           in which case its wakeup is on the way.
+         */
+        for ( ; ; ) {
+            const int sleepers = SDL_AtomicGet(&pool->sleepers);
+            if (sleepers <= 0) {
+                break;
+            }
+            if (SDL_AtomicCAS(&pool->sleepers, sleepers, sleepers - 1)) {
+                return;
+            }
+        }
+    }
+    SDL_SemWait(pool->wakeup);
+}
+
+static int SDLCALL
+SDL_JobWorkerThread(void *data)
+{
+    SDL_JobPool *pool = &SDL_job_pool;
+    SDL_JobQueue *queue = (SDL_JobQueue *)data;
+    const int self = (int)(queue - pool->queues);
+
+    SDL_TLSSet(pool->worker_id, (void *)(uintptr_t)(self + 1), NULL);
+
+    while (!SDL_AtomicGet(&pool->shutdown)) {
+        SDL_Job *job = SDL_GetNextJob(pool, self);
+        if (job) {
+            SDL_RunJob(pool, job);
+        } else {
+            SDL_SleepWorker(pool);
+        }
+    }
+    return 0;
+}
+
+static void
+SDL_StopJobWorkers(SDL_JobPool *pool)
+{
+    int i;
+
+    SDL_AtomicSet(&pool->shutdown, 1);
+    for (i = 0; i < pool->num_workers; ++i) {
+        SDL_SemPost(pool->wakeup);
+    }
+    for (i = 0; i < pool->num_workers; ++i) {
+        SDL_WaitThread(pool->queues[i].thread, NULL);
+    }
+
+    if (pool->queues) {
+        SDL_Job *job;
+
+        /* Finish anything still queued so nobody waits on it forever */
+        while ((job = SDL_GetNextJob(pool, -1)) != NULL) {
+            SDL_RunJob(pool, job);
+        }
+        for (i = 0; i <= pool->num_workers; ++i) {
+            SDL_free(pool->queues[i].jobs);
+        }
+        SDL_free(pool->queues);
+        pool->queues = NULL;
+    }
+    pool->num_workers = 0;
+
+    if (pool->wakeup) {
+        SDL_DestroySemaphore(pool->wakeup);
+        pool->wakeup = NULL;
+    }
+    SDL_AtomicSet(&pool->queued, 0);
+    SDL_AtomicSet(&pool->sleepers, 0);
+    SDL_AtomicSet(&pool->shutdown, 0);
+}
+
+static int
+SDL_GetDefaultJobWorkerCount(void)
+{
+#if SDL_THREADS_DISABLED
+    return 0;
+#else
+    const char *hint = SDL_GetHint(SDL_HINT_JOB_WORKERS);
+    int num_workers;
+
+    if (hint && *hint) {
+        num_workers = SDL_atoi(hint);
+    } else {
+        /* The thread waiting on the jobs helps out, so leave a core for it */
+        num_workers = SDL_GetCPUCount() - 1;
+    }
+    return SDL_max(0, SDL_min(num_workers, SDL_MAX_JOB_WORKERS));
+#endif
+}
+
+static void
+SDL_StartJobWorkers(SDL_JobPool *pool)
+{
+    const int num_workers = SDL_GetDefaultJobWorkerCount();
+    int i;
+
+    if (num_workers == 0) {
+        return;
+    }
+
+    if (!pool->worker_id) {
+        pool->worker_id = SDL_TLSCreate();
+    }
+    pool->wakeup = SDL_CreateSemaphore(0);
+    pool->queues = (SDL_JobQueue *)SDL_calloc(num_workers + 1, sizeof(*pool->queues));
+    if (!pool->worker_id || !pool->wakeup || !pool->queues) {
+        /* We'll just run jobs on the calling thread */
+        SDL_StopJobWorkers(pool);
+        return;
+    }
+
+    /* The workers read the queue array as soon as they start */
+    pool->num_workers = num_workers;
+    for (i = 0; i < num_workers; ++i) {
+        char name[16];
+        SDL_snprintf(name, sizeof(name), "SDLJobs%d", i);
+        pool->queues[i].thread = SDL_CreateThreadInternal(SDL_JobWorkerThread, name, 0, &pool->queues[i]);
+        if (!pool->queues[i].thread) {
+            pool->num_workers = i;
+            SDL_StopJobWorkers(pool);
+            return;
+        }
+    }
+}
+
+static SDL_JobPool *
+SDL_GetJobPool(void)
+{
+    SDL_JobPool *pool = &SDL_job_pool;
+
+    if (!pool->initialized) {
+        SDL_AtomicLock(&pool->lock);
+        if (!pool->initialized) {
+            SDL_StartJobWorkers(pool);
+            SDL_MemoryBarrierRelease();
+            pool->initialized = SDL_TRUE;
+        }
+        SDL_AtomicUnlock(&pool->lock);
+    }
+    SDL_MemoryBarrierAcquire();
+    return pool;
+}
+
+/* Returns the worker index of the current thread, or -1 for other threads */
+static int
+SDL_GetJobWorkerIndex(SDL_JobPool *pool)
+{
+    if (pool->num_workers == 0) {
+        return -1;
+    }
+    return (int)(uintptr_t)SDL_TLSGet(pool->worker_id) - 1;
+}
+
+static void
+SDL_InitJobGroup(SDL_JobGroup *group)
+{
+    SDL_zerop(group);
+}
+
+static void
+SDL_CleanupJobGroup(SDL_JobGroup *group)
+{
+    if (group->done) {
+        SDL_DestroySemaphore((SDL_sem *)group->done);
+        group->done = NULL;
+    }
+}
+
+int
+SDL_GetJobWorkerCount(void)
+{
+    return SDL_GetJobPool()->num_workers;
+}
+
+SDL_JobGroup *
+SDL_CreateJobGroup(void)
+{
+    SDL_JobGroup *group = (SDL_JobGroup *)SDL_malloc(sizeof(*group));
+    if (!group) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    SDL_InitJobGroup(group);
+    return group;
+}
+
+int
+SDL_SubmitJob(SDL_JobGroup *group, SDL_JobFunction fn, void *data)
+{
+    SDL_JobPool *pool;
+    SDL_Job *job;
+    int self;
+
+    if (!fn) {
+        return SDL_InvalidParamError("fn");
+    }
+
+    pool = SDL_GetJobPool();
+    if (pool->num_workers == 0) {
+        fn(data);
+        return 0;
+    }
+
+    job = SDL_AllocJob(pool);
+    if (!job) {
+        return -1;
+    }
+    job->fn = fn;
+    job->data = data;
+    job->group = group;
+
+    if (group) {
+        SDL_AtomicIncRef(&group->pending);
+    }
+
+    self = SDL_GetJobWorkerIndex(pool);
+    if (SDL_PushJob(&pool->queues[(self >= 0) ? self : pool->num_workers], job) < 0) {
+        if (group) {
+            SDL_AtomicAdd(&group->pending, -1);
+        }
+        SDL_FreeJob(pool, job);
+        return -1;
+    }
+    SDL_AtomicIncRef(&pool->queued);
+    SDL_WakeWorker(pool);
+    return 0;
+}
+
+int
+SDL_WaitJobGroup(SDL_JobGroup *group)
+{
+    SDL_JobPool *pool;
+    int self;
+
+    if (!group) {
+        return SDL_InvalidParamError("group");
+    }
+
+    pool = SDL_GetJobPool();
+    self = SDL_GetJobWorkerIndex(pool);
+    while (SDL_AtomicGet(&group->pending) > 0) {
+        SDL_Job *job;
+        SDL_sem *done;
+
+        /* Help out while we wait */
+        job = (pool->num_workers > 0) ? SDL_GetNextJob(pool, self) : NULL;
+        if (job) {
+            SDL_RunJob(pool, job);
+            continue;
+        }
+
+        /* Nothing left in the queues, the last jobs are running elsewhere */
+        done = (SDL_sem *)SDL_AtomicGetPtr(&group->done);
+        if (!done) {
+            done = SDL_CreateSemaphore(0);
+            if (!done) {
+                return -1;
+            }
+            if (!SDL_AtomicCASPtr(&group->done, NULL, done)) {
+                SDL_DestroySemaphore(done);
+                done = (SDL_sem *)SDL_AtomicGetPtr(&group->done);
+            }
+        }
+        SDL_AtomicIncRef(&group->waiters);
+        if (SDL_AtomicGet(&group->pending) > 0) {
+            SDL_SemWait(done);
+        }
+        SDL_AtomicAdd(&group->waiters, -1);
+    }
+
+    while (SDL_AtomicGet(&group->busy) > 0) {
+        SDL_Delay(0);
+    }
+    return 0;
+}
+
+void
+SDL_DestroyJobGroup(SDL_JobGroup *group)
+{
+    if (group) {
+        SDL_WaitJobGroup(group);
+        SDL_CleanupJobGroup(group);
+        SDL_free(group);
+    }
+}
+
+typedef struct
+{
+    SDL_ParallelForFunction fn;
+    void *data;
+    int start;
+    int end;
+    int grainsize;
+    int num_chunks;
+    SDL_atomic_t next_chunk;
+} SDL_ParallelForData;
+
+/* Every thread taking part claims chunks until there are none left, so a
+   slow chunk on one thread doesn't hold up the rest of the range.
+ */
+static void SDLCALL
+SDL_ParallelForJob(void *data)
+{
+    SDL_ParallelForData *pf = (SDL_ParallelForData *)data;
+
+    for ( ; ; ) {
+        const int chunk = SDL_AtomicAdd(&pf->next_chunk, 1);
+        int start;
+
+        if (chunk >= pf->num_chunks) {
+            break;
+        }
+        start = pf->start + chunk * pf->grainsize;
+        pf->fn(pf->data, start, SDL_min(start + pf->grainsize, pf->end));
+    }
+}
+
+int
+SDL_ParallelFor(int start, int end, int grainsize, SDL_ParallelForFunction fn, void *data)
+{
+    SDL_ParallelForData pf;
+    SDL_JobGroup group;
+    int num_workers, i;
+
+    if (!fn) {
+        return SDL_InvalidParamError("fn");
+    }
+    if (end <= start) {
+        return 0;
+    }
+
+    num_workers = SDL_GetJobWorkerCount();
+    if (grainsize <= 0) {
+        /* A few chunks per thread balances uneven work reasonably well */
+        grainsize = SDL_max(1, (end - start) / ((num_workers + 1) * 4));
+    }
+
+    pf.fn = fn;
+    pf.data = data;
+    pf.start = start;
+    pf.end = end;
+    pf.grainsize = grainsize;
+    pf.num_chunks = ((end - start) - 1) / grainsize + 1;
+    SDL_AtomicSet(&pf.next_chunk, 0);
+
+    if (num_workers == 0 || pf.num_chunks == 1) {
+        fn(data, start, end);
+        return 0;
+    }
+
+    SDL_InitJobGroup(&group);
+    for (i = SDL_min(num_workers, pf.num_chunks - 1); i > 0; --i) {
+        if (SDL_SubmitJob(&group, SDL_ParallelForJob, &pf) < 0) {
+            break;  /* That's okay, we'll just do more of the work here */
+        }
+    }
+    SDL_ParallelForJob(&pf);
+    SDL_WaitJobGroup(&group);
+    SDL_CleanupJobGroup(&group);
+    return 0;
+}
+
+void
+SDL_JobsQuit(void)
+{
+    SDL_JobPool *pool = &SDL_job_pool;
+
+    SDL_AtomicLock(&pool->lock);
+    if (pool->initialized) {
+        SDL_AtomicStackNode *node;
+
+        SDL_StopJobWorkers(pool);
+        node = SDL_AtomicStackPopAll(&pool->freelist);
+        while (node) {
+            SDL_Job *job = (SDL_Job *)node;
+            node = node->next;
+            SDL_free(job);
+        }
+        pool->initialized = SDL_FALSE;
+    }
+    SDL_AtomicUnlock(&pool->lock);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
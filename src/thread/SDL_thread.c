@@ -28,6 +28,7 @@
 #include "SDL_systhread.h"
 #include "SDL_hints.h"
 #include "../SDL_error_c.h"
+#include "../stdlib/SDL_malloc_c.h"
 
 
 SDL_TLSID
@@ -37,12 +38,40 @@ SDL_TLSCreate()
     return SDL_AtomicIncRef(&SDL_tls_id)+1;
 }
 
+#ifdef SDL_THREAD_LOCAL
+/* The compiler gives us real thread-local variables, so we don't need any
+   help from the thread backend to find this thread's storage.
+ */
+static SDL_THREAD_LOCAL SDL_TLSData *SDL_tls_data;
+#endif
+
+static SDL_INLINE SDL_TLSData *
+SDL_GetTLSData(void)
+{
+#ifdef SDL_THREAD_LOCAL
+    return SDL_tls_data;
+#else
+    return SDL_SYS_GetTLSData();
+#endif
+}
+
+static SDL_INLINE int
+SDL_SetTLSData(SDL_TLSData *data)
+{
+#ifdef SDL_THREAD_LOCAL
+    SDL_tls_data = data;
+    return 0;
+#else
+    return SDL_SYS_SetTLSData(data);
+#endif
+}
+
 void *
 SDL_TLSGet(SDL_TLSID id)
 {
     SDL_TLSData *storage;
 
-    storage = SDL_SYS_GetTLSData();
+    storage = SDL_GetTLSData();
     if (!storage || id == 0 || id > storage->limit) {
         return NULL;
     }
@@ -58,7 +87,7 @@ SDL_TLSSet(SDL_TLSID id, const void *value, void (SDLCALL *destructor)(void *))
         return SDL_InvalidParamError("id");
     }
 
-    storage = SDL_SYS_GetTLSData();
+    storage = SDL_GetTLSData();
     if (!storage || (id > storage->limit)) {
         unsigned int i, oldlimit, newlimit;
 
@@ -73,7 +102,7 @@ SDL_TLSSet(SDL_TLSID id, const void *value, void (SDLCALL *destructor)(void *))
             storage->array[i].data = NULL;
             storage->array[i].destructor = NULL;
         }
-        if (SDL_SYS_SetTLSData(storage) != 0) {
+        if (SDL_SetTLSData(storage) != 0) {
             return -1;
         }
     }
@@ -88,7 +117,7 @@ SDL_TLSCleanup()
 {
     SDL_TLSData *storage;
 
-    storage = SDL_SYS_GetTLSData();
+    storage = SDL_GetTLSData();
     if (storage) {
         unsigned int i;
         for (i = 0; i < storage->limit; ++i) {
@@ -96,7 +125,7 @@ SDL_TLSCleanup()
                 storage->array[i].destructor(storage->array[i].data);
             }
         }
-        SDL_SYS_SetTLSData(NULL);
+        SDL_SetTLSData(NULL);
         SDL_free(storage);
     }
 }
@@ -105,28 +134,88 @@ SDL_TLSCleanup()
 /* This is a generic implementation of thread-local storage which doesn't
    require additional OS support.
 
-   It is not especially efficient and doesn't clean up thread-local storage
-   as threads exit.  If there is a real OS that doesn't support thread-local
+   Threads are kept in a fixed size open-addressed hash table keyed by thread
+   ID.  Slots are claimed with a compare-and-swap and are never released, so
+   lookups can walk the table without taking a lock.  A thread that leaves
+   its slot keeps it, which is fine since thread IDs are reused.
+
+   If the table fills up, the remaining threads go in a linked list that is
+   protected by a mutex.  This doesn't clean up thread-local storage as
+   threads exit, if there is a real OS that doesn't support thread-local
    storage this implementation should be improved to be production quality.
 */
 
+#define SDL_GENERIC_TLS_SLOTS   256     /* must be a power of two */
+
+enum
+{
+    SDL_GENERIC_TLS_EMPTY,
+    SDL_GENERIC_TLS_CLAIMING,
+    SDL_GENERIC_TLS_READY
+};
+
+typedef struct SDL_TLSSlot {
+    SDL_atomic_t state;
+    SDL_threadID thread;
+    void *storage;
+} SDL_TLSSlot;
+
 typedef struct SDL_TLSEntry {
     SDL_threadID thread;
     SDL_TLSData *storage;
     struct SDL_TLSEntry *next;
 } SDL_TLSEntry;
 
+static SDL_TLSSlot SDL_generic_TLS_slots[SDL_GENERIC_TLS_SLOTS];
+static SDL_atomic_t SDL_generic_TLS_overflow;
 static SDL_mutex *SDL_generic_TLS_mutex;
 static SDL_TLSEntry *SDL_generic_TLS;
 
 
-SDL_TLSData *
-SDL_Generic_GetTLSData(void)
+static Uint32
+SDL_Generic_HashThreadID(SDL_threadID thread)
 {
-    SDL_threadID thread = SDL_ThreadID();
-    SDL_TLSEntry *entry;
-    SDL_TLSData *storage = NULL;
+    Uint64 hash = (Uint64)thread;
+    hash ^= (hash >> 32);
+    return ((Uint32)hash * 2654435761u) >> 24;
+}
+
+/* Find this thread's slot in the table, optionally claiming a new one */
+static SDL_TLSSlot *
+SDL_Generic_GetTLSSlot(SDL_threadID thread, SDL_bool create)
+{
+    Uint32 index = SDL_Generic_HashThreadID(thread);
+    int probe;
 
+    for (probe = 0; probe < SDL_GENERIC_TLS_SLOTS; ++probe) {
+        SDL_TLSSlot *slot = &SDL_generic_TLS_slots[index];
+        int state = SDL_AtomicGet(&slot->state);
+
+        if (state == SDL_GENERIC_TLS_EMPTY) {
+            if (!create) {
+                return NULL;
+            }
+            if (SDL_AtomicCAS(&slot->state, SDL_GENERIC_TLS_EMPTY, SDL_GENERIC_TLS_CLAIMING)) {
+                slot->thread = thread;
+                SDL_AtomicSetPtr(&slot->storage, NULL);
+                SDL_AtomicSet(&slot->state, SDL_GENERIC_TLS_READY);
+                return slot;
+            }
+            /* Somebody else got it first, see what they put there */
+            state = SDL_AtomicGet(&slot->state);
+        }
+        if (state == SDL_GENERIC_TLS_READY && slot->thread == thread) {
+            return slot;
+        }
+        /* Claimed (or being claimed) by another thread, keep looking */
+        index = (index + 1) & (SDL_GENERIC_TLS_SLOTS - 1);
+    }
+    return NULL;
+}
+
+static SDL_bool
+SDL_Generic_CreateTLSMutex(void)
+{
 #if !SDL_THREADS_DISABLED
     if (!SDL_generic_TLS_mutex) {
         static SDL_SpinLock tls_lock;
@@ -137,14 +226,34 @@ SDL_Generic_GetTLSData(void)
             SDL_generic_TLS_mutex = mutex;
             if (!SDL_generic_TLS_mutex) {
                 SDL_AtomicUnlock(&tls_lock);
-                return NULL;
+                return SDL_FALSE;
             }
         }
         SDL_AtomicUnlock(&tls_lock);
     }
 #endif /* SDL_THREADS_DISABLED */
-
     SDL_MemoryBarrierAcquire();
+    return SDL_TRUE;
+}
+
+SDL_TLSData *
+SDL_Generic_GetTLSData(void)
+{
+    SDL_threadID thread = SDL_ThreadID();
+    SDL_TLSSlot *slot;
+    SDL_TLSEntry *entry;
+    SDL_TLSData *storage = NULL;
+
+    slot = SDL_Generic_GetTLSSlot(thread, SDL_FALSE);
+    if (slot) {
+        return (SDL_TLSData *)SDL_AtomicGetPtr(&slot->storage);
+    }
+
+    /* Not in the table, we only need the slow path if it ever overflowed */
+    if (!SDL_AtomicGet(&SDL_generic_TLS_overflow) || !SDL_Generic_CreateTLSMutex()) {
+        return NULL;
+    }
+
     SDL_LockMutex(SDL_generic_TLS_mutex);
     for (entry = SDL_generic_TLS; entry; entry = entry->next) {
         if (entry->thread == thread) {
@@ -163,9 +272,23 @@ int
 SDL_Generic_SetTLSData(SDL_TLSData *storage)
 {
     SDL_threadID thread = SDL_ThreadID();
+    SDL_TLSSlot *slot;
     SDL_TLSEntry *prev, *entry;
 
-    /* SDL_Generic_GetTLSData() is always called first, so we can assume SDL_generic_TLS_mutex */
+    slot = SDL_Generic_GetTLSSlot(thread, storage ? SDL_TRUE : SDL_FALSE);
+    if (slot) {
+        SDL_AtomicSetPtr(&slot->storage, storage);
+        return 0;
+    }
+    if (!storage && !SDL_AtomicGet(&SDL_generic_TLS_overflow)) {
+        return 0;
+    }
+
+    if (!SDL_Generic_CreateTLSMutex()) {
+        return -1;
+    }
+    SDL_AtomicSet(&SDL_generic_TLS_overflow, 1);
+
     SDL_LockMutex(SDL_generic_TLS_mutex);
     prev = NULL;
     for (entry = SDL_generic_TLS; entry; entry = entry->next) {
@@ -184,7 +307,7 @@ SDL_Generic_SetTLSData(SDL_TLSData *storage)
         }
         prev = entry;
     }
-    if (!entry) {
+    if (!entry && storage) {
         entry = (SDL_TLSEntry *)SDL_malloc(sizeof(*entry));
         if (entry) {
             entry->thread = thread;
@@ -195,7 +318,7 @@ SDL_Generic_SetTLSData(SDL_TLSData *storage)
     }
     SDL_UnlockMutex(SDL_generic_TLS_mutex);
 
-    if (!entry) {
+    if (!entry && storage) {
         return SDL_OutOfMemory();
     }
     return 0;
@@ -295,6 +418,9 @@ SDL_RunThread(void *data)
             SDL_free(thread);
         }
     }
+
+    /* Hand back any small allocations this thread freed */
+    SDL_FlushMemoryCache();
 }
 
 #ifdef SDL_CreateThread
@@ -78,13 +78,33 @@ typedef struct {
 /* This is how many TLS entries we allocate at once */
 #define TLS_ALLOC_CHUNKSIZE 4
 
-/* Get cross-platform, slow, thread local storage for this thread.
+/* Compiler support for thread-local variables, used for fast thread-local
+   storage where we trust the toolchain to get it right.  Platforms without
+   it go through the thread backend, or the generic implementation below.
+ */
+#ifndef SDL_THREAD_LOCAL
+#if SDL_THREADS_DISABLED || defined(__XBOX__) || defined(__PSP__) || defined(__EMSCRIPTEN__)
+/* Use the thread backend */
+#elif defined(_MSC_VER)
+#define SDL_THREAD_LOCAL __declspec(thread)
+#elif defined(__APPLE__) && defined(__clang__)
+#if __has_feature(c_thread_local) || __has_extension(c_thread_local)
+#define SDL_THREAD_LOCAL __thread
+#endif
+#elif defined(__GNUC__) && (defined(__linux__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__) || defined(__WIN32__) || defined(__HAIKU__))
+#define SDL_THREAD_LOCAL __thread
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_THREADS__)
+#define SDL_THREAD_LOCAL _Thread_local
+#endif
+#endif /* !SDL_THREAD_LOCAL */
+
+/* Get cross-platform thread local storage for this thread.
    This is only intended as a fallback if getting real thread-local
    storage fails or isn't supported on this platform.
  */
 extern SDL_TLSData *SDL_Generic_GetTLSData(void);
 
-/* Set cross-platform, slow, thread local storage for this thread.
+/* Set cross-platform thread local storage for this thread.
    This is only intended as a fallback if getting real thread-local
    storage fails or isn't supported on this platform.
  */
@@ -24,6 +24,7 @@
 
 #include "SDL_thread.h"
 #include "SDL_systhread_c.h"
+#include "../../atomic/SDL_atomic_c.h"
 
 
 struct SDL_mutex
@@ -89,7 +90,17 @@ SDL_LockMutex(SDL_mutex * mutex)
            We set the locking thread id after we obtain the lock
            so unlocks from other threads will fail.
          */
-        SDL_SemWait(mutex->sem);
+        int backoff = 1;
+
+        /* Spin for a moment in case the owner is about to let go, since
+           waiting on the semaphore usually means a trip into the kernel.
+         */
+        while (SDL_SemTryWait(mutex->sem) != 0) {
+            if (!SDL_ShouldSpin() || !SDL_SpinBackoff(&backoff)) {
+                SDL_SemWait(mutex->sem);
+                break;
+            }
+        }
         mutex->owner = this_thread;
         mutex->recursive = 0;
     }
@@ -120,7 +131,7 @@ SDL_TryLockMutex(SDL_mutex * mutex)
          We set the locking thread id after we obtain the lock
          so unlocks from other threads will fail.
          */
-        retval = SDL_SemWait(mutex->sem);
+        retval = SDL_SemTryWait(mutex->sem);
         if (retval == 0) {
             mutex->owner = this_thread;
             mutex->recursive = 0;
@@ -0,0 +1,232 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+/* An implementation of reader/writer locks using a mutex and semaphores.
+
+   Readers that arrive while a writer holds or is waiting for the lock queue
+   up behind it, and when the writer unlocks they are all let in at once
+   before the next writer gets a turn.  Ownership is handed directly to the
+   threads being woken, so nobody can barge in between the wakeup and the
+   waiter getting to run.
+ */
+
+#include "SDL_thread.h"
+#include "SDL_systhread_c.h"
+
+
+struct SDL_rwlock
+{
+#if !SDL_THREADS_DISABLED
+    SDL_mutex *lock;
+    SDL_sem *read_sem;
+    SDL_sem *write_sem;
+    int readers;
+    SDL_bool writer;
+    int waiting_readers;
+    int waiting_writers;
+#else
+    int unused;
+#endif
+};
+
+/* Create a reader/writer lock */
+SDL_rwlock *
+SDL_CreateRWLock(void)
+{
+    SDL_rwlock *rwlock;
+
+    rwlock = (SDL_rwlock *) SDL_calloc(1, sizeof(*rwlock));
+    if (!rwlock) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+#if !SDL_THREADS_DISABLED
+    rwlock->lock = SDL_CreateMutex();
+    rwlock->read_sem = SDL_CreateSemaphore(0);
+    rwlock->write_sem = SDL_CreateSemaphore(0);
+    if (!rwlock->lock || !rwlock->read_sem || !rwlock->write_sem) {
+        SDL_DestroyRWLock(rwlock);
+        rwlock = NULL;
+    }
+#endif
+    return rwlock;
+}
+
+/* Free the reader/writer lock */
+void
+SDL_DestroyRWLock(SDL_rwlock * rwlock)
+{
+    if (rwlock) {
+#if !SDL_THREADS_DISABLED
+        if (rwlock->write_sem) {
+            SDL_DestroySemaphore(rwlock->write_sem);
+        }
+        if (rwlock->read_sem) {
+            SDL_DestroySemaphore(rwlock->read_sem);
+        }
+        if (rwlock->lock) {
+            SDL_DestroyMutex(rwlock->lock);
+        }
+#endif
+        SDL_free(rwlock);
+    }
+}
+
+#if !SDL_THREADS_DISABLED
+static int
+LockForReading(SDL_rwlock * rwlock, SDL_bool wait)
+{
+    if (rwlock == NULL) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+
+    SDL_LockMutex(rwlock->lock);
+    if (rwlock->writer || rwlock->waiting_writers > 0) {
+        if (!wait) {
+            SDL_UnlockMutex(rwlock->lock);
+            return SDL_MUTEX_TIMEDOUT;
+        }
+        /* The unlocking writer counts us in as a reader before waking us */
+        ++rwlock->waiting_readers;
+        SDL_UnlockMutex(rwlock->lock);
+        return SDL_SemWait(rwlock->read_sem);
+    }
+    ++rwlock->readers;
+    SDL_UnlockMutex(rwlock->lock);
+    return 0;
+}
+
+static int
+LockForWriting(SDL_rwlock * rwlock, SDL_bool wait)
+{
+    if (rwlock == NULL) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+
+    SDL_LockMutex(rwlock->lock);
+    if (rwlock->writer || rwlock->readers > 0) {
+        if (!wait) {
+            SDL_UnlockMutex(rwlock->lock);
+            return SDL_MUTEX_TIMEDOUT;
+        }
+        /* Whoever unlocks last marks us as the writer before waking us */
+        ++rwlock->waiting_writers;
+        SDL_UnlockMutex(rwlock->lock);
+        return SDL_SemWait(rwlock->write_sem);
+    }
+    rwlock->writer = SDL_TRUE;
+    SDL_UnlockMutex(rwlock->lock);
+    return 0;
+}
+
+/* Hand the lock to the next waiting writer, if there is one */
+static void
+WakeWriter(SDL_rwlock * rwlock)
+{
+    if (rwlock->waiting_writers > 0) {
+        --rwlock->waiting_writers;
+        rwlock->writer = SDL_TRUE;
+        SDL_SemPost(rwlock->write_sem);
+    }
+}
+#endif /* !SDL_THREADS_DISABLED */
+
+int
+SDL_LockRWLockForReading(SDL_rwlock * rwlock)
+{
+#if SDL_THREADS_DISABLED
+    return 0;
+#else
+    return LockForReading(rwlock, SDL_TRUE);
+#endif
+}
+
+int
+SDL_LockRWLockForWriting(SDL_rwlock * rwlock)
+{
+#if SDL_THREADS_DISABLED
+    return 0;
+#else
+    return LockForWriting(rwlock, SDL_TRUE);
+#endif
+}
+
+int
+SDL_TryLockRWLockForReading(SDL_rwlock * rwlock)
+{
+#if SDL_THREADS_DISABLED
+    return 0;
+#else
+    return LockForReading(rwlock, SDL_FALSE);
+#endif
+}
+
+int
+SDL_TryLockRWLockForWriting(SDL_rwlock * rwlock)
+{
+#if SDL_THREADS_DISABLED
+    return 0;
+#else
+    return LockForWriting(rwlock, SDL_FALSE);
+#endif
+}
+
+/* Unlock the reader/writer lock */
+int
+SDL_UnlockRWLock(SDL_rwlock * rwlock)
+{
+#if SDL_THREADS_DISABLED
+    return 0;
+#else
+    if (rwlock == NULL) {
+        return SDL_SetError("Passed a NULL rwlock");
+    }
+
+    SDL_LockMutex(rwlock->lock);
+    if (rwlock->writer) {
+        rwlock->writer = SDL_FALSE;
+        if (rwlock->waiting_readers > 0) {
+            int i;
+
+            /* Let in every reader that queued up behind us */
+            rwlock->readers = rwlock->waiting_readers;
+            rwlock->waiting_readers = 0;
+            for (i = 0; i < rwlock->readers; ++i) {
+                SDL_SemPost(rwlock->read_sem);
+            }
+        } else {
+            WakeWriter(rwlock);
+        }
+    } else if (rwlock->readers > 0) {
+        if (--rwlock->readers == 0) {
+            WakeWriter(rwlock);
+        }
+    } else {
+        SDL_UnlockMutex(rwlock->lock);
+        return SDL_SetError("rwlock not locked");
+    }
+    SDL_UnlockMutex(rwlock->lock);
+    return 0;
+#endif /* SDL_THREADS_DISABLED */
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -24,6 +24,7 @@
 #include <pthread.h>
 
 #include "SDL_thread.h"
+#include "../../atomic/SDL_atomic_c.h"
 
 #if !SDL_THREAD_PTHREAD_RECURSIVE_MUTEX && \
     !SDL_THREAD_PTHREAD_RECURSIVE_MUTEX_NP
@@ -67,6 +68,23 @@ SDL_CreateMutex(void)
     return (mutex);
 }
 
+/* Most critical sections are short, so if the owner is running on another
+   CPU it's cheaper to spin for a moment than to sleep in the kernel.
+ */
+static int
+SpinThenLock(pthread_mutex_t *id)
+{
+    if (SDL_ShouldSpin()) {
+        int backoff = 1;
+        do {
+            if (pthread_mutex_trylock(id) == 0) {
+                return 0;
+            }
+        } while (SDL_SpinBackoff(&backoff));
+    }
+    return pthread_mutex_lock(id);
+}
+
 void
 SDL_DestroyMutex(SDL_mutex * mutex)
 {
@@ -97,7 +115,7 @@ SDL_LockMutex(SDL_mutex * mutex)
            We set the locking thread id after we obtain the lock
            so unlocks from other threads will fail.
          */
-        if (pthread_mutex_lock(&mutex->id) == 0) {
+        if (SpinThenLock(&mutex->id) == 0) {
             mutex->owner = this_thread;
             mutex->recursive = 0;
         } else {
@@ -105,7 +123,7 @@ SDL_LockMutex(SDL_mutex * mutex)
         }
     }
 #else
-    if (pthread_mutex_lock(&mutex->id) != 0) {
+    if (SpinThenLock(&mutex->id) != 0) {
         return SDL_SetError("pthread_mutex_lock() failed");
     }
 #endif
@@ -25,11 +25,13 @@
 #include "SDL_atomic.h"
 #include "SDL_cpuinfo.h"
 #include "../thread/SDL_systhread.h"
+#include "../atomic/SDL_atomic_c.h"
 
 /* #define DEBUG_TIMERS */
 
 typedef struct _SDL_Timer
 {
+    SDL_AtomicStackNode link;   /* for the pending list and freelist */
     int timerID;
     SDL_TimerCallback callback;
     void *param;
@@ -60,8 +62,8 @@ typedef struct {
     /* Data used to communicate with the timer thread */
     SDL_SpinLock lock;
     SDL_sem *sem;
-    SDL_Timer *pending;
-    SDL_Timer *freelist;
+    SDL_AtomicStack pending;
+    SDL_AtomicStack freelist;
     SDL_atomic_t active;
 
     /* List of timers - this is only touched by the timer thread */
@@ -101,10 +103,8 @@ static int SDLCALL
 SDL_TimerThread(void *_data)
 {
     SDL_TimerData *data = (SDL_TimerData *)_data;
-    SDL_Timer *pending;
+    SDL_AtomicStackNode *pending;
     SDL_Timer *current;
-    SDL_Timer *freelist_head = NULL;
-    SDL_Timer *freelist_tail = NULL;
     Uint32 tick, now, interval, delay;
 
     /* Threaded timer loop:
@@ -113,29 +113,13 @@ SDL_TimerThread(void *_data)
      *  3. Wait until next dispatch time or new timer arrives
      */
     for ( ; ; ) {
-        /* Pending and freelist maintenance */
-        SDL_AtomicLock(&data->lock);
-        {
-            /* Get any timers ready to be queued */
-            pending = data->pending;
-            data->pending = NULL;
-
-            /* Make any unused timer structures available */
-            if (freelist_head) {
-                freelist_tail->next = data->freelist;
-                data->freelist = freelist_head;
-            }
-        }
-        SDL_AtomicUnlock(&data->lock);
-
-        /* Sort the pending timers into our list */
+        /* Sort any timers added by other threads into our list */
+        pending = SDL_AtomicStackPopAll(&data->pending);
         while (pending) {
-            current = pending;
+            current = (SDL_Timer *)pending;
             pending = pending->next;
             SDL_AddTimerInternal(data, current);
         }
-        freelist_head = NULL;
-        freelist_tail = NULL;
 
         /* Check to see if we're still running, after maintenance */
         if (!SDL_AtomicGet(&data->active)) {
@@ -172,15 +156,10 @@ SDL_TimerThread(void *_data)
                 current->scheduled = tick + interval;
                 SDL_AddTimerInternal(data, current);
             } else {
-                if (!freelist_head) {
-                    freelist_head = current;
-                }
-                if (freelist_tail) {
-                    freelist_tail->next = current;
-                }
-                freelist_tail = current;
-
                 SDL_AtomicSet(&current->canceled, 1);
+
+                /* Make the timer structure available for reuse */
+                SDL_AtomicStackPush(&data->freelist, &current->link);
             }
         }
 
@@ -239,6 +218,7 @@ void
 SDL_TimerQuit(void)
 {
     SDL_TimerData *data = &SDL_timer_data;
+    SDL_AtomicStackNode *node;
     SDL_Timer *timer;
     SDL_TimerMap *entry;
 
@@ -259,9 +239,16 @@ SDL_TimerQuit(void)
             data->timers = timer->next;
             SDL_free(timer);
         }
-        while (data->freelist) {
-            timer = data->freelist;
-            data->freelist = timer->next;
+        node = SDL_AtomicStackPopAll(&data->pending);
+        while (node) {
+            timer = (SDL_Timer *)node;
+            node = node->next;
+            SDL_free(timer);
+        }
+        node = SDL_AtomicStackPopAll(&data->freelist);
+        while (node) {
+            timer = (SDL_Timer *)node;
+            node = node->next;
             SDL_free(timer);
         }
         while (data->timermap) {
@@ -289,13 +276,10 @@ SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
             return 0;
         }
     }
-
-    timer = data->freelist;
-    if (timer) {
-        data->freelist = timer->next;
-    }
     SDL_AtomicUnlock(&data->lock);
 
+    timer = (SDL_Timer *)SDL_AtomicStackPop(&data->freelist);
+
     if (timer) {
         SDL_RemoveTimer(timer->timerID);
     } else {
@@ -327,10 +311,7 @@ SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
     SDL_UnlockMutex(data->timermap_lock);
 
     /* Add the timer to the pending list for the timer thread */
-    SDL_AtomicLock(&data->lock);
-    timer->next = data->pending;
-    data->pending = timer;
-    SDL_AtomicUnlock(&data->lock);
+    SDL_AtomicStackPush(&data->pending, &timer->link);
 
     /* Wake up the timer thread if necessary */
     SDL_SemPost(data->sem);
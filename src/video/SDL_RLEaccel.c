@@ -94,10 +94,295 @@
 #ifndef MIN
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
 
 #define PIXEL_COPY(to, from, len, bpp)          \
     SDL_memcpy(to, from, (size_t)(len) * (bpp))
 
+/* used to save the destination format in the encoding. Designed to be
+   macro-compatible with SDL_PixelFormat but without the unneeded fields */
+typedef struct
+{
+    Uint8 BytesPerPixel;
+    Uint8 padding[3];
+    Uint32 Rmask;
+    Uint32 Gmask;
+    Uint32 Bmask;
+    Uint32 Amask;
+    Uint8 Rloss;
+    Uint8 Gloss;
+    Uint8 Bloss;
+    Uint8 Aloss;
+    Uint8 Rshift;
+    Uint8 Gshift;
+    Uint8 Bshift;
+    Uint8 Ashift;
+} RLEDestFormat;
+
+/*
+ * Modulated blits
+ *
+ * Colour modulation, alpha modulation of per-pixel alpha and the ADD and
+ * MOD blend modes don't fit the fixed-function blitters below, so runs are
+ * blended one pixel at a time with the same arithmetic as SDL_Blit_Slow().
+ * The encoding is unchanged, so transparent pixels are still skipped a
+ * whole run at a time.
+ */
+
+/* how the pixels of a run are stored */
+typedef enum
+{
+    RLE_PIXELS_SURFACE,         /* colorkey encoding, in the surface format */
+    RLE_PIXELS_OPAQUE,          /* opaque pixels, in the target format */
+    RLE_PIXELS_TRANSL16,        /* translucent pixels for 16-bit targets */
+    RLE_PIXELS_TRANSL32         /* translucent pixels for 32-bit targets */
+} RLEPixelType;
+
+typedef struct
+{
+    const SDL_BlitInfo *info;
+    SDL_PixelFormat *sf;        /* the source surface format */
+    RLEDestFormat *rf;          /* the encoded target format, for alpha */
+    SDL_PixelFormat *df;        /* the destination surface format */
+} RLEModulateData;
+
+/* Does a blit with these flags need the modulated blitters? */
+static SDL_bool
+RLENeedsModulate(int flags, SDL_PixelFormat * sf)
+{
+    if (flags & (SDL_COPY_MODULATE_COLOR | SDL_COPY_ADD | SDL_COPY_MOD)) {
+        return SDL_TRUE;
+    }
+    if ((flags & SDL_COPY_MODULATE_ALPHA) && sf->Amask) {
+        return SDL_TRUE;
+    }
+    return SDL_FALSE;
+}
+
+static void
+RLEModulateRun(const RLEModulateData * mod, RLEPixelType type,
+               Uint8 * dst, const Uint8 * src, int n)
+{
+    const SDL_BlitInfo *info = mod->info;
+    const int flags = info->flags;
+    SDL_PixelFormat *sf = mod->sf;
+    RLEDestFormat *rf = mod->rf;
+    SDL_PixelFormat *df = mod->df;
+    const int srcbpp = sf->BytesPerPixel;
+    const int dstbpp = df->BytesPerPixel;
+    Uint32 pixel;
+    unsigned srcR, srcG, srcB, srcA;
+    unsigned dstR, dstG, dstB, dstA;
+
+    while (n--) {
+        switch (type) {
+        case RLE_PIXELS_SURFACE:
+            if (sf->Amask) {
+                DISEMBLE_RGBA(src, srcbpp, sf, pixel, srcR, srcG, srcB, srcA);
+            } else {
+                DISEMBLE_RGB(src, srcbpp, sf, pixel, srcR, srcG, srcB);
+                srcA = 255;
+            }
+            src += srcbpp;
+            break;
+        case RLE_PIXELS_OPAQUE:
+            if (rf->BytesPerPixel == 2) {
+                pixel = *(const Uint16 *) src;
+            } else {
+                pixel = *(const Uint32 *) src;
+            }
+            RGB_FROM_PIXEL(pixel, rf, srcR, srcG, srcB);
+            srcA = 255;
+            src += rf->BytesPerPixel;
+            break;
+        case RLE_PIXELS_TRANSL16:
+            pixel = *(const Uint32 *) src;
+            srcA = (pixel & 0x3e0) >> 2;
+            pixel = (pixel & ~0x3e0) | pixel >> 16;
+            RGB_FROM_PIXEL(pixel, rf, srcR, srcG, srcB);
+            src += 4;
+            break;
+        default:
+            pixel = *(const Uint32 *) src;
+            RGB_FROM_PIXEL(pixel, rf, srcR, srcG, srcB);
+            srcA = pixel >> 24;
+            src += 4;
+            break;
+        }
+        if (df->Amask) {
+            DISEMBLE_RGBA(dst, dstbpp, df, pixel, dstR, dstG, dstB, dstA);
+        } else {
+            DISEMBLE_RGB(dst, dstbpp, df, pixel, dstR, dstG, dstB);
+            dstA = 255;
+        }
+
+        if (flags & SDL_COPY_MODULATE_COLOR) {
+            srcR = (srcR * info->r) / 255;
+            srcG = (srcG * info->g) / 255;
+            srcB = (srcB * info->b) / 255;
+        }
+        if (flags & SDL_COPY_MODULATE_ALPHA) {
+            srcA = (srcA * info->a) / 255;
+        }
+        if (flags & (SDL_COPY_BLEND | SDL_COPY_ADD)) {
+            if (srcA < 255) {
+                srcR = (srcR * srcA) / 255;
+                srcG = (srcG * srcA) / 255;
+                srcB = (srcB * srcA) / 255;
+            }
+        }
+        switch (flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD)) {
+        case 0:
+            dstR = srcR;
+            dstG = srcG;
+            dstB = srcB;
+            dstA = srcA;
+            break;
+        case SDL_COPY_BLEND:
+            dstR = srcR + ((255 - srcA) * dstR) / 255;
+            dstG = srcG + ((255 - srcA) * dstG) / 255;
+            dstB = srcB + ((255 - srcA) * dstB) / 255;
+            dstA = srcA + ((255 - srcA) * dstA) / 255;
+            break;
+        case SDL_COPY_ADD:
+            dstR = MIN(srcR + dstR, 255);
+            dstG = MIN(srcG + dstG, 255);
+            dstB = MIN(srcB + dstB, 255);
+            break;
+        case SDL_COPY_MOD:
+            dstR = (srcR * dstR) / 255;
+            dstG = (srcG * dstG) / 255;
+            dstB = (srcB * dstB) / 255;
+            break;
+        }
+        if (df->Amask) {
+            ASSEMBLE_RGBA(dst, dstbpp, df, dstR, dstG, dstB, dstA);
+        } else {
+            ASSEMBLE_RGB(dst, dstbpp, df, dstR, dstG, dstB);
+        }
+        dst += dstbpp;
+    }
+}
+
+/* modulate the part of a run starting at ofs that lies within [left, right) */
+static SDL_INLINE void
+RLEModulateClippedRun(const RLEModulateData * mod, RLEPixelType type,
+                      Uint8 * dstbuf, const Uint8 * srcbuf, int srcbpp,
+                      int ofs, int run, int left, int right)
+{
+    int start = MAX(ofs, left);
+    int end = MIN(ofs + run, right);
+    if (start < end) {
+        RLEModulateRun(mod, type, dstbuf + start * mod->df->BytesPerPixel,
+                       srcbuf + (start - ofs) * srcbpp, end - start);
+    }
+}
+
+/* blit a colorkeyed RLE surface with modulation, top clipping done */
+static void
+RLEModulateBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
+                Uint8 * dstbuf, SDL_Rect * srcrect,
+                const RLEModulateData * mod)
+{
+    const int bpp = surf_dst->format->BytesPerPixel;
+    int linecount = srcrect->h;
+    int left = srcrect->x;
+    int right = left + srcrect->w;
+    int ofs = 0;
+
+    dstbuf -= left * bpp;
+    for (;;) {
+        int run;
+        if (bpp == 4) {
+            ofs += ((Uint16 *) srcbuf)[0];
+            run = ((Uint16 *) srcbuf)[1];
+            srcbuf += 4;
+        } else {
+            ofs += srcbuf[0];
+            run = srcbuf[1];
+            srcbuf += 2;
+        }
+        if (run) {
+            RLEModulateClippedRun(mod, RLE_PIXELS_SURFACE, dstbuf, srcbuf,
+                                  bpp, ofs, run, left, right);
+            srcbuf += run * bpp;
+            ofs += run;
+        } else if (!ofs) {
+            break;
+        }
+        if (ofs == w) {
+            ofs = 0;
+            dstbuf += surf_dst->pitch;
+            if (!--linecount) {
+                break;
+            }
+        }
+    }
+}
+
+/* blit a pixel-alpha RLE surface with modulation, top clipping done */
+static void
+RLEAlphaModulateBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
+                     Uint8 * dstbuf, SDL_Rect * srcrect,
+                     const RLEModulateData * mod)
+{
+    const int bpp = surf_dst->format->BytesPerPixel;
+    const RLEPixelType transl =
+        (bpp == 2) ? RLE_PIXELS_TRANSL16 : RLE_PIXELS_TRANSL32;
+    int linecount = srcrect->h;
+    int left = srcrect->x;
+    int right = left + srcrect->w;
+
+    dstbuf -= left * bpp;
+    do {
+        /* opaque pixels on one line */
+        int ofs = 0;
+        do {
+            int run;
+            if (bpp == 2) {
+                ofs += srcbuf[0];
+                run = srcbuf[1];
+                srcbuf += 2;
+            } else {
+                ofs += ((Uint16 *) srcbuf)[0];
+                run = ((Uint16 *) srcbuf)[1];
+                srcbuf += 4;
+            }
+            if (run) {
+                RLEModulateClippedRun(mod, RLE_PIXELS_OPAQUE, dstbuf, srcbuf,
+                                      bpp, ofs, run, left, right);
+                srcbuf += run * bpp;
+                ofs += run;
+            } else if (!ofs) {
+                return;
+            }
+        } while (ofs < w);
+
+        /* skip padding if necessary */
+        if (bpp == 2) {
+            srcbuf += (uintptr_t) srcbuf & 2;
+        }
+
+        /* translucent pixels on the same line */
+        ofs = 0;
+        do {
+            int run;
+            ofs += ((Uint16 *) srcbuf)[0];
+            run = ((Uint16 *) srcbuf)[1];
+            srcbuf += 4;
+            if (run) {
+                RLEModulateClippedRun(mod, transl, dstbuf, srcbuf,
+                                      4, ofs, run, left, right);
+                srcbuf += run * 4;
+                ofs += run;
+            }
+        } while (ofs < w);
+        dstbuf += surf_dst->pitch;
+    } while (--linecount);
+}
+
 /*
  * Various colorkey blit methods, for opaque and per-surface alpha
  */
@@ -515,8 +800,15 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     }
 
     alpha = surf_src->map->info.a;
-    /* if left or right edge clipping needed, call clip blit */
-    if (srcrect->x || srcrect->w != surf_src->w) {
+    if (RLENeedsModulate(surf_src->map->info.flags, surf_src->format)) {
+        RLEModulateData mod;
+        mod.info = &surf_src->map->info;
+        mod.sf = surf_src->format;
+        mod.rf = NULL;
+        mod.df = surf_dst->format;
+        RLEModulateBlit(w, srcbuf, surf_dst, dstbuf, srcrect, &mod);
+    } else if (srcrect->x || srcrect->w != surf_src->w) {
+        /* left or right edge clipping needed, call clip blit */
         RLEClipBlit(w, srcbuf, surf_dst, dstbuf, srcrect, alpha);
     } else {
         SDL_PixelFormat *fmt = surf_src->format;
@@ -611,26 +903,6 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     dst = (Uint16)(d | d >> 16);            \
     } while(0)
 
-/* used to save the destination format in the encoding. Designed to be
-   macro-compatible with SDL_PixelFormat but without the unneeded fields */
-typedef struct
-{
-    Uint8 BytesPerPixel;
-    Uint8 padding[3];
-    Uint32 Rmask;
-    Uint32 Gmask;
-    Uint32 Bmask;
-    Uint32 Amask;
-    Uint8 Rloss;
-    Uint8 Gloss;
-    Uint8 Bloss;
-    Uint8 Aloss;
-    Uint8 Rshift;
-    Uint8 Gshift;
-    Uint8 Bshift;
-    Uint8 Ashift;
-} RLEDestFormat;
-
 /* blit a pixel-alpha RLE surface clipped at the right and/or left edges */
 static void
 RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
@@ -801,8 +1073,15 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
         }
     }
 
-    /* if left or right edge clipping needed, call clip blit */
-    if (srcrect->x || srcrect->w != surf_src->w) {
+    if (RLENeedsModulate(surf_src->map->info.flags, surf_src->format)) {
+        RLEModulateData mod;
+        mod.info = &surf_src->map->info;
+        mod.sf = surf_src->format;
+        mod.rf = (RLEDestFormat *) surf_src->map->data;
+        mod.df = df;
+        RLEAlphaModulateBlit(w, srcbuf, surf_dst, dstbuf, srcrect, &mod);
+    } else if (srcrect->x || srcrect->w != surf_src->w) {
+        /* left or right edge clipping needed, call clip blit */
         RLEAlphaClipBlit(w, srcbuf, surf_dst, dstbuf, srcrect);
     } else {
 
@@ -1424,20 +1703,23 @@ SDL_RLESurface(SDL_Surface * surface)
 
     /* If we don't have colorkey or blending, nothing to do... */
     flags = surface->map->info.flags;
-    if (!(flags & (SDL_COPY_COLORKEY | SDL_COPY_BLEND))) {
+    if (!(flags & (SDL_COPY_COLORKEY | SDL_COPY_BLEND)) &&
+        !((flags & SDL_COPY_ADD) && surface->format->Amask)) {
         return -1;
     }
 
-    /* Pass on combinations not supported */
-    if ((flags & SDL_COPY_MODULATE_COLOR) ||
-        ((flags & SDL_COPY_MODULATE_ALPHA) && surface->format->Amask) ||
-        (flags & (SDL_COPY_ADD | SDL_COPY_MOD)) ||
-        (flags & SDL_COPY_NEAREST)) {
+    /* Pass on combinations not supported: scaling, and modulation or
+       ADD/MOD blending of 8-bit pixels */
+    if ((flags & SDL_COPY_NEAREST) ||
+        ((flags & (SDL_COPY_MODULATE_COLOR | SDL_COPY_ADD | SDL_COPY_MOD)) &&
+         surface->format->BytesPerPixel == 1)) {
         return -1;
     }
 
-    /* Encode and set up the blit */
-    if (!surface->format->Amask || !(flags & SDL_COPY_BLEND)) {
+    /* Encode and set up the blit.  Transparent pixels can be dropped from
+       the alpha encoding only when they leave the destination untouched */
+    if (!surface->format->Amask ||
+        !(flags & (SDL_COPY_BLEND | SDL_COPY_ADD))) {
         if (!surface->map->identity) {
             return -1;
         }
@@ -1551,6 +1833,8 @@ SDL_UnRLESurface(SDL_Surface * surface, int recode)
         if (recode && !(surface->flags & SDL_PREALLOC)) {
             if (surface->map->info.flags & SDL_COPY_RLE_COLORKEY) {
                 SDL_Rect full;
+                int flags = surface->map->info.flags;
+                Uint8 alpha = surface->map->info.a;
 
                 /* re-create the original surface */
                 surface->pixels = SDL_SIMDAlloc(surface->h * surface->pitch);
@@ -1564,11 +1848,18 @@ SDL_UnRLESurface(SDL_Surface * surface, int recode)
                 /* fill it with the background color */
                 SDL_FillRect(surface, NULL, surface->map->info.colorkey);
 
-                /* now render the encoded surface */
+                /* now render the encoded surface, as a plain copy even if
+                   modulation or blending has changed since it was encoded */
                 full.x = full.y = 0;
                 full.w = surface->w;
                 full.h = surface->h;
+                surface->map->info.flags &=
+                    ~(SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA |
+                      SDL_COPY_ADD | SDL_COPY_MOD);
+                surface->map->info.a = 255;
                 SDL_RLEBlit(surface, &full, surface, &full);
+                surface->map->info.flags = flags;
+                surface->map->info.a = alpha;
             } else {
                 if (!UnRLEAlpha(surface)) {
                     /* Oh crap... */
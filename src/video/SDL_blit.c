@@ -21,6 +21,8 @@
 #include "../SDL_internal.h"
 
 #include "SDL_video.h"
+#include "SDL_hints.h"
+#include "SDL_jobs.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_blit_auto.h"
@@ -29,6 +31,58 @@
 #include "SDL_RLEaccel_c.h"
 #include "SDL_pixels_c.h"
 
+/* Whether a conversion is large enough to split across the job pool */
+SDL_bool
+SDL_ShouldConvertInParallel(int width, int height)
+{
+    if ((Sint64) width * height < SDL_PARALLEL_CONVERT_PIXELS) {
+        return SDL_FALSE;
+    }
+    if (!SDL_GetHintBoolean(SDL_HINT_PARALLEL_CONVERT, SDL_FALSE)) {
+        return SDL_FALSE;
+    }
+    return (SDL_GetJobWorkerCount() > 0) ? SDL_TRUE : SDL_FALSE;
+}
+
+typedef struct
+{
+    SDL_BlitFunc blit;
+    const SDL_BlitInfo *info;
+} SDL_BlitRowsData;
+
+static void SDLCALL
+SDL_BlitRowBand(void *data, int start, int end)
+{
+    const SDL_BlitRowsData *rows = (const SDL_BlitRowsData *) data;
+    SDL_BlitInfo info = *rows->info;
+
+    info.src += start * info.src_pitch;
+    info.dst += start * info.dst_pitch;
+    info.src_h = info.dst_h = end - start;
+    rows->blit(&info);
+}
+
+/* Run a blit, splitting a large conversion into bands of rows on the job
+   pool.  Every band runs the same blitter over the same rows it would
+   have covered in one pass, so the result doesn't change.  Blits to
+   palettes stay on one thread, since their ordered dither is keyed to
+   the row. */
+void
+SDL_RunBlitRows(SDL_BlitFunc blit, SDL_BlitInfo * info)
+{
+    if (info->src_w == info->dst_w && info->src_h == info->dst_h &&
+        !info->dst_fmt->palette &&
+        SDL_ShouldConvertInParallel(info->dst_w, info->dst_h)) {
+        SDL_BlitRowsData rows;
+
+        rows.blit = blit;
+        rows.info = info;
+        SDL_ParallelFor(0, info->dst_h, 0, SDL_BlitRowBand, &rows);
+    } else {
+        blit(info);
+    }
+}
+
 /* The general purpose software blit routine */
 static int SDLCALL
 SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
@@ -85,7 +139,11 @@ SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
         RunBlit = (SDL_BlitFunc) src->map->data;
 
         /* Run the actual software blit */
-        RunBlit(info);
+        if (src->map->parallel) {
+            SDL_RunBlitRows(RunBlit, info);
+        } else {
+            RunBlit(info);
+        }
     }
 
     /* We need to unlock the surfaces if they're locked */
@@ -23,6 +23,7 @@
 #ifndef SDL_blit_h_
 #define SDL_blit_h_
 
+#include "SDL_atomic.h"
 #include "SDL_cpuinfo.h"
 #include "SDL_endian.h"
 #include "SDL_surface.h"
@@ -82,6 +83,22 @@ typedef struct
     SDL_BlitFunc func;
 } SDL_BlitFuncEntry;
 
+/* A mapping to a destination format that isn't the current one, kept so
+   that a surface blitted to a few different formats can switch between
+   them without rebuilding the mapping each time. */
+#define SDL_BLITMAP_CACHE_SIZE  4
+
+typedef struct SDL_BlitMapCacheEntry
+{
+    SDL_PixelFormat *dst_fmt;   /* NULL if the entry is unused */
+    Uint32 src_palette_version;
+    Uint32 flags;
+    int identity;
+    SDL_blit blit;
+    void *data;
+    Uint8 *table;
+} SDL_BlitMapCacheEntry;
+
 /* Blit mapping definition */
 typedef struct SDL_BlitMap
 {
@@ -95,10 +112,62 @@ typedef struct SDL_BlitMap
        an invalid mapping */
     Uint32 dst_palette_version;
     Uint32 src_palette_version;
+
+    /* most recently used first */
+    SDL_BlitMapCacheEntry cache[SDL_BLITMAP_CACHE_SIZE];
+
+    /* set while converting a whole image, which may be split into bands */
+    SDL_bool parallel;
+
+    /* the RGB to palette table in info.table, shared with other maps */
+    struct SDL_InverseColorMap *inverse;
 } SDL_BlitMap;
 
+/* RGB to palette blits look colors up in a table of the palette entry
+   nearest each RGB 5-6-5 color.  Entries are filled in the first time a
+   color is seen, so only the colors an image uses search the palette.
+   There is one table per palette, shared by every map blitting to it, so
+   blits on other threads may fill it in at the same time: an entry is
+   written before its bit is set, and its bit is set atomically. */
+#define SDL_INVERSE_COLORS  (32 * 64 * 32)
+
+typedef struct SDL_InverseColorMap
+{
+    SDL_Palette *palette;       /* NULL once the palette has been freed */
+    Uint32 version;             /* the palette version the entries are for */
+    SDL_bool dither;
+    int refcount;
+    struct SDL_InverseColorMap *next;
+    SDL_atomic_t filled[SDL_INVERSE_COLORS / 32];
+    Uint8 index[SDL_INVERSE_COLORS];
+} SDL_InverseColorMap;
+
+#define SDL_INVERSE_CELL(r, g, b) \
+    ((((Uint32)(r) >> 3) << 11) | (((Uint32)(g) >> 2) << 5) | ((Uint32)(b) >> 3))
+
+#define SDL_INVERSE_COLOR(map, pal, cell) SDL_LookupInverseColor(map, pal, cell)
+
+/* Functions found in SDL_pixels.c */
+extern Uint8 SDL_FillInverseColor(SDL_InverseColorMap * map, SDL_Palette * pal, Uint32 cell);
+
+SDL_FORCE_INLINE Uint8
+SDL_LookupInverseColor(SDL_InverseColorMap * map, SDL_Palette * pal, Uint32 cell)
+{
+    if ((Uint32)map->filled[cell >> 5].value & (1U << (cell & 31))) {
+        /* Pairs with the release in SDL_FillInverseColor() */
+        SDL_MemoryBarrierAcquire();
+        return map->index[cell];
+    }
+    return SDL_FillInverseColor(map, pal, cell);
+}
+
+/* Conversions of at least this many pixels may use the job pool */
+#define SDL_PARALLEL_CONVERT_PIXELS (256 * 1024)
+
 /* Functions found in SDL_blit.c */
 extern int SDL_CalculateBlit(SDL_Surface * surface);
+extern SDL_bool SDL_ShouldConvertInParallel(int width, int height);
+extern void SDL_RunBlitRows(SDL_BlitFunc blit, SDL_BlitInfo * info);
 
 /* Functions found in SDL_blit_*.c */
 extern SDL_BlitFunc SDL_CalculateBlit0(SDL_Surface * surface);
@@ -36,6 +36,7 @@ BlitNto1SurfaceAlpha(SDL_BlitInfo * info)
     Uint8 *dst = info->dst;
     int dstskip = info->dst_skip;
     Uint8 *palmap = info->table;
+    SDL_InverseColorMap *inverse = (SDL_InverseColorMap *) info->table;
     SDL_PixelFormat *srcfmt = info->src_fmt;
     SDL_PixelFormat *dstfmt = info->dst_fmt;
     int srcbpp = srcfmt->BytesPerPixel;
@@ -60,7 +61,8 @@ BlitNto1SurfaceAlpha(SDL_BlitInfo * info)
         if ( palmap == NULL ) {
             *dst =((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0));
         } else {
-            *dst = palmap[((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0))];
+            Uint32 cell = SDL_INVERSE_CELL(dR, dG, dB);
+            *dst = SDL_INVERSE_COLOR(inverse, dstfmt->palette, cell);
         }
         dst++;
         src += srcbpp;
@@ -83,6 +85,7 @@ BlitNto1PixelAlpha(SDL_BlitInfo * info)
     Uint8 *dst = info->dst;
     int dstskip = info->dst_skip;
     Uint8 *palmap = info->table;
+    SDL_InverseColorMap *inverse = (SDL_InverseColorMap *) info->table;
     SDL_PixelFormat *srcfmt = info->src_fmt;
     SDL_PixelFormat *dstfmt = info->dst_fmt;
     int srcbpp = srcfmt->BytesPerPixel;
@@ -106,7 +109,8 @@ BlitNto1PixelAlpha(SDL_BlitInfo * info)
         if ( palmap == NULL ) {
             *dst =((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0));
         } else {
-            *dst = palmap[((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0))];
+            Uint32 cell = SDL_INVERSE_CELL(dR, dG, dB);
+            *dst = SDL_INVERSE_COLOR(inverse, dstfmt->palette, cell);
         }
         dst++;
         src += srcbpp;
@@ -129,6 +133,7 @@ BlitNto1SurfaceAlphaKey(SDL_BlitInfo * info)
     Uint8 *dst = info->dst;
     int dstskip = info->dst_skip;
     Uint8 *palmap = info->table;
+    SDL_InverseColorMap *inverse = (SDL_InverseColorMap *) info->table;
     SDL_PixelFormat *srcfmt = info->src_fmt;
     SDL_PixelFormat *dstfmt = info->dst_fmt;
     int srcbpp = srcfmt->BytesPerPixel;
@@ -155,7 +160,8 @@ BlitNto1SurfaceAlphaKey(SDL_BlitInfo * info)
             if ( palmap == NULL ) {
                 *dst =((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0));
             } else {
-                *dst = palmap[((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0))];
+                Uint32 cell = SDL_INVERSE_CELL(dR, dG, dB);
+                *dst = SDL_INVERSE_COLOR(inverse, dstfmt->palette, cell);
             }
         }
         dst++;
@@ -902,6 +902,11 @@ GetBlitFeatures(void)
                   (((src)&0x0000E000)>>11)| \
                   (((src)&0x000000C0)>>6)); \
 }
+#define RGB888_CELL(dst, src) { \
+    dst = (((src)&0x00F80000)>>8)| \
+          (((src)&0x0000FC00)>>5)| \
+          (((src)&0x000000F8)>>3); \
+}
 static void
 Blit_RGB888_index8(SDL_BlitInfo * info)
 {
@@ -911,6 +916,8 @@ Blit_RGB888_index8(SDL_BlitInfo * info)
     int width, height;
     Uint32 *src;
     const Uint8 *map;
+    SDL_InverseColorMap *inverse;
+    SDL_Palette *palette;
     Uint8 *dst;
     int srcskip, dstskip;
 
@@ -922,6 +929,8 @@ Blit_RGB888_index8(SDL_BlitInfo * info)
     dst = info->dst;
     dstskip = info->dst_skip;
     map = info->table;
+    inverse = (SDL_InverseColorMap *) info->table;
+    palette = info->dst_fmt->palette;
 
     if (map == NULL) {
         while (height--) {
@@ -958,45 +967,45 @@ Blit_RGB888_index8(SDL_BlitInfo * info)
             dst += dstskip;
         }
     } else {
-        int Pixel;
+        Uint32 Pixel;
 
         while (height--) {
 #ifdef USE_DUFFS_LOOP
             /* *INDENT-OFF* */
             DUFFS_LOOP(
-                RGB888_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
+                RGB888_CELL(Pixel, *src);
+                *dst++ = SDL_INVERSE_COLOR(inverse, palette, Pixel);
                 ++src;
             , width);
             /* *INDENT-ON* */
 #else
             for (c = width / 4; c; --c) {
                 /* Pack RGB into 8bit pixel */
-                RGB888_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
+                RGB888_CELL(Pixel, *src);
+                *dst++ = SDL_INVERSE_COLOR(inverse, palette, Pixel);
                 ++src;
-                RGB888_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
+                RGB888_CELL(Pixel, *src);
+                *dst++ = SDL_INVERSE_COLOR(inverse, palette, Pixel);
                 ++src;
-                RGB888_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
+                RGB888_CELL(Pixel, *src);
+                *dst++ = SDL_INVERSE_COLOR(inverse, palette, Pixel);
                 ++src;
-                RGB888_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
+                RGB888_CELL(Pixel, *src);
+                *dst++ = SDL_INVERSE_COLOR(inverse, palette, Pixel);
                 ++src;
             }
             switch (width & 3) {
             case 3:
-                RGB888_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
+                RGB888_CELL(Pixel, *src);
+                *dst++ = SDL_INVERSE_COLOR(inverse, palette, Pixel);
                 ++src;
             case 2:
-                RGB888_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
+                RGB888_CELL(Pixel, *src);
+                *dst++ = SDL_INVERSE_COLOR(inverse, palette, Pixel);
                 ++src;
             case 1:
-                RGB888_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
+                RGB888_CELL(Pixel, *src);
+                *dst++ = SDL_INVERSE_COLOR(inverse, palette, Pixel);
                 ++src;
             }
 #endif /* USE_DUFFS_LOOP */
@@ -1012,6 +1021,11 @@ Blit_RGB888_index8(SDL_BlitInfo * info)
                   (((src)&0x000E0000)>>15)| \
                   (((src)&0x00000300)>>8)); \
 }
+#define RGB101010_CELL(dst, src) { \
+    dst = (((src)&0x3E000000)>>14)| \
+          (((src)&0x000FC000)>>9)| \
+          (((src)&0x000003E0)>>5); \
+}
 static void
 Blit_RGB101010_index8(SDL_BlitInfo * info)
 {
@@ -1021,6 +1035,8 @@ Blit_RGB101010_index8(SDL_BlitInfo * info)
     int width, height;
     Uint32 *src;
     const Uint8 *map;
+    SDL_InverseColorMap *inverse;
+    SDL_Palette *palette;
     Uint8 *dst;
     int srcskip, dstskip;
 
@@ -1032,6 +1048,8 @@ Blit_RGB101010_index8(SDL_BlitInfo * info)
     dst = info->dst;
     dstskip = info->dst_skip;
     map = info->table;
+    inverse = (SDL_InverseColorMap *) info->table;
+    palette = info->dst_fmt->palette;
 
     if (map == NULL) {
         while (height--) {
@@ -1068,45 +1086,45 @@ Blit_RGB101010_index8(SDL_BlitInfo * info)
             dst += dstskip;
         }
     } else {
-        int Pixel;
+        Uint32 Pixel;
 
         while (height--) {
 #ifdef USE_DUFFS_LOOP
             /* *INDENT-OFF* */
             DUFFS_LOOP(
-                RGB101010_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
+                RGB101010_CELL(Pixel, *src);
+                *dst++ = SDL_INVERSE_COLOR(inverse, palette, Pixel);
                 ++src;
             , width);
             /* *INDENT-ON* */
 #else
             for (c = width / 4; c; --c) {
                 /* Pack RGB into 8bit pixel */
-                RGB101010_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
+                RGB101010_CELL(Pixel, *src);
+                *dst++ = SDL_INVERSE_COLOR(inverse, palette, Pixel);
                 ++src;
-                RGB101010_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
+                RGB101010_CELL(Pixel, *src);
+                *dst++ = SDL_INVERSE_COLOR(inverse, palette, Pixel);
                 ++src;
-                RGB101010_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
+                RGB101010_CELL(Pixel, *src);
+                *dst++ = SDL_INVERSE_COLOR(inverse, palette, Pixel);
                 ++src;
-                RGB101010_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
+                RGB101010_CELL(Pixel, *src);
+                *dst++ = SDL_INVERSE_COLOR(inverse, palette, Pixel);
                 ++src;
             }
             switch (width & 3) {
             case 3:
-                RGB101010_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
+                RGB101010_CELL(Pixel, *src);
+                *dst++ = SDL_INVERSE_COLOR(inverse, palette, Pixel);
                 ++src;
             case 2:
-                RGB101010_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
+                RGB101010_CELL(Pixel, *src);
+                *dst++ = SDL_INVERSE_COLOR(inverse, palette, Pixel);
                 ++src;
             case 1:
-                RGB101010_RGB332(Pixel, *src);
-                *dst++ = map[Pixel];
+                RGB101010_CELL(Pixel, *src);
+                *dst++ = SDL_INVERSE_COLOR(inverse, palette, Pixel);
                 ++src;
             }
 #endif /* USE_DUFFS_LOOP */
@@ -1996,6 +2014,8 @@ BlitNto1(SDL_BlitInfo * info)
     int width, height;
     Uint8 *src;
     const Uint8 *map;
+    SDL_InverseColorMap *inverse;
+    SDL_Palette *palette;
     Uint8 *dst;
     int srcskip, dstskip;
     int srcbpp;
@@ -2011,6 +2031,8 @@ BlitNto1(SDL_BlitInfo * info)
     dst = info->dst;
     dstskip = info->dst_skip;
     map = info->table;
+    inverse = (SDL_InverseColorMap *) info->table;
+    palette = info->dst_fmt->palette;
     srcfmt = info->src_fmt;
     srcbpp = srcfmt->BytesPerPixel;
 
@@ -2055,9 +2077,8 @@ BlitNto1(SDL_BlitInfo * info)
                                 sR, sG, sB);
                 if ( 1 ) {
                     /* Pack RGB into 8bit pixel */
-                    *dst = map[((sR>>5)<<(3+2))|
-                           ((sG>>5)<<(2))  |
-                           ((sB>>6)<<(0))  ];
+                    Pixel = SDL_INVERSE_CELL(sR, sG, sB);
+                    *dst = SDL_INVERSE_COLOR(inverse, palette, Pixel);
                 }
                 dst++;
                 src += srcbpp;
@@ -2068,8 +2089,8 @@ BlitNto1(SDL_BlitInfo * info)
                 DISEMBLE_RGB(src, srcbpp, srcfmt, Pixel, sR, sG, sB);
                 if (1) {
                     /* Pack RGB into 8bit pixel */
-                    *dst = map[((sR >> 5) << (3 + 2)) |
-                               ((sG >> 5) << (2)) | ((sB >> 6) << (0))];
+                    Pixel = SDL_INVERSE_CELL(sR, sG, sB);
+                    *dst = SDL_INVERSE_COLOR(inverse, palette, Pixel);
                 }
                 dst++;
                 src += srcbpp;
@@ -2081,6 +2102,55 @@ BlitNto1(SDL_BlitInfo * info)
     }
 }
 
+/* 4x4 ordered dither matrix, applied before looking up the palette index */
+static const Uint8 dither_matrix[4][4] = {
+    {  0,  8,  2, 10 },
+    { 12,  4, 14,  6 },
+    {  3, 11,  1,  9 },
+    { 15,  7, 13,  5 }
+};
+
+#define DITHER_CHANNEL(c, offset) { \
+    c += offset; \
+    if (c < 0) c = 0; else if (c > 255) c = 255; \
+}
+
+static void
+BlitNto1Dither(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip;
+    SDL_PixelFormat *srcfmt = info->src_fmt;
+    SDL_InverseColorMap *inverse = (SDL_InverseColorMap *) info->table;
+    SDL_Palette *palette = info->dst_fmt->palette;
+    int srcbpp = srcfmt->BytesPerPixel;
+    int x, y;
+
+    for (y = 0; y < height; ++y) {
+        const Uint8 *row = dither_matrix[y & 3];
+        for (x = 0; x < width; ++x) {
+            Uint32 Pixel, cell;
+            int r, g, b, offset;
+
+            DISEMBLE_RGB(src, srcbpp, srcfmt, Pixel, r, g, b);
+            /* Red and blue cells are 8 levels wide, green cells 4 */
+            offset = row[x & 3] - 8;
+            DITHER_CHANNEL(r, offset);
+            DITHER_CHANNEL(g, offset / 2);
+            DITHER_CHANNEL(b, offset);
+            cell = SDL_INVERSE_CELL(r, g, b);
+            *dst++ = SDL_INVERSE_COLOR(inverse, palette, cell);
+            src += srcbpp;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+}
+
 /* blits 32 bit RGB<->RGBA with both surfaces having the same R,G,B fields */
 static void
 Blit4to4MaskAlpha(SDL_BlitInfo * info)
@@ -2428,6 +2498,8 @@ BlitNto1Key(SDL_BlitInfo * info)
     int dstskip = info->dst_skip;
     SDL_PixelFormat *srcfmt = info->src_fmt;
     const Uint8 *palmap = info->table;
+    SDL_InverseColorMap *inverse = (SDL_InverseColorMap *) info->table;
+    SDL_Palette *palette = info->dst_fmt->palette;
     Uint32 ckey = info->colorkey;
     Uint32 rgbmask = ~srcfmt->Amask;
     int srcbpp;
@@ -2468,9 +2540,8 @@ BlitNto1Key(SDL_BlitInfo * info)
                                 sR, sG, sB);
                 if ( (Pixel & rgbmask) != ckey ) {
                     /* Pack RGB into 8bit pixel */
-                    *dst = (Uint8)palmap[((sR>>5)<<(3+2))|
-                                         ((sG>>5)<<(2))  |
-                                         ((sB>>6)<<(0))  ];
+                    Uint32 cell = SDL_INVERSE_CELL(sR, sG, sB);
+                    *dst = SDL_INVERSE_COLOR(inverse, palette, cell);
                 }
                 dst++;
                 src += srcbpp;
@@ -3297,6 +3368,10 @@ SDL_CalculateBlitN(SDL_Surface * surface)
             } else {
                 blitfun = BlitNto1;
             }
+            if (surface->map->info.table &&
+                ((SDL_InverseColorMap *) surface->map->info.table)->dither) {
+                blitfun = BlitNto1Dither;
+            }
         } else {
             /* Now the meat, choose the blitter we want */
             Uint32 a_need = NO_ALPHA;
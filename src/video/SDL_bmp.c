@@ -83,26 +83,84 @@ static void CorrectAlphaChannel(SDL_Surface *surface)
     }
 }
 
-SDL_Surface *
-SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
+/* Returns SDL_TRUE if any pixel in a row of 32-bit BMP pixels has alpha */
+static SDL_bool RowHasAlpha(const Uint32 *pixels, int width)
+{
+    int i;
+
+    for (i = 0; i < width; ++i) {
+        if (pixels[i] & 0xFF000000) {
+            return SDL_TRUE;
+        }
+    }
+    return SDL_FALSE;
+}
+
+static void SetRowOpaque(Uint32 *pixels, int width)
+{
+    int i;
+
+    for (i = 0; i < width; ++i) {
+        pixels[i] |= 0xFF000000;
+    }
+}
+
+/* Clear the alpha of rows that were converted as opaque before we knew
+   the image has an alpha channel. */
+static void ClearAlphaChannel(SDL_Surface *surface, int y, int h)
+{
+    const Uint32 keep = ~surface->format->Amask;
+    Uint8 *row = (Uint8 *)surface->pixels + y * surface->pitch;
+    int i;
+
+    while (h--) {
+        switch (surface->format->BytesPerPixel) {
+        case 2:
+            for (i = 0; i < surface->w; ++i) {
+                ((Uint16 *)row)[i] &= (Uint16)keep;
+            }
+            break;
+        case 4:
+            for (i = 0; i < surface->w; ++i) {
+                ((Uint32 *)row)[i] &= keep;
+            }
+            break;
+        default:
+            break;
+        }
+        row += surface->pitch;
+    }
+}
+
+/* Load a BMP image, in the image's own format if format is
+   SDL_PIXELFORMAT_UNKNOWN.  When converting, each row is decoded into a
+   one row surface and blitted into place, so the image is only held in
+   memory once. */
+static SDL_Surface *
+LoadBMP(SDL_RWops * src, int freesrc, Uint32 format)
 {
     SDL_bool was_error;
     Sint64 fp_offset = 0;
     int bmpPitch;
-    int i, pad;
+    int i, y, pad;
+    size_t rowread;
     SDL_Surface *surface;
+    SDL_Surface *decode;
+    SDL_Rect srcrect, dstrect;
+    Uint32 native;
     Uint32 Rmask = 0;
     Uint32 Gmask = 0;
     Uint32 Bmask = 0;
     Uint32 Amask = 0;
     SDL_Palette *palette;
     Uint8 *bits;
-    Uint8 *top, *end;
     SDL_bool topDown;
     int ExpandBMP;
     SDL_bool haveRGBMasks = SDL_FALSE;
     SDL_bool haveAlphaMask = SDL_FALSE;
     SDL_bool correctAlpha = SDL_FALSE;
+    SDL_bool sawAlpha = SDL_FALSE;
+    SDL_bool convert = SDL_FALSE;
 
     /* The Win32 BMP file header (14 bytes) */
     char magic[2];
@@ -129,6 +187,7 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
 
     /* Make sure we are passed a valid data source */
     surface = NULL;
+    decode = NULL;
     was_error = SDL_FALSE;
     if (src == NULL) {
         was_error = SDL_TRUE;
@@ -156,23 +215,31 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
     /* Read the Win32 BITMAPINFOHEADER */
     biSize = SDL_ReadLE32(src);
     if (biSize == 12) {   /* really old BITMAPCOREHEADER */
-        biWidth = (Uint32) SDL_ReadLE16(src);
-        biHeight = (Uint32) SDL_ReadLE16(src);
-        /* biPlanes = */ SDL_ReadLE16(src);
-        biBitCount = SDL_ReadLE16(src);
+        Uint16 core[4] = { 0, 0, 0, 0 };
+        SDL_ReadLE16Array(src, core, SDL_arraysize(core));
+        biWidth = (Uint32) core[0];
+        biHeight = (Uint32) core[1];
+        /* biPlanes = core[2] */
+        biBitCount = core[3];
         biCompression = BI_RGB;
     } else if (biSize >= 40) {  /* some version of BITMAPINFOHEADER */
         Uint32 headerSize;
-        biWidth = SDL_ReadLE32(src);
-        biHeight = SDL_ReadLE32(src);
-        /* biPlanes = */ SDL_ReadLE16(src);
-        biBitCount = SDL_ReadLE16(src);
-        biCompression = SDL_ReadLE32(src);
-        /* biSizeImage = */ SDL_ReadLE32(src);
-        /* biXPelsPerMeter = */ SDL_ReadLE32(src);
-        /* biYPelsPerMeter = */ SDL_ReadLE32(src);
-        biClrUsed = SDL_ReadLE32(src);
-        /* biClrImportant = */ SDL_ReadLE32(src);
+        Uint32 size[2] = { 0, 0 };
+        Uint16 planes[2] = { 0, 0 };
+        Uint32 info[6] = { 0, 0, 0, 0, 0, 0 };
+        SDL_ReadLE32Array(src, size, SDL_arraysize(size));
+        SDL_ReadLE16Array(src, planes, SDL_arraysize(planes));
+        SDL_ReadLE32Array(src, info, SDL_arraysize(info));
+        biWidth = size[0];
+        biHeight = size[1];
+        /* biPlanes = planes[0] */
+        biBitCount = planes[1];
+        biCompression = info[0];
+        /* biSizeImage = info[1] */
+        /* biXPelsPerMeter = info[2] */
+        /* biYPelsPerMeter = info[3] */
+        biClrUsed = info[4];
+        /* biClrImportant = info[5] */
 
         /* 64 == BITMAPCOREHEADER2, an incompatible OS/2 2.x extension. Skip this stuff for now. */
         if (biSize == 64) {
@@ -192,25 +259,27 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
                speaking, this is the bmiColors field in BITMAPINFO immediately
                following the legacy v1 info header, just past biSize. */
             if (biCompression == BI_BITFIELDS) {
+                Uint32 masks[4] = { 0, 0, 0, 0 };
                 haveRGBMasks = SDL_TRUE;
-                Rmask = SDL_ReadLE32(src);
-                Gmask = SDL_ReadLE32(src);
-                Bmask = SDL_ReadLE32(src);
 
                 /* ...v3 adds an alpha mask. */
                 if (biSize >= 56) {  /* BITMAPV3INFOHEADER; adds alpha mask */
                     haveAlphaMask = SDL_TRUE;
-                    Amask = SDL_ReadLE32(src);
+                }
+                SDL_ReadLE32Array(src, masks, haveAlphaMask ? 4 : 3);
+                Rmask = masks[0];
+                Gmask = masks[1];
+                Bmask = masks[2];
+                if (haveAlphaMask) {
+                    Amask = masks[3];
                 }
             } else {
                 /* the mask fields are ignored for v2+ headers if not BI_BITFIELD. */
                 if (biSize >= 52) {  /* BITMAPV2INFOHEADER; adds RGB masks */
-                    /*Rmask = */ SDL_ReadLE32(src);
-                    /*Gmask = */ SDL_ReadLE32(src);
-                    /*Bmask = */ SDL_ReadLE32(src);
+                    SDL_RWseek(src, 3 * sizeof (Uint32), RW_SEEK_CUR);
                 }
                 if (biSize >= 56) {  /* BITMAPV3INFOHEADER; adds alpha mask */
-                    /*Amask = */ SDL_ReadLE32(src);
+                    SDL_RWseek(src, sizeof (Uint32), RW_SEEK_CUR);
                 }
             }
 
@@ -307,17 +376,48 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
     }
 
     /* Create a compatible surface, note that the colors are RGB ordered */
-    surface =
-        SDL_CreateRGBSurface(0, biWidth, biHeight, biBitCount, Rmask, Gmask,
-                             Bmask, Amask);
-    if (surface == NULL) {
-        was_error = SDL_TRUE;
-        goto done;
+    native = SDL_MasksToPixelFormatEnum(biBitCount, Rmask, Gmask, Bmask, Amask);
+    if (format != SDL_PIXELFORMAT_UNKNOWN && format != native &&
+        !SDL_ISPIXELFORMAT_INDEXED(format) && !SDL_ISPIXELFORMAT_FOURCC(format)) {
+        convert = SDL_TRUE;
+    }
+    if (convert) {
+        surface = SDL_CreateRGBSurfaceWithFormat(0, biWidth, biHeight, 0, format);
+        if (surface == NULL) {
+            was_error = SDL_TRUE;
+            goto done;
+        }
+        decode =
+            SDL_CreateRGBSurface(0, biWidth, 1, biBitCount, Rmask, Gmask,
+                                 Bmask, Amask);
+        if (decode == NULL) {
+            was_error = SDL_TRUE;
+            goto done;
+        }
+        SDL_SetSurfaceBlendMode(decode, SDL_BLENDMODE_NONE);
+        /* Without an alpha channel to fill in there's nothing to correct */
+        if (!surface->format->Amask) {
+            correctAlpha = SDL_FALSE;
+        }
+    } else {
+        surface =
+            SDL_CreateRGBSurface(0, biWidth, biHeight, biBitCount, Rmask, Gmask,
+                                 Bmask, Amask);
+        if (surface == NULL) {
+            was_error = SDL_TRUE;
+            goto done;
+        }
+        decode = surface;
     }
 
     /* Load the palette, if any */
-    palette = (surface->format)->palette;
+    palette = (decode->format)->palette;
     if (palette) {
+        const size_t entry_size = (biSize == 12) ? 3 : 4;
+        const Uint8 *entries;
+        Uint8 buffer[256 * 4];
+        size_t available;
+
         SDL_assert(biBitCount <= 8);
         if (biClrUsed == 0) {
             biClrUsed = 1 << biBitCount;
@@ -343,27 +443,30 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
         } else if ((int) biClrUsed < palette->ncolors) {
             palette->ncolors = biClrUsed;
         }
-        if (biSize == 12) {
-            for (i = 0; i < (int) biClrUsed; ++i) {
-                SDL_RWread(src, &palette->colors[i].b, 1, 1);
-                SDL_RWread(src, &palette->colors[i].g, 1, 1);
-                SDL_RWread(src, &palette->colors[i].r, 1, 1);
-                palette->colors[i].a = SDL_ALPHA_OPAQUE;
-            }
+        entries = (const Uint8 *) SDL_RWGetPointer(src, &available);
+        if (entries && available >= biClrUsed * entry_size) {
+            /* The stream is in memory, so parse the palette in place */
+            SDL_RWseek(src, biClrUsed * entry_size, RW_SEEK_CUR);
         } else {
-            for (i = 0; i < (int) biClrUsed; ++i) {
-                SDL_RWread(src, &palette->colors[i].b, 1, 1);
-                SDL_RWread(src, &palette->colors[i].g, 1, 1);
-                SDL_RWread(src, &palette->colors[i].r, 1, 1);
-                SDL_RWread(src, &palette->colors[i].a, 1, 1);
-
-                /* According to Microsoft documentation, the fourth element
-                   is reserved and must be zero, so we shouldn't treat it as
-                   alpha.
-                */
-                palette->colors[i].a = SDL_ALPHA_OPAQUE;
+            /* Read the whole palette at once and parse it from there */
+            entries = buffer;
+            if (SDL_RWread(src, buffer, entry_size, biClrUsed) != biClrUsed) {
+                SDL_Error(SDL_EFREAD);
+                was_error = SDL_TRUE;
+                goto done;
             }
         }
+        for (i = 0; i < (int) biClrUsed; ++i) {
+            palette->colors[i].b = entries[0];
+            palette->colors[i].g = entries[1];
+            palette->colors[i].r = entries[2];
+            /* According to Microsoft documentation, the fourth element
+               is reserved and must be zero, so we shouldn't treat it as
+               alpha.
+            */
+            palette->colors[i].a = SDL_ALPHA_OPAQUE;
+            entries += entry_size;
+        }
     }
 
     /* Read the surface pixels.  Note that the bmp image is upside down */
@@ -372,8 +475,6 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
         was_error = SDL_TRUE;
         goto done;
     }
-    top = (Uint8 *)surface->pixels;
-    end = (Uint8 *)surface->pixels+(surface->h*surface->pitch);
     switch (ExpandBMP) {
     case 1:
         bmpPitch = (biWidth + 7) >> 3;
@@ -384,15 +485,21 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
         pad = (((bmpPitch) % 4) ? (4 - ((bmpPitch) % 4)) : 0);
         break;
     default:
-        pad = ((surface->pitch % 4) ? (4 - (surface->pitch % 4)) : 0);
+        pad = ((decode->pitch % 4) ? (4 - (decode->pitch % 4)) : 0);
         break;
     }
-    if (topDown) {
-        bits = top;
-    } else {
-        bits = end - surface->pitch;
-    }
-    while (bits >= top && bits < end) {
+    srcrect.x = 0;
+    srcrect.y = 0;
+    srcrect.w = surface->w;
+    srcrect.h = 1;
+    for (y = 0; y < surface->h; ++y) {
+        const int row = topDown ? y : (surface->h - 1 - y);
+
+        if (convert) {
+            bits = (Uint8 *)decode->pixels;
+        } else {
+            bits = (Uint8 *)surface->pixels + row * surface->pitch;
+        }
         switch (ExpandBMP) {
         case 1:
         case 4:{
@@ -418,7 +525,17 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
             break;
 
         default:
-            if (SDL_RWread(src, bits, 1, surface->pitch) != surface->pitch) {
+            /* Wider pixels are little endian, swap them as they're read if
+               needed. Note that the 24bpp case has already been taken care
+               of above. */
+            if (biBitCount == 15 || biBitCount == 16) {
+                rowread = SDL_ReadLE16Array(src, (Uint16 *) bits, decode->pitch / 2) * 2;
+            } else if (biBitCount == 32) {
+                rowread = SDL_ReadLE32Array(src, (Uint32 *) bits, decode->pitch / 4) * 4;
+            } else {
+                rowread = SDL_RWread(src, bits, 1, decode->pitch);
+            }
+            if (rowread != (size_t) decode->pitch) {
                 SDL_Error(SDL_EFREAD);
                 was_error = SDL_TRUE;
                 goto done;
@@ -432,45 +549,53 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
 					}
 				}
 			}
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-            /* Byte-swap the pixels if needed. Note that the 24bpp
-               case has already been taken care of above. */
-            switch (biBitCount) {
-            case 15:
-            case 16:{
-                    Uint16 *pix = (Uint16 *) bits;
-                    for (i = 0; i < surface->w; i++)
-                        pix[i] = SDL_Swap16(pix[i]);
-                    break;
-                }
-
-            case 32:{
-                    Uint32 *pix = (Uint32 *) bits;
-                    for (i = 0; i < surface->w; i++)
-                        pix[i] = SDL_Swap32(pix[i]);
-                    break;
-                }
-            }
-#endif
             break;
         }
         /* Skip padding bytes, ugh */
         if (pad) {
-            Uint8 padbyte;
-            for (i = 0; i < pad; ++i) {
-                SDL_RWread(src, &padbyte, 1, 1);
-            }
+            Uint8 padbytes[4];
+            SDL_RWread(src, padbytes, 1, pad);
         }
-        if (topDown) {
-            bits += surface->pitch;
-        } else {
-            bits -= surface->pitch;
+        if (convert) {
+            /* Until some pixel has alpha, the image is taken to be opaque */
+            if (correctAlpha && !sawAlpha) {
+                if (RowHasAlpha((const Uint32 *) bits, surface->w)) {
+                    sawAlpha = SDL_TRUE;
+                    if (topDown) {
+                        ClearAlphaChannel(surface, 0, y);
+                    } else {
+                        ClearAlphaChannel(surface, row + 1, y);
+                    }
+                } else {
+                    SetRowOpaque((Uint32 *) bits, surface->w);
+                }
+            }
+            dstrect = srcrect;
+            dstrect.y = row;
+            if (SDL_LowerBlit(decode, &srcrect, surface, &dstrect) < 0) {
+                was_error = SDL_TRUE;
+                goto done;
+            }
         }
     }
-    if (correctAlpha) {
+    if (correctAlpha && !convert) {
         CorrectAlphaChannel(surface);
     }
+    if (format != SDL_PIXELFORMAT_UNKNOWN && !convert &&
+        surface->format->format != format) {
+        /* Indexed and YUV formats need the whole image to convert */
+        SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface, format, 0);
+        if (converted == NULL) {
+            was_error = SDL_TRUE;
+            goto done;
+        }
+        SDL_FreeSurface(surface);
+        surface = decode = converted;
+    }
   done:
+    if (decode != surface) {
+        SDL_FreeSurface(decode);
+    }
     if (was_error) {
         if (src) {
             SDL_RWseek(src, fp_offset, RW_SEEK_SET);
@@ -484,6 +609,18 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
     return (surface);
 }
 
+SDL_Surface *
+SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
+{
+    return LoadBMP(src, freesrc, SDL_PIXELFORMAT_UNKNOWN);
+}
+
+SDL_Surface *
+SDL_LoadBMPFormat_RW(SDL_RWops * src, int freesrc, Uint32 format)
+{
+    return LoadBMP(src, freesrc, format);
+}
+
 int
 SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
 {
@@ -651,9 +788,7 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
             SDL_WriteLE32(dst, bV4BlueMask);
             SDL_WriteLE32(dst, bV4AlphaMask);
             SDL_WriteLE32(dst, bV4CSType);
-            for (i = 0; i < 3 * 3; i++) {
-                SDL_WriteLE32(dst, bV4Endpoints[i]);
-            }
+            SDL_WriteLE32Array(dst, (const Uint32 *) bV4Endpoints, SDL_arraysize(bV4Endpoints));
             SDL_WriteLE32(dst, bV4GammaRed);
             SDL_WriteLE32(dst, bV4GammaGreen);
             SDL_WriteLE32(dst, bV4GammaBlue);
@@ -666,11 +801,16 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
 
             colors = surface->format->palette->colors;
             ncolors = surface->format->palette->ncolors;
-            for (i = 0; i < ncolors; ++i) {
-                SDL_RWwrite(dst, &colors[i].b, 1, 1);
-                SDL_RWwrite(dst, &colors[i].g, 1, 1);
-                SDL_RWwrite(dst, &colors[i].r, 1, 1);
-                SDL_RWwrite(dst, &colors[i].a, 1, 1);
+            while (ncolors > 0) {
+                Uint32 entries[256];
+                const int count = SDL_min(ncolors, (int) SDL_arraysize(entries));
+                for (i = 0; i < count; ++i) {
+                    entries[i] = ((Uint32) colors[i].a << 24) | ((Uint32) colors[i].r << 16) |
+                                 ((Uint32) colors[i].g << 8) | colors[i].b;
+                }
+                SDL_WriteLE32Array(dst, entries, count);
+                colors += count;
+                ncolors -= count;
             }
         }
 
@@ -694,10 +834,8 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
                 break;
             }
             if (pad) {
-                const Uint8 padbyte = 0;
-                for (i = 0; i < pad; ++i) {
-                    SDL_RWwrite(dst, &padbyte, 1, 1);
-                }
+                static const Uint8 padbytes[4] = { 0, 0, 0, 0 };
+                SDL_RWwrite(dst, padbytes, 1, pad);
             }
         }
 
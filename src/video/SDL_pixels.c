@@ -23,6 +23,7 @@
 /* General (mostly internal) pixel/color manipulation routines for SDL */
 
 #include "SDL_endian.h"
+#include "SDL_hints.h"
 #include "SDL_video.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
@@ -489,47 +490,77 @@ SDL_MasksToPixelFormatEnum(int bpp, Uint32 Rmask, Uint32 Gmask, Uint32 Bmask,
     return SDL_PIXELFORMAT_UNKNOWN;
 }
 
-static SDL_PixelFormat *formats;
+/* The RGB formats never change once they're set up, so each one is
+   allocated the first time it's asked for and then shared for the life of
+   the process.  They're kept in a table indexed by the type, order and
+   layout of the format enum, so finding one doesn't need a lock.
+   Palettized formats each get their own refcounted allocation, since the
+   palette belongs to the format. */
+#define FORMAT_TABLE_TYPES      (SDL_PIXELTYPE_ARRAYF32 - SDL_PIXELTYPE_PACKED8 + 1)
+#define FORMAT_TABLE_ORDERS     (SDL_PACKEDORDER_BGRA + 1)
+#define FORMAT_TABLE_LAYOUTS    (SDL_PACKEDLAYOUT_1010102 + 1)
+
+static SDL_PixelFormat *format_table[FORMAT_TABLE_TYPES * FORMAT_TABLE_ORDERS * FORMAT_TABLE_LAYOUTS];
 static SDL_SpinLock formats_lock = 0;
 
-SDL_PixelFormat *
-SDL_AllocFormat(Uint32 pixel_format)
+static int
+GetFormatTableIndex(Uint32 pixel_format)
 {
-    SDL_PixelFormat *format;
+    Uint32 type, order, layout;
 
-    SDL_AtomicLock(&formats_lock);
+    if (SDL_ISPIXELFORMAT_FOURCC(pixel_format) || SDL_ISPIXELFORMAT_INDEXED(pixel_format)) {
+        return -1;
+    }
+    type = SDL_PIXELTYPE(pixel_format);
+    order = SDL_PIXELORDER(pixel_format);
+    layout = SDL_PIXELLAYOUT(pixel_format);
+    if (type < SDL_PIXELTYPE_PACKED8 || type > SDL_PIXELTYPE_ARRAYF32 ||
+        order >= FORMAT_TABLE_ORDERS || layout >= FORMAT_TABLE_LAYOUTS) {
+        return -1;
+    }
+    return (int)(((type - SDL_PIXELTYPE_PACKED8) * FORMAT_TABLE_ORDERS + order) * FORMAT_TABLE_LAYOUTS + layout);
+}
 
-    /* Look it up in our list of previously allocated formats */
-    for (format = formats; format; format = format->next) {
-        if (pixel_format == format->format) {
-            ++format->refcount;
-            SDL_AtomicUnlock(&formats_lock);
-            return format;
+SDL_PixelFormat *
+SDL_AllocFormat(Uint32 pixel_format)
+{
+    SDL_PixelFormat *format, *shared;
+    const int index = GetFormatTableIndex(pixel_format);
+
+    /* Look it up in our table of previously allocated formats */
+    if (index >= 0) {
+        shared = (SDL_PixelFormat *)SDL_AtomicGetPtr((void **)&format_table[index]);
+        if (shared && shared->format == pixel_format) {
+            return shared;
         }
     }
 
     /* Allocate an empty pixel format structure, and initialize it */
     format = SDL_malloc(sizeof(*format));
     if (format == NULL) {
-        SDL_AtomicUnlock(&formats_lock);
         SDL_OutOfMemory();
         return NULL;
     }
     if (SDL_InitFormat(format, pixel_format) < 0) {
-        SDL_AtomicUnlock(&formats_lock);
         SDL_free(format);
         SDL_InvalidParamError("format");
         return NULL;
     }
 
-    if (!SDL_ISPIXELFORMAT_INDEXED(pixel_format)) {
-        /* Cache the RGB formats */
-        format->next = formats;
-        formats = format;
+    if (index >= 0) {
+        /* Share it, unless another thread got there first */
+        if (SDL_AtomicCASPtr((void **)&format_table[index], NULL, format)) {
+            return format;
+        }
+        shared = (SDL_PixelFormat *)SDL_AtomicGetPtr((void **)&format_table[index]);
+        if (shared->format == pixel_format) {
+            SDL_free(format);
+            return shared;
+        }
+        /* A format enum we don't know took this slot, fall back to a
+           refcounted allocation */
     }
 
-    SDL_AtomicUnlock(&formats_lock);
-
     return format;
 }
 
@@ -601,32 +632,24 @@ SDL_InitFormat(SDL_PixelFormat * format, Uint32 pixel_format)
 void
 SDL_FreeFormat(SDL_PixelFormat *format)
 {
-    SDL_PixelFormat *prev;
+    int index;
 
     if (!format) {
         SDL_InvalidParamError("format");
         return;
     }
 
-    SDL_AtomicLock(&formats_lock);
+    /* Shared formats stay around for the next surface that needs them */
+    index = GetFormatTableIndex(format->format);
+    if (index >= 0 && SDL_AtomicGetPtr((void **)&format_table[index]) == format) {
+        return;
+    }
 
+    SDL_AtomicLock(&formats_lock);
     if (--format->refcount > 0) {
         SDL_AtomicUnlock(&formats_lock);
         return;
     }
-
-    /* Remove this format from our list */
-    if (format == formats) {
-        formats = format->next;
-    } else if (formats) {
-        for (prev = formats; prev->next; prev = prev->next) {
-            if (prev->next == format) {
-                prev->next = format->next;
-                break;
-            }
-        }
-    }
-
     SDL_AtomicUnlock(&formats_lock);
 
     if (format->palette) {
@@ -673,7 +696,9 @@ SDL_SetPixelFormatPalette(SDL_PixelFormat * format, SDL_Palette *palette)
         return SDL_SetError("SDL_SetPixelFormatPalette() passed NULL format");
     }
 
-    if (palette && palette->ncolors > (1 << format->BitsPerPixel)) {
+    /* The RGB formats are shared, so they can't be given a palette */
+    if (palette && (!SDL_ISPIXELFORMAT_INDEXED(format->format) ||
+                    palette->ncolors > (1 << format->BitsPerPixel))) {
         return SDL_SetError("SDL_SetPixelFormatPalette() passed a palette that doesn't match the format");
     }
 
@@ -721,9 +746,71 @@ SDL_SetPaletteColors(SDL_Palette * palette, const SDL_Color * colors,
     return status;
 }
 
+/* The inverse color maps in use, at most one per palette and dither mode */
+static SDL_InverseColorMap *inverse_maps = NULL;
+static SDL_SpinLock inverse_maps_lock = 0;
+
+static SDL_InverseColorMap *
+SDL_AcquireInverseColorMap(SDL_Palette * palette, SDL_bool dither)
+{
+    SDL_InverseColorMap *map;
+
+    SDL_AtomicLock(&inverse_maps_lock);
+    for (map = inverse_maps; map; map = map->next) {
+        if (map->palette == palette && map->dither == dither) {
+            break;
+        }
+    }
+    if (map) {
+        /* Maps are remade when their palette changes, so start over */
+        if (map->version != palette->version) {
+            SDL_zero(map->filled);
+            map->version = palette->version;
+        }
+        ++map->refcount;
+    } else {
+        /* The table starts out empty and fills in as colors are blitted */
+        map = (SDL_InverseColorMap *) SDL_calloc(1, sizeof(*map));
+        if (map) {
+            map->palette = palette;
+            map->version = palette->version;
+            map->dither = dither;
+            map->refcount = 1;
+            map->next = inverse_maps;
+            inverse_maps = map;
+        }
+    }
+    SDL_AtomicUnlock(&inverse_maps_lock);
+
+    if (!map) {
+        SDL_OutOfMemory();
+    }
+    return map;
+}
+
+static void
+SDL_ReleaseInverseColorMap(SDL_InverseColorMap * map)
+{
+    SDL_InverseColorMap **prev;
+
+    SDL_AtomicLock(&inverse_maps_lock);
+    if (--map->refcount > 0) {
+        map = NULL;
+    } else {
+        for (prev = &inverse_maps; *prev != map; prev = &(*prev)->next) {
+        }
+        *prev = map->next;
+    }
+    SDL_AtomicUnlock(&inverse_maps_lock);
+
+    SDL_free(map);
+}
+
 void
 SDL_FreePalette(SDL_Palette * palette)
 {
+    SDL_InverseColorMap *map;
+
     if (!palette) {
         SDL_InvalidParamError("palette");
         return;
@@ -731,6 +818,16 @@ SDL_FreePalette(SDL_Palette * palette)
     if (--palette->refcount > 0) {
         return;
     }
+
+    /* A new palette at the same address mustn't find the old tables */
+    SDL_AtomicLock(&inverse_maps_lock);
+    for (map = inverse_maps; map; map = map->next) {
+        if (map->palette == palette) {
+            map->palette = NULL;
+        }
+    }
+    SDL_AtomicUnlock(&inverse_maps_lock);
+
     SDL_free(palette->colors);
     SDL_free(palette);
 }
@@ -933,19 +1030,53 @@ Map1toN(SDL_PixelFormat * src, Uint8 Rmod, Uint8 Gmod, Uint8 Bmod, Uint8 Amod,
     return (map);
 }
 
-/* Map from BitField to Dithered-Palette to Palette */
-static Uint8 *
+/* Find the palette entry nearest an RGB 5-6-5 color for an inverse map */
+Uint8
+SDL_FillInverseColor(SDL_InverseColorMap * map, SDL_Palette * pal, Uint32 cell)
+{
+    const Uint32 r = (cell >> 11) & 0x1F;
+    const Uint32 g = (cell >> 5) & 0x3F;
+    const Uint32 b = cell & 0x1F;
+    const Uint32 bit = 1U << (cell & 31);
+    SDL_atomic_t *filled = &map->filled[cell >> 5];
+    Uint8 pixel;
+    int value;
+
+    /* Widen the fields so that black and white stay exact */
+    pixel = SDL_FindColor(pal, (Uint8)((r << 3) | (r >> 2)),
+                          (Uint8)((g << 2) | (g >> 4)),
+                          (Uint8)((b << 3) | (b >> 2)), SDL_ALPHA_OPAQUE);
+    map->index[cell] = pixel;
+
+    /* Other threads may be filling in the same word, and mustn't see the
+       bit before the entry */
+    SDL_MemoryBarrierRelease();
+    do {
+        value = SDL_AtomicGet(filled);
+    } while (!SDL_AtomicCAS(filled, value, (int)((Uint32)value | bit)));
+    return pixel;
+}
+
+/* Map from BitField to Palette */
+static SDL_InverseColorMap *
 MapNto1(SDL_PixelFormat * src, SDL_PixelFormat * dst, int *identical)
 {
-    /* Generate a 256 color dither palette */
-    SDL_Palette dithered;
-    SDL_Color colors[256];
     SDL_Palette *pal = dst->palette;
+    const SDL_bool dither = SDL_GetHintBoolean(SDL_HINT_PALETTE_DITHER, SDL_FALSE);
+
+    /* A 3-3-2 palette can be written directly */
+    *identical = 0;
+    if (!dither && pal->ncolors >= 256) {
+        SDL_Color colors[256];
+
+        SDL_DitherColors(colors, 8);
+        if (SDL_memcmp(colors, pal->colors, sizeof(colors)) == 0) {
+            *identical = 1;
+            return (NULL);
+        }
+    }
 
-    dithered.ncolors = 256;
-    SDL_DitherColors(colors, 8);
-    dithered.colors = colors;
-    return (Map1to1(&dithered, pal, identical));
+    return SDL_AcquireInverseColorMap(pal, dither);
 }
 
 SDL_BlitMap *
@@ -968,12 +1099,10 @@ SDL_AllocBlitMap(void)
     return (map);
 }
 
-void
-SDL_InvalidateMap(SDL_BlitMap * map)
+/* Release the mapping to the current destination */
+static void
+SDL_ReleaseMap(SDL_BlitMap * map)
 {
-    if (!map) {
-        return;
-    }
     if (map->dst) {
         /* Release our reference to the surface - see the note below */
         if (--map->dst->refcount <= 0) {
@@ -983,10 +1112,127 @@ SDL_InvalidateMap(SDL_BlitMap * map)
     map->dst = NULL;
     map->src_palette_version = 0;
     map->dst_palette_version = 0;
-    SDL_free(map->info.table);
     map->info.table = NULL;
 }
 
+/* Free the color table, which may be shared with other mappings */
+static void
+SDL_FreeMapTable(SDL_BlitMap * map)
+{
+    if (map->inverse) {
+        SDL_ReleaseInverseColorMap(map->inverse);
+        map->inverse = NULL;
+    } else {
+        SDL_free(map->info.table);
+    }
+    map->info.table = NULL;
+}
+
+/* Only mappings to the shared RGB formats are cached: their format
+   pointers stay valid and unique, and they have no palette to change
+   under us.  RLE data is built for one destination, so it isn't cached. */
+static SDL_bool
+SDL_IsMapCacheable(SDL_BlitMap * map, SDL_PixelFormat * dstfmt)
+{
+    const int index = GetFormatTableIndex(dstfmt->format);
+
+    if (map->info.flags & SDL_COPY_RLE_DESIRED) {
+        return SDL_FALSE;
+    }
+    return (index >= 0 && SDL_AtomicGetPtr((void **)&format_table[index]) == dstfmt);
+}
+
+/* Move the current mapping to the front of the cache */
+static void
+SDL_StashMap(SDL_Surface * src)
+{
+    SDL_BlitMap *map = src->map;
+    SDL_BlitMapCacheEntry *entry;
+
+    if (!map->dst || !SDL_IsMapCacheable(map, map->dst->format)) {
+        SDL_FreeMapTable(map);
+        SDL_ReleaseMap(map);
+        return;
+    }
+
+    /* Evict the least recently used entry */
+    entry = &map->cache[SDL_BLITMAP_CACHE_SIZE - 1];
+    if (entry->dst_fmt) {
+        SDL_free(entry->table);
+    }
+    SDL_memmove(&map->cache[1], &map->cache[0], (SDL_BLITMAP_CACHE_SIZE - 1) * sizeof(*entry));
+
+    entry = &map->cache[0];
+    entry->dst_fmt = map->dst->format;
+    entry->src_palette_version = map->src_palette_version;
+    entry->flags = map->info.flags;
+    entry->identity = map->identity;
+    entry->blit = map->blit;
+    entry->data = map->data;
+    entry->table = map->info.table;
+    SDL_ReleaseMap(map);
+}
+
+/* Make a cached mapping to the destination current, if there is one */
+static SDL_bool
+SDL_RestoreMap(SDL_Surface * src, SDL_Surface * dst)
+{
+    SDL_BlitMap *map = src->map;
+    const Uint32 src_palette_version = src->format->palette ? src->format->palette->version : 0;
+    int i;
+
+    if (!SDL_IsMapCacheable(map, dst->format)) {
+        return SDL_FALSE;
+    }
+    for (i = 0; i < SDL_BLITMAP_CACHE_SIZE; ++i) {
+        SDL_BlitMapCacheEntry *entry = &map->cache[i];
+
+        if (!entry->dst_fmt) {
+            break;
+        }
+        if (entry->dst_fmt == dst->format &&
+            entry->src_palette_version == src_palette_version &&
+            entry->flags == map->info.flags) {
+            map->identity = entry->identity;
+            map->blit = entry->blit;
+            map->data = entry->data;
+            map->info.table = entry->table;
+            map->info.src_fmt = src->format;
+            map->info.src_pitch = src->pitch;
+            map->info.dst_fmt = dst->format;
+            map->info.dst_pitch = dst->pitch;
+            map->src_palette_version = src_palette_version;
+            map->dst_palette_version = 0;
+            map->dst = dst;
+            ++dst->refcount;
+
+            /* The entry is current now, so it leaves the cache */
+            SDL_memmove(&map->cache[i], &map->cache[i + 1], (SDL_BLITMAP_CACHE_SIZE - 1 - i) * sizeof(*entry));
+            SDL_zero(map->cache[SDL_BLITMAP_CACHE_SIZE - 1]);
+            return SDL_TRUE;
+        }
+    }
+    return SDL_FALSE;
+}
+
+void
+SDL_InvalidateMap(SDL_BlitMap * map)
+{
+    int i;
+
+    if (!map) {
+        return;
+    }
+    SDL_FreeMapTable(map);
+    SDL_ReleaseMap(map);
+
+    /* The cached mappings depend on the same source settings */
+    for (i = 0; i < SDL_BLITMAP_CACHE_SIZE; ++i) {
+        SDL_free(map->cache[i].table);
+    }
+    SDL_zero(map->cache);
+}
+
 int
 SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst)
 {
@@ -994,12 +1240,15 @@ SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst)
     SDL_PixelFormat *dstfmt;
     SDL_BlitMap *map;
 
-    /* Clear out any previous mapping */
+    /* Put away any previous mapping, and reuse one if we can */
     map = src->map;
     if ((src->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
         SDL_UnRLESurface(src, 1);
     }
-    SDL_InvalidateMap(map);
+    SDL_StashMap(src);
+    if (SDL_RestoreMap(src, dst)) {
+        return 0;
+    }
 
     /* Figure out what kind of mapping we're doing */
     map->identity = 0;
@@ -1029,7 +1278,8 @@ SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst)
     } else {
         if (SDL_ISPIXELFORMAT_INDEXED(dstfmt->format)) {
             /* BitField --> Palette */
-            map->info.table = MapNto1(srcfmt, dstfmt, &map->identity);
+            map->inverse = MapNto1(srcfmt, dstfmt, &map->identity);
+            map->info.table = (Uint8 *) map->inverse;
             if (!map->identity) {
                 if (map->info.table == NULL) {
                     return (-1);
@@ -528,4 +528,86 @@ SDL_GetSpanEnclosingRect(int width, int height,
     return SDL_FALSE;
 }
 
+/* Above this many rects, only neighbours in the list are merged */
+#define SDL_COALESCE_MAX_RECTS  64
+
+/* Overlapping and adjacent rects merge for free: their bounding box is no
+   larger than the two of them */
+static SDL_bool
+SDL_MergeRects(SDL_Rect * a, const SDL_Rect * b)
+{
+    SDL_Rect u;
+
+    SDL_UnionRect(a, b, &u);
+    if (u.w * u.h <= a->w * a->h + b->w * b->h) {
+        *a = u;
+        return SDL_TRUE;
+    }
+    return SDL_FALSE;
+}
+
+int
+SDL_CoalesceRects(int width, int height, int align,
+                  SDL_Rect * rects, int numrects)
+{
+    int i, j, count = 0;
+    int area = 0;
+    SDL_Rect bounds;
+    SDL_bool merged;
+
+    /* Clip to the surface and snap the left and right edges out to the
+       alignment, dropping anything that ends up empty */
+    for (i = 0; i < numrects; ++i) {
+        int x1 = SDL_max(rects[i].x, 0);
+        int y1 = SDL_max(rects[i].y, 0);
+        int x2 = SDL_min(rects[i].x + rects[i].w, width);
+        int y2 = SDL_min(rects[i].y + rects[i].h, height);
+
+        if (x2 <= x1 || y2 <= y1) {
+            continue;
+        }
+        if (align > 1) {
+            x1 -= x1 % align;
+            x2 = SDL_min(x2 + (align - 1) - (x2 + align - 1) % align, width);
+        }
+        rects[count].x = x1;
+        rects[count].y = y1;
+        rects[count].w = x2 - x1;
+        rects[count].h = y2 - y1;
+        if (count == 0 || numrects <= SDL_COALESCE_MAX_RECTS ||
+            !SDL_MergeRects(&rects[count - 1], &rects[count])) {
+            ++count;
+        }
+    }
+    if (count <= 1) {
+        return count;
+    }
+
+    if (count <= SDL_COALESCE_MAX_RECTS) {
+        do {
+            merged = SDL_FALSE;
+            for (i = 0; i < count; ++i) {
+                for (j = i + 1; j < count; ++j) {
+                    if (SDL_MergeRects(&rects[i], &rects[j])) {
+                        rects[j--] = rects[--count];
+                        merged = SDL_TRUE;
+                    }
+                }
+            }
+        } while (merged);
+    }
+
+    /* One rect is cheaper when the rects cover most of their bounds */
+    bounds = rects[0];
+    for (i = 0; i < count; ++i) {
+        SDL_UnionRect(&bounds, &rects[i], &bounds);
+        area += rects[i].w * rects[i].h;
+    }
+    if (area >= bounds.w * bounds.h / 4 * 3) {
+        rects[0] = bounds;
+        count = 1;
+    }
+    return count;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -26,6 +26,11 @@
 
 extern SDL_bool SDL_GetSpanEnclosingRect(int width, int height, int numrects, const SDL_Rect * rects, SDL_Rect *span);
 
+/* Clip a damage list to width x height, snap it out to multiples of align
+   pixels horizontally and merge rects where that's cheaper.  The rects are
+   rewritten in place and the new count is returned. */
+extern int SDL_CoalesceRects(int width, int height, int align, SDL_Rect * rects, int numrects);
+
 #endif /* SDL_rect_c_h_ */
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -27,6 +27,7 @@
 */
 
 #include "SDL_video.h"
+#include "SDL_jobs.h"
 #include "SDL_blit.h"
 
 /* This isn't ready for general consumption yet - it should be folded
@@ -196,6 +197,53 @@ copy_row3(Uint8 * src, int src_w, Uint8 * dst, int dst_w)
     }
 }
 
+typedef struct
+{
+    SDL_Surface *src;
+    const SDL_Rect *srcrect;
+    SDL_Surface *dst;
+    const SDL_Rect *dstrect;
+    int inc;
+} SDL_StretchRowsData;
+
+/* Stretch the destination rows [start, end).  Row n comes from source row
+   (n * inc) >> 16, the same one the incremental walk down the source
+   reaches, so bands can be stretched independently. */
+static void SDLCALL
+SDL_StretchRows(void *data, int start, int end)
+{
+    const SDL_StretchRowsData *rows = (const SDL_StretchRowsData *) data;
+    const SDL_Rect *srcrect = rows->srcrect;
+    const SDL_Rect *dstrect = rows->dstrect;
+    const int bpp = rows->dst->format->BytesPerPixel;
+    int row;
+
+    for (row = start; row < end; ++row) {
+        const int src_row = srcrect->y + (int) (((Sint64) row * rows->inc) >> 16);
+        Uint8 *srcp = (Uint8 *) rows->src->pixels + (src_row * rows->src->pitch)
+            + (srcrect->x * bpp);
+        Uint8 *dstp = (Uint8 *) rows->dst->pixels + ((dstrect->y + row) * rows->dst->pitch)
+            + (dstrect->x * bpp);
+
+        switch (bpp) {
+        case 1:
+            copy_row1(srcp, srcrect->w, dstp, dstrect->w);
+            break;
+        case 2:
+            copy_row2((Uint16 *) srcp, srcrect->w,
+                      (Uint16 *) dstp, dstrect->w);
+            break;
+        case 3:
+            copy_row3(srcp, srcrect->w, dstp, dstrect->w);
+            break;
+        case 4:
+            copy_row4((Uint32 *) srcp, srcrect->w,
+                      (Uint32 *) dstp, dstrect->w);
+            break;
+        }
+    }
+}
+
 /* Perform a stretch blit between two surfaces of the same format.
    NOTE:  This function is not safe to call from multiple threads!
 */
@@ -205,20 +253,21 @@ SDL_SoftStretch(SDL_Surface * src, const SDL_Rect * srcrect,
 {
     int src_locked;
     int dst_locked;
-    int pos, inc;
+    int inc;
+    SDL_Rect full_src;
+    SDL_Rect full_dst;
+#ifdef USE_ASM_STRETCH
+    int pos;
     int dst_maxrow;
     int src_row, dst_row;
     Uint8 *srcp = NULL;
     Uint8 *dstp;
-    SDL_Rect full_src;
-    SDL_Rect full_dst;
-#ifdef USE_ASM_STRETCH
     SDL_bool use_asm = SDL_TRUE;
 #ifdef __GNUC__
     int u1, u2;
 #endif
-#endif /* USE_ASM_STRETCH */
     const int bpp = dst->format->BytesPerPixel;
+#endif /* USE_ASM_STRETCH */
 
     if (src->format->format != dst->format->format) {
         return SDL_SetError("Only works with same format surfaces");
@@ -273,12 +322,13 @@ SDL_SoftStretch(SDL_Surface * src, const SDL_Rect * srcrect,
     }
 
     /* Set up the data... */
-    pos = 0x10000;
     inc = (srcrect->h << 16) / dstrect->h;
+
+#ifdef USE_ASM_STRETCH
+    pos = 0x10000;
     src_row = srcrect->y;
     dst_row = dstrect->y;
 
-#ifdef USE_ASM_STRETCH
     /* Write the opcodes for this stretch */
     if ((bpp == 3) || (generate_rowbytes(srcrect->w, dstrect->w, bpp) < 0)) {
         use_asm = SDL_FALSE;
@@ -286,17 +336,17 @@ SDL_SoftStretch(SDL_Surface * src, const SDL_Rect * srcrect,
 #endif
 
     /* Perform the stretch blit */
-    for (dst_maxrow = dst_row + dstrect->h; dst_row < dst_maxrow; ++dst_row) {
-        dstp = (Uint8 *) dst->pixels + (dst_row * dst->pitch)
-            + (dstrect->x * bpp);
-        while (pos >= 0x10000L) {
-            srcp = (Uint8 *) src->pixels + (src_row * src->pitch)
-                + (srcrect->x * bpp);
-            ++src_row;
-            pos -= 0x10000L;
-        }
 #ifdef USE_ASM_STRETCH
-        if (use_asm) {
+    if (use_asm) {
+        for (dst_maxrow = dst_row + dstrect->h; dst_row < dst_maxrow; ++dst_row) {
+            dstp = (Uint8 *) dst->pixels + (dst_row * dst->pitch)
+                + (dstrect->x * bpp);
+            while (pos >= 0x10000L) {
+                srcp = (Uint8 *) src->pixels + (src_row * src->pitch)
+                    + (srcrect->x * bpp);
+                ++src_row;
+                pos -= 0x10000L;
+            }
 #ifdef __GNUC__
             __asm__ __volatile__("call *%4":"=&D"(u1), "=&S"(u2)
                                  :"0"(dstp), "1"(srcp), "r"(copy_row)
@@ -319,25 +369,23 @@ SDL_SoftStretch(SDL_Surface * src, const SDL_Rect * srcrect,
 #else
 #error Need inline assembly for this compiler
 #endif
-        } else
+            pos += inc;
+        }
+    } else
 #endif
-            switch (bpp) {
-            case 1:
-                copy_row1(srcp, srcrect->w, dstp, dstrect->w);
-                break;
-            case 2:
-                copy_row2((Uint16 *) srcp, srcrect->w,
-                          (Uint16 *) dstp, dstrect->w);
-                break;
-            case 3:
-                copy_row3(srcp, srcrect->w, dstp, dstrect->w);
-                break;
-            case 4:
-                copy_row4((Uint32 *) srcp, srcrect->w,
-                          (Uint32 *) dstp, dstrect->w);
-                break;
-            }
-        pos += inc;
+    {
+        SDL_StretchRowsData rows;
+
+        rows.src = src;
+        rows.srcrect = srcrect;
+        rows.dst = dst;
+        rows.dstrect = dstrect;
+        rows.inc = inc;
+        if (SDL_ShouldConvertInParallel(dstrect->w, dstrect->h)) {
+            SDL_ParallelFor(0, dstrect->h, 0, SDL_StretchRows, &rows);
+        } else {
+            SDL_StretchRows(&rows, 0, dstrect->h);
+        }
     }
 
     /* We need to unlock the surfaces if they're locked */
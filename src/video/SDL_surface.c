@@ -1020,7 +1020,9 @@ SDL_ConvertSurface(SDL_Surface * surface, const SDL_PixelFormat * format,
     bounds.y = 0;
     bounds.w = surface->w;
     bounds.h = surface->h;
+    surface->map->parallel = SDL_TRUE;
     ret = SDL_LowerBlit(surface, &bounds, convert, &bounds);
+    surface->map->parallel = SDL_FALSE;
 
     /* Clean up the original surface, and update converted surface */
     convert->map->info.r = copy_color.r;
@@ -1223,6 +1225,7 @@ int SDL_ConvertPixels(int width, int height,
                                   &dst_surface, &dst_fmt, &dst_blitmap)) {
         return -1;
     }
+    src_blitmap.parallel = SDL_TRUE;
 
     /* Set up the rect and go! */
     rect.x = 0;
@@ -1232,6 +1235,248 @@ int SDL_ConvertPixels(int width, int height,
     return SDL_LowerBlit(&src_surface, &rect, &dst_surface, &rect);
 }
 
+struct SDL_PixelConverter
+{
+    int width;
+    int height;
+    Uint32 src_format;
+    Uint32 dst_format;
+
+    /* The blit between RGB formats, or NULL if there isn't one */
+    SDL_BlitFunc blit;
+    SDL_Surface src_surface, dst_surface;
+    SDL_PixelFormat src_fmt, dst_fmt;
+    SDL_BlitMap src_blitmap, dst_blitmap;
+
+    /* YUV formats convert through ARGB8888 when there's no direct path */
+    SDL_PixelConverter *stage;
+    void *tmp;
+    int tmp_pitch;
+};
+
+/*
+ * Set up a conversion of blocks of pixels for SDL_RunPixelConverter()
+ */
+SDL_PixelConverter *
+SDL_CreatePixelConverter(Uint32 src_format, Uint32 dst_format, int width, int height)
+{
+    SDL_PixelConverter *converter;
+    const SDL_bool src_yuv = SDL_ISPIXELFORMAT_FOURCC(src_format) ? SDL_TRUE : SDL_FALSE;
+    const SDL_bool dst_yuv = SDL_ISPIXELFORMAT_FOURCC(dst_format) ? SDL_TRUE : SDL_FALSE;
+
+    if (width < 0) {
+        SDL_InvalidParamError("width");
+        return NULL;
+    }
+    if (height < 0) {
+        SDL_InvalidParamError("height");
+        return NULL;
+    }
+
+    converter = (SDL_PixelConverter *) SDL_calloc(1, sizeof(*converter));
+    if (!converter) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    converter->width = width;
+    converter->height = height;
+    converter->src_format = src_format;
+    converter->dst_format = dst_format;
+
+    if (src_yuv && !dst_yuv) {
+        if (dst_format != SDL_PIXELFORMAT_ARGB8888) {
+            converter->stage = SDL_CreatePixelConverter(SDL_PIXELFORMAT_ARGB8888, dst_format, width, height);
+            if (!converter->stage) {
+                SDL_FreePixelConverter(converter);
+                return NULL;
+            }
+        }
+    } else if (dst_yuv && !src_yuv) {
+        if (src_format != SDL_PIXELFORMAT_ARGB8888) {
+            converter->stage = SDL_CreatePixelConverter(src_format, SDL_PIXELFORMAT_ARGB8888, width, height);
+            converter->tmp_pitch = width * sizeof(Uint32);
+            converter->tmp = SDL_malloc(converter->tmp_pitch * height + 1);
+            if (!converter->stage || !converter->tmp) {
+                if (converter->stage) {
+                    SDL_OutOfMemory();
+                }
+                SDL_FreePixelConverter(converter);
+                return NULL;
+            }
+        }
+    } else if (!src_yuv && src_format != dst_format) {
+        if (!SDL_CreateSurfaceOnStack(width, height, src_format, NULL, 0,
+                                      &converter->src_surface, &converter->src_fmt,
+                                      &converter->src_blitmap) ||
+            !SDL_CreateSurfaceOnStack(width, height, dst_format, NULL, 0,
+                                      &converter->dst_surface, &converter->dst_fmt,
+                                      &converter->dst_blitmap) ||
+            SDL_MapSurface(&converter->src_surface, &converter->dst_surface) < 0) {
+            SDL_FreePixelConverter(converter);
+            return NULL;
+        }
+        converter->blit = (SDL_BlitFunc) converter->src_blitmap.data;
+    }
+    return converter;
+}
+
+/* Convert width x height pixels, which may be less than the converter size */
+static int
+SDL_RunPixelConverterBlock(SDL_PixelConverter * converter, int width, int height,
+                           const void * src, int src_pitch,
+                           void * dst, int dst_pitch)
+{
+    if (converter->blit) {
+        /* The stack surfaces never need locking, so skip SDL_SoftBlit() */
+        SDL_BlitInfo *info = &converter->src_blitmap.info;
+
+        if (width == 0 || height == 0) {
+            return 0;
+        }
+        info->src = (Uint8 *) src;
+        info->src_w = width;
+        info->src_h = height;
+        info->src_pitch = src_pitch;
+        info->src_skip = src_pitch - width * converter->src_fmt.BytesPerPixel;
+        info->dst = (Uint8 *) dst;
+        info->dst_w = width;
+        info->dst_h = height;
+        info->dst_pitch = dst_pitch;
+        info->dst_skip = dst_pitch - width * converter->dst_fmt.BytesPerPixel;
+        SDL_RunBlitRows(converter->blit, info);
+        return 0;
+    }
+
+    if (SDL_ISPIXELFORMAT_FOURCC(converter->src_format) && !SDL_ISPIXELFORMAT_FOURCC(converter->dst_format)) {
+        int ret;
+
+        if (!converter->stage) {
+            return SDL_ConvertPixels_YUV_to_RGB(width, height, converter->src_format, src, src_pitch,
+                                                converter->dst_format, dst, dst_pitch);
+        }
+        ret = SDL_ConvertPixels_YUV_to_RGB_Direct(width, height, converter->src_format, src, src_pitch,
+                                                  converter->dst_format, dst, dst_pitch);
+        if (ret != 0) {
+            return (ret < 0) ? ret : 0;
+        }
+
+        /* No direct path, go through ARGB8888 in a buffer kept for the next frame */
+        if (!converter->tmp) {
+            converter->tmp_pitch = width * sizeof(Uint32);
+            converter->tmp = SDL_malloc(converter->tmp_pitch * height + 1);
+            if (!converter->tmp) {
+                return SDL_OutOfMemory();
+            }
+        }
+        if (SDL_ConvertPixels_YUV_to_RGB(width, height, converter->src_format, src, src_pitch,
+                                         SDL_PIXELFORMAT_ARGB8888, converter->tmp, converter->tmp_pitch) < 0) {
+            return -1;
+        }
+        return SDL_RunPixelConverter(converter->stage, converter->tmp, converter->tmp_pitch, dst, dst_pitch);
+    }
+
+    if (SDL_ISPIXELFORMAT_FOURCC(converter->dst_format) && !SDL_ISPIXELFORMAT_FOURCC(converter->src_format)) {
+        if (!converter->stage) {
+            return SDL_ConvertPixels_ARGB8888_to_YUV(width, height, src, src_pitch,
+                                                     converter->dst_format, dst, dst_pitch);
+        }
+        if (SDL_RunPixelConverter(converter->stage, src, src_pitch, converter->tmp, converter->tmp_pitch) < 0) {
+            return -1;
+        }
+        return SDL_ConvertPixels_ARGB8888_to_YUV(width, height, converter->tmp, converter->tmp_pitch,
+                                                 converter->dst_format, dst, dst_pitch);
+    }
+
+    /* Copies and YUV to YUV conversions don't set anything up */
+    return SDL_ConvertPixels(width, height, converter->src_format, src, src_pitch,
+                             converter->dst_format, dst, dst_pitch);
+}
+
+/*
+ * Convert a block of pixels with a converter from SDL_CreatePixelConverter()
+ */
+int
+SDL_RunPixelConverter(SDL_PixelConverter * converter,
+                      const void * src, int src_pitch,
+                      void * dst, int dst_pitch)
+{
+    if (!converter) {
+        return SDL_InvalidParamError("converter");
+    }
+    if (!dst) {
+        return SDL_InvalidParamError("dst");
+    }
+    if (!dst_pitch) {
+        return SDL_InvalidParamError("dst_pitch");
+    }
+
+    return SDL_RunPixelConverterBlock(converter, converter->width, converter->height,
+                                      src, src_pitch, dst, dst_pitch);
+}
+
+/*
+ * Convert part of a block of pixels with a converter from
+ * SDL_CreatePixelConverter()
+ */
+int
+SDL_RunPixelConverterRect(SDL_PixelConverter * converter, const SDL_Rect * rect,
+                          const void * src, int src_pitch,
+                          void * dst, int dst_pitch)
+{
+    SDL_Rect bounds, area;
+
+    if (!converter) {
+        return SDL_InvalidParamError("converter");
+    }
+    if (!rect) {
+        return SDL_RunPixelConverter(converter, src, src_pitch, dst, dst_pitch);
+    }
+
+    bounds.x = 0;
+    bounds.y = 0;
+    bounds.w = converter->width;
+    bounds.h = converter->height;
+    if (!SDL_IntersectRect(rect, &bounds, &area)) {
+        return 0;
+    }
+    if (area.w == bounds.w && area.h == bounds.h) {
+        return SDL_RunPixelConverter(converter, src, src_pitch, dst, dst_pitch);
+    }
+
+    /* The YUV formats are planar, so a part of the image isn't one block */
+    if (SDL_ISPIXELFORMAT_FOURCC(converter->src_format) ||
+        SDL_ISPIXELFORMAT_FOURCC(converter->dst_format)) {
+        return SDL_SetError("Can't convert part of a YUV image");
+    }
+    if (!dst) {
+        return SDL_InvalidParamError("dst");
+    }
+    if (!dst_pitch) {
+        return SDL_InvalidParamError("dst_pitch");
+    }
+
+    src = (const Uint8 *) src + area.y * src_pitch + area.x * SDL_BYTESPERPIXEL(converter->src_format);
+    dst = (Uint8 *) dst + area.y * dst_pitch + area.x * SDL_BYTESPERPIXEL(converter->dst_format);
+    return SDL_RunPixelConverterBlock(converter, area.w, area.h, src, src_pitch, dst, dst_pitch);
+}
+
+/*
+ * Free a converter created by SDL_CreatePixelConverter()
+ */
+void
+SDL_FreePixelConverter(SDL_PixelConverter * converter)
+{
+    if (!converter) {
+        return;
+    }
+    if (converter->src_surface.map) {
+        SDL_InvalidateMap(converter->src_surface.map);
+    }
+    SDL_FreePixelConverter(converter->stage);
+    SDL_free(converter->tmp);
+    SDL_free(converter);
+}
+
 /*
  * Free a surface created by the above function.
  */
@@ -96,6 +96,7 @@ struct SDL_Window
 
     SDL_Surface *surface;
     SDL_bool surface_valid;
+    Uint32 *surface_hashes;     /* tile hashes for SDL_HINT_FRAMEBUFFER_DAMAGE */
 
     SDL_bool is_hiding;
     SDL_bool is_destroying;
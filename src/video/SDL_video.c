@@ -1641,6 +1641,8 @@ SDL_RecreateWindow(SDL_Window * window, Uint32 flags)
         window->surface = NULL;
         window->surface_valid = SDL_FALSE;
     }
+    SDL_free(window->surface_hashes);
+    window->surface_hashes = NULL;
     if (_this->DestroyWindowFramebuffer) {
         _this->DestroyWindowFramebuffer(_this, window);
     }
@@ -2313,6 +2315,8 @@ SDL_GetWindowSurface(SDL_Window * window)
             window->surface->flags &= ~SDL_DONTFREE;
             SDL_FreeSurface(window->surface);
         }
+        SDL_free(window->surface_hashes);
+        window->surface_hashes = NULL;
         window->surface = SDL_CreateWindowFramebuffer(window);
         if (window->surface) {
             window->surface_valid = SDL_TRUE;
@@ -2336,17 +2340,208 @@ SDL_UpdateWindowSurface(SDL_Window * window)
     return SDL_UpdateWindowSurfaceRects(window, &full_rect, 1);
 }
 
+/* Damage rects are widened to whole blocks of this many bytes, a cache
+   line on most targets, so the backend never copies part of one.  Pixel
+   sizes that don't divide it, like 24-bit, aren't widened. */
+#define SDL_DAMAGE_ALIGN_BYTES  64
+
+/* With SDL_HINT_FRAMEBUFFER_DAMAGE, window surfaces are compared with the
+   last update in square tiles of this many pixels */
+#define SDL_DAMAGE_TILE_SIZE    32
+
+/* MurmurHash3 over 32-bit words, in four independent lanes so that the
+   loop vectorizes where the CPU can multiply several words at once.  The
+   rotates carry every bit of a word to every bit of its lane, so changes
+   in the high bits of a pixel can't cancel out. */
+#define SDL_HASH_ROTL(x, r) (((x) << (r)) | ((x) >> (32 - (r))))
+
+SDL_FORCE_INLINE Uint32
+SDL_HashMix(Uint32 h, Uint32 k)
+{
+    k *= 0xcc9e2d51;
+    k = SDL_HASH_ROTL(k, 15);
+    k *= 0x1b873593;
+    h ^= k;
+    h = SDL_HASH_ROTL(h, 13);
+    return h * 5 + 0xe6546b64;
+}
+
+SDL_FORCE_INLINE Uint32
+SDL_HashFinish(Uint32 h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return h;
+}
+
+static Uint32
+SDL_HashTile(const Uint8 * pixels, int pitch, int bytes, int rows)
+{
+    Uint32 h0 = 0, h1 = 1, h2 = 2, h3 = 3;
+    int x, y;
+
+    for (y = 0; y < rows; ++y) {
+        const Uint8 *row = pixels + y * pitch;
+        for (x = 0; x + 16 <= bytes; x += 16) {
+            Uint32 words[4];
+            SDL_memcpy(words, row + x, sizeof(words));
+            h0 = SDL_HashMix(h0, words[0]);
+            h1 = SDL_HashMix(h1, words[1]);
+            h2 = SDL_HashMix(h2, words[2]);
+            h3 = SDL_HashMix(h3, words[3]);
+        }
+        for (; x < bytes; ++x) {
+            h0 = SDL_HashMix(h0, row[x]);
+        }
+    }
+    h0 = SDL_HashFinish(h0);
+    h1 = SDL_HashFinish(h1 ^ h0);
+    h2 = SDL_HashFinish(h2 ^ h1);
+    return SDL_HashFinish(h3 ^ h2);
+}
+
+/* Fill damage with the tiles under rects that changed since the last
+   update, at most one rect per tile.  The hashes are kept twice: the ones
+   last sent, then the ones found by this update, and a hash of 0 marks a
+   tile that was never sent. */
+static int
+SDL_FindDamagedTiles(SDL_Window * window, const SDL_Rect * rects,
+                     int numrects, SDL_Rect * damage)
+{
+    SDL_Surface *surface = window->surface;
+    const int bpp = surface->format->BytesPerPixel;
+    const int tiles_x = (surface->w + SDL_DAMAGE_TILE_SIZE - 1) / SDL_DAMAGE_TILE_SIZE;
+    const int tiles_y = (surface->h + SDL_DAMAGE_TILE_SIZE - 1) / SDL_DAMAGE_TILE_SIZE;
+    const int numtiles = tiles_x * tiles_y;
+    Uint32 *sent, *found;
+    int i, tx, ty, count = 0;
+
+    if (!window->surface_hashes) {
+        window->surface_hashes = (Uint32 *) SDL_calloc(2 * numtiles, sizeof(Uint32));
+        if (!window->surface_hashes) {
+            return SDL_OutOfMemory();
+        }
+    }
+    sent = window->surface_hashes;
+    found = sent + numtiles;
+
+    for (i = 0; i < numrects; ++i) {
+        int x1 = SDL_max(rects[i].x, 0);
+        int y1 = SDL_max(rects[i].y, 0);
+        int x2 = SDL_min(rects[i].x + rects[i].w, surface->w);
+        int y2 = SDL_min(rects[i].y + rects[i].h, surface->h);
+
+        if (x2 <= x1 || y2 <= y1) {
+            continue;
+        }
+        for (ty = y1 / SDL_DAMAGE_TILE_SIZE; ty <= (y2 - 1) / SDL_DAMAGE_TILE_SIZE; ++ty) {
+            for (tx = x1 / SDL_DAMAGE_TILE_SIZE; tx <= (x2 - 1) / SDL_DAMAGE_TILE_SIZE; ++tx) {
+                const int index = ty * tiles_x + tx;
+                SDL_Rect tile;
+                Uint32 value;
+
+                /* Rects can overlap, and each tile is only sent once */
+                if (found[index] != sent[index]) {
+                    continue;
+                }
+
+                tile.x = tx * SDL_DAMAGE_TILE_SIZE;
+                tile.y = ty * SDL_DAMAGE_TILE_SIZE;
+                tile.w = SDL_min(SDL_DAMAGE_TILE_SIZE, surface->w - tile.x);
+                tile.h = SDL_min(SDL_DAMAGE_TILE_SIZE, surface->h - tile.y);
+                value = SDL_HashTile((const Uint8 *) surface->pixels + tile.y * surface->pitch + tile.x * bpp,
+                                     surface->pitch, tile.w * bpp, tile.h);
+                if (value == 0) {
+                    value = 1;
+                }
+                if (value != sent[index]) {
+                    found[index] = value;
+                    damage[count++] = tile;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+/* Remember the tiles found by SDL_FindDamagedTiles() once they're sent,
+   or forget them so that the next update tries again */
+static void
+SDL_FinishDamagedTiles(SDL_Window * window, SDL_bool success)
+{
+    SDL_Surface *surface = window->surface;
+    const int numtiles = ((surface->w + SDL_DAMAGE_TILE_SIZE - 1) / SDL_DAMAGE_TILE_SIZE) *
+                         ((surface->h + SDL_DAMAGE_TILE_SIZE - 1) / SDL_DAMAGE_TILE_SIZE);
+    Uint32 *sent = window->surface_hashes;
+    Uint32 *found = sent + numtiles;
+
+    if (success) {
+        SDL_memcpy(sent, found, numtiles * sizeof(Uint32));
+    } else {
+        SDL_memcpy(found, sent, numtiles * sizeof(Uint32));
+    }
+}
+
 int
 SDL_UpdateWindowSurfaceRects(SDL_Window * window, const SDL_Rect * rects,
                              int numrects)
 {
+    SDL_Rect *damage;
+    SDL_bool isstack;
+    SDL_bool detect;
+    int maxrects, bpp, align, retval;
+
     CHECK_WINDOW_MAGIC(window, -1);
 
     if (!window->surface_valid) {
         return SDL_SetError("Window surface is invalid, please call SDL_GetWindowSurface() to get a new surface");
     }
+    if (numrects <= 0 || !rects || !window->surface) {
+        return _this->UpdateWindowFramebuffer(_this, window, rects, numrects);
+    }
+
+    detect = SDL_GetHintBoolean(SDL_HINT_FRAMEBUFFER_DAMAGE, SDL_FALSE);
+    if (detect) {
+        maxrects = SDL_max(numrects,
+                           ((window->surface->w + SDL_DAMAGE_TILE_SIZE - 1) / SDL_DAMAGE_TILE_SIZE) *
+                           ((window->surface->h + SDL_DAMAGE_TILE_SIZE - 1) / SDL_DAMAGE_TILE_SIZE));
+    } else {
+        SDL_free(window->surface_hashes);
+        window->surface_hashes = NULL;
+        maxrects = numrects;
+    }
+
+    damage = SDL_small_alloc(SDL_Rect, maxrects, &isstack);
+    if (!damage) {
+        return SDL_OutOfMemory();
+    }
+    if (detect) {
+        numrects = SDL_FindDamagedTiles(window, rects, numrects, damage);
+    } else {
+        SDL_memcpy(damage, rects, numrects * sizeof(*damage));
+    }
 
-    return _this->UpdateWindowFramebuffer(_this, window, rects, numrects);
+    /* Merge overlapping and neighbouring rects into fewer, larger copies.
+       Pixels can still be sent twice where rects that didn't merge cross. */
+    if (numrects > 0) {
+        bpp = window->surface->format->BytesPerPixel;
+        align = (SDL_DAMAGE_ALIGN_BYTES % bpp == 0) ? SDL_DAMAGE_ALIGN_BYTES / bpp : 1;
+        numrects = SDL_CoalesceRects(window->surface->w, window->surface->h,
+                                     align, damage, numrects);
+    }
+    if (numrects > 0) {
+        retval = _this->UpdateWindowFramebuffer(_this, window, damage, numrects);
+        if (detect) {
+            SDL_FinishDamagedTiles(window, (retval == 0) ? SDL_TRUE : SDL_FALSE);
+        }
+    } else {
+        retval = numrects;
+    }
+    SDL_small_free(damage, isstack);
+    return retval;
 }
 
 int
@@ -2728,6 +2923,7 @@ SDL_DestroyWindow(SDL_Window * window)
         window->surface->flags &= ~SDL_DONTFREE;
         SDL_FreeSurface(window->surface);
     }
+    SDL_free(window->surface_hashes);
     if (_this->DestroyWindowFramebuffer) {
         _this->DestroyWindowFramebuffer(_this, window);
     }
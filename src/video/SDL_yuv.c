@@ -20,7 +20,9 @@
 */
 #include "../SDL_internal.h"
 
+#include "SDL_atomic.h"
 #include "SDL_endian.h"
+#include "SDL_jobs.h"
 #include "SDL_video.h"
 #include "SDL_pixels_c.h"
 #include "SDL_yuv_c.h"
@@ -391,8 +393,49 @@ static SDL_bool yuv_rgb_std(
     return SDL_FALSE;
 }
 
+/* A YUV to RGB conversion split into bands of rows on the job pool */
+typedef struct
+{
+    Uint32 src_format;
+    Uint32 dst_format;
+    Uint32 width;
+    int height;
+    const Uint8 *y;
+    const Uint8 *u;
+    const Uint8 *v;
+    Uint32 y_stride;
+    Uint32 uv_stride;
+    Uint8 *rgb;
+    Uint32 rgb_stride;
+    YCbCrType yuv_type;
+    SDL_atomic_t unsupported;
+} YUVtoRGBBands;
+
+/* Bands are whole pairs of rows, so 4:2:0 chroma rows aren't split */
+static void SDLCALL
+YUVtoRGBBand(void *data, int start, int end)
+{
+    YUVtoRGBBands *bands = (YUVtoRGBBands *)data;
+    const int first = start * 2;
+    const int rows = SDL_min(end * 2, bands->height) - first;
+    const int uv_row = IsPlanar2x2Format(bands->src_format) ? (first / 2) : first;
+    const Uint8 *y = bands->y + first * bands->y_stride;
+    const Uint8 *u = bands->u + uv_row * bands->uv_stride;
+    const Uint8 *v = bands->v + uv_row * bands->uv_stride;
+    Uint8 *rgb = bands->rgb + first * bands->rgb_stride;
+
+    if (yuv_rgb_sse(bands->src_format, bands->dst_format, bands->width, rows, y, u, v, bands->y_stride, bands->uv_stride, rgb, bands->rgb_stride, bands->yuv_type)) {
+        return;
+    }
+    if (yuv_rgb_std(bands->src_format, bands->dst_format, bands->width, rows, y, u, v, bands->y_stride, bands->uv_stride, rgb, bands->rgb_stride, bands->yuv_type)) {
+        return;
+    }
+    /* Nothing was written, the caller falls back to converting through ARGB8888 */
+    SDL_AtomicSet(&bands->unsupported, 1);
+}
+
 int
-SDL_ConvertPixels_YUV_to_RGB(int width, int height,
+SDL_ConvertPixels_YUV_to_RGB_Direct(int width, int height,
          Uint32 src_format, const void *src, int src_pitch,
          Uint32 dst_format, void *dst, int dst_pitch)
 {
@@ -411,17 +454,48 @@ SDL_ConvertPixels_YUV_to_RGB(int width, int height,
         return -1;
     }
 
+    if (SDL_ShouldConvertInParallel(width, height)) {
+        YUVtoRGBBands bands;
+
+        bands.src_format = src_format;
+        bands.dst_format = dst_format;
+        bands.width = width;
+        bands.height = height;
+        bands.y = y;
+        bands.u = u;
+        bands.v = v;
+        bands.y_stride = y_stride;
+        bands.uv_stride = uv_stride;
+        bands.rgb = (Uint8 *)dst;
+        bands.rgb_stride = dst_pitch;
+        bands.yuv_type = yuv_type;
+        SDL_AtomicSet(&bands.unsupported, 0);
+        SDL_ParallelFor(0, (height + 1) / 2, 0, YUVtoRGBBand, &bands);
+        return SDL_AtomicGet(&bands.unsupported) ? 0 : 1;
+    }
+
     if (yuv_rgb_sse(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8*)dst, dst_pitch, yuv_type)) {
-        return 0;
+        return 1;
     }
 
     if (yuv_rgb_std(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8*)dst, dst_pitch, yuv_type)) {
-        return 0;
+        return 1;
+    }
+    return 0;
+}
+
+int
+SDL_ConvertPixels_YUV_to_RGB(int width, int height,
+         Uint32 src_format, const void *src, int src_pitch,
+         Uint32 dst_format, void *dst, int dst_pitch)
+{
+    int ret = SDL_ConvertPixels_YUV_to_RGB_Direct(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch);
+    if (ret != 0) {
+        return (ret < 0) ? ret : 0;
     }
 
     /* No fast path for the RGB format, instead convert using an intermediate buffer */
     if (dst_format != SDL_PIXELFORMAT_ARGB8888) {
-        int ret;
         void *tmp;
         int tmp_pitch = (width * sizeof(Uint32));
 
@@ -454,7 +528,7 @@ struct RGB2YUVFactors
     float v[3]; /* Rfactor, Gfactor, Bfactor */
 };
 
-static int
+int
 SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int src_pitch, Uint32 dst_format, void *dst, int dst_pitch)
 {
     const int src_pitch_x_2    = src_pitch * 2;
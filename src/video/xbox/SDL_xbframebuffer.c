@@ -27,11 +27,28 @@
 
 
 #define XBOX_SURFACE   "_SDL_XboxSurface"
+#define XBOX_PRESENT   "_SDL_XboxPresent"
 
 
 #include <hal/video.h>
 #include <assert.h>
 
+/* The copy to the GPU framebuffer, set up once for the video mode */
+typedef struct
+{
+    Uint32 dst_format;
+    SDL_PixelConverter *converter;
+} XBOX_Present;
+
+static void XBOX_FreePresent(SDL_Window * window)
+{
+    XBOX_Present *present = (XBOX_Present *) SDL_SetWindowData(window, XBOX_PRESENT, NULL);
+
+    if (present) {
+        SDL_FreePixelConverter(present->converter);
+        SDL_free(present);
+    }
+}
 
 int SDL_XBOX_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * format, void ** pixels, int *pitch)
 {
@@ -45,6 +62,7 @@ int SDL_XBOX_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * format
     /* Free the old framebuffer surface */
     surface = (SDL_Surface *) SDL_GetWindowData(window, XBOX_SURFACE);
     SDL_FreeSurface(surface);
+    XBOX_FreePresent(window);
 
     /* Create a new one */
     SDL_PixelFormatEnumToMasks(surface_format, &bpp, &Rmask, &Gmask, &Bmask, &Amask);
@@ -65,6 +83,7 @@ int SDL_XBOX_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * format
 int SDL_XBOX_UpdateWindowFramebuffer(_THIS, SDL_Window * window, const SDL_Rect * rects, int numrects)
 {
     SDL_Surface *surface;
+    XBOX_Present *present;
 
     surface = (SDL_Surface *) SDL_GetWindowData(window, XBOX_SURFACE);
     if (!surface) {
@@ -90,8 +109,39 @@ int SDL_XBOX_UpdateWindowFramebuffer(_THIS, SDL_Window * window, const SDL_Rect
     assert(width <= vm.width);
     assert(height <= vm.height);
 
-    // Copy SDL window surface to GPU framebuffer
-    SDL_ConvertPixels(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch);
+    // Set up the conversion again only if the video mode changed
+    present = (XBOX_Present *) SDL_GetWindowData(window, XBOX_PRESENT);
+    if (present && present->dst_format != dst_format) {
+        XBOX_FreePresent(window);
+        present = NULL;
+    }
+    if (!present) {
+        present = (XBOX_Present *) SDL_malloc(sizeof(*present));
+        if (!present) {
+            return SDL_OutOfMemory();
+        }
+        present->dst_format = dst_format;
+        present->converter = SDL_CreatePixelConverter(src_format, dst_format, width, height);
+        if (!present->converter) {
+            SDL_free(present);
+            return -1;
+        }
+        SDL_SetWindowData(window, XBOX_PRESENT, present);
+    }
+
+    // Copy SDL window surface to GPU framebuffer, only where it changed
+    int area = 0;
+    for (int i = 0; i < numrects; i++) {
+        area += rects[i].w * rects[i].h;
+    }
+    if (area >= width * height / 4 * 3) {
+        // Nearly everything changed, one pass over the window is cheaper
+        SDL_RunPixelConverter(present->converter, src, src_pitch, dst, dst_pitch);
+    } else {
+        for (int i = 0; i < numrects; i++) {
+            SDL_RunPixelConverterRect(present->converter, &rects[i], src, src_pitch, dst, dst_pitch);
+        }
+    }
 
     // Writeback WC buffers
     XVideoFlushFB();
@@ -105,6 +155,7 @@ void SDL_XBOX_DestroyWindowFramebuffer(_THIS, SDL_Window * window)
 
     surface = (SDL_Surface *) SDL_SetWindowData(window, XBOX_SURFACE, NULL);
     SDL_FreeSurface(surface);
+    XBOX_FreePresent(window);
 }
 
 #endif /* SDL_VIDEO_DRIVER_XBOX */
@@ -0,0 +1,351 @@
+/*
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Stress the asynchronous read queue from several threads against slow
+   streams that charge for seeking, like an optical drive, and check that
+   queued reads are served with less seeking than in submission order.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "SDL.h"
+
+#define STREAM_SIZE     (1024 * 1024)
+#define NUM_STREAMS     2
+#define NUM_THREADS     4
+#define READS_PER_THREAD 500
+#define MAX_READ_SIZE   4096
+#define NUM_SWEEP_READS 200
+#define NUM_EVENT_READS 32
+#define TEST_FILE       "testasyncio.dat"
+
+typedef struct
+{
+    Uint8 seed;
+    Sint64 position;
+    Sint64 seek_distance;   /* total distance the "head" moved */
+    SDL_bool slow;
+} SlowStream;
+
+typedef struct
+{
+    int source;             /* NUM_STREAMS for the file read by name */
+    Sint64 offset;
+    size_t size;
+    Uint8 buffer[MAX_READ_SIZE];
+} Request;
+
+static SDL_RWops *streams[NUM_STREAMS];
+static Request requests[NUM_THREADS][READS_PER_THREAD];
+static SDL_atomic_t completed;
+static SDL_atomic_t failures;
+
+static Uint8
+PatternByte(Uint8 seed, Sint64 offset)
+{
+    return (Uint8)(seed + offset + (offset >> 8) * 7);
+}
+
+/* rand() may only give 15 bits */
+static int
+Random(int range)
+{
+    return (int)((((unsigned int)rand() << 15) ^ (unsigned int)rand()) % (unsigned int)range);
+}
+
+static Sint64 SDLCALL
+slow_size(SDL_RWops *context)
+{
+    return STREAM_SIZE;
+}
+
+static Sint64 SDLCALL
+slow_seek(SDL_RWops *context, Sint64 offset, int whence)
+{
+    SlowStream *stream = (SlowStream *)context->hidden.unknown.data1;
+    Sint64 position;
+
+    switch (whence) {
+    case RW_SEEK_SET:
+        position = offset;
+        break;
+    case RW_SEEK_CUR:
+        position = stream->position + offset;
+        break;
+    case RW_SEEK_END:
+        position = STREAM_SIZE + offset;
+        break;
+    default:
+        return SDL_SetError("Unknown value for 'whence'");
+    }
+    if (position < 0) {
+        return SDL_SetError("Seek before the start of the stream");
+    }
+    if (position != stream->position) {
+        Sint64 distance = (position > stream->position) ? (position - stream->position) : (stream->position - position);
+        stream->seek_distance += distance;
+        if (stream->slow) {
+            /* A millisecond for each 64K the head travels */
+            SDL_Delay((Uint32)(1 + distance / (64 * 1024)));
+        }
+    }
+    stream->position = position;
+    return position;
+}
+
+static size_t SDLCALL
+slow_read(SDL_RWops *context, void *ptr, size_t size, size_t maxnum)
+{
+    SlowStream *stream = (SlowStream *)context->hidden.unknown.data1;
+    Uint8 *dst = (Uint8 *)ptr;
+    size_t total = size * maxnum;
+    size_t i;
+
+    if (stream->position >= STREAM_SIZE) {
+        return 0;
+    }
+    if (total > (size_t)(STREAM_SIZE - stream->position)) {
+        total = (size_t)(STREAM_SIZE - stream->position);
+    }
+    total -= total % size;
+    for (i = 0; i < total; ++i) {
+        dst[i] = PatternByte(stream->seed, stream->position + i);
+    }
+    stream->position += total;
+    return total / size;
+}
+
+static int SDLCALL
+slow_close(SDL_RWops *context)
+{
+    SDL_free(context->hidden.unknown.data1);
+    SDL_FreeRW(context);
+    return 0;
+}
+
+static SDL_RWops *
+CreateSlowStream(Uint8 seed)
+{
+    SDL_RWops *context = SDL_AllocRW();
+    SlowStream *stream = (SlowStream *)SDL_calloc(1, sizeof(*stream));
+
+    if (!context || !stream) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
+        exit(1);
+    }
+    stream->seed = seed;
+    context->size = slow_size;
+    context->seek = slow_seek;
+    context->read = slow_read;
+    context->close = slow_close;
+    context->hidden.unknown.data1 = stream;
+    return context;
+}
+
+static SDL_bool
+CheckRequest(const Request *request, Sint64 result)
+{
+    Uint8 seed = (Uint8)(request->source * 101);
+    size_t i;
+
+    if (result != (Sint64)request->size) {
+        return SDL_FALSE;
+    }
+    for (i = 0; i < request->size; ++i) {
+        if (request->buffer[i] != PatternByte(seed, request->offset + i)) {
+            return SDL_FALSE;
+        }
+    }
+    return SDL_TRUE;
+}
+
+static void SDLCALL
+ReadFinished(void *userdata, void *buffer, Sint64 result)
+{
+    const Request *request = (const Request *)userdata;
+
+    if (buffer != request->buffer || !CheckRequest(request, result)) {
+        SDL_AtomicIncRef(&failures);
+    }
+    SDL_AtomicIncRef(&completed);
+}
+
+static int SDLCALL
+SubmitThread(void *data)
+{
+    Request *list = (Request *)data;
+    int i;
+
+    for (i = 0; i < READS_PER_THREAD; ++i) {
+        Request *request = &list[i];
+        int result;
+
+        request->source = Random(NUM_STREAMS + 1);
+        request->size = 1 + Random(MAX_READ_SIZE);
+        request->offset = Random((int)(STREAM_SIZE - request->size + 1));
+        if (request->source == NUM_STREAMS) {
+            result = SDL_ReadFileAsync(TEST_FILE, request->offset, request->buffer, request->size, ReadFinished, request);
+        } else {
+            result = SDL_ReadAsync(streams[request->source], request->offset, request->buffer, request->size, ReadFinished, request);
+        }
+        if (result < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't queue a read: %s\n", SDL_GetError());
+            SDL_AtomicIncRef(&failures);
+            SDL_AtomicIncRef(&completed);
+        }
+    }
+    return 0;
+}
+
+static void SDLCALL
+CountRead(void *userdata, void *buffer, Sint64 result)
+{
+    if (result != 16) {
+        SDL_AtomicIncRef(&failures);
+    }
+}
+
+static int
+WriteTestFile(void)
+{
+    SDL_RWops *file = SDL_RWFromFile(TEST_FILE, "wb");
+    Uint8 *data = (Uint8 *)SDL_malloc(STREAM_SIZE);
+    Uint8 seed = (Uint8)(NUM_STREAMS * 101);
+    int i;
+
+    if (!file || !data) {
+        SDL_free(data);
+        SDL_RWclose(file);
+        return -1;
+    }
+    for (i = 0; i < STREAM_SIZE; ++i) {
+        data[i] = PatternByte(seed, i);
+    }
+    if (SDL_RWwrite(file, data, STREAM_SIZE, 1) != 1) {
+        SDL_RWclose(file);
+        SDL_free(data);
+        return -1;
+    }
+    SDL_free(data);
+    return SDL_RWclose(file);
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_Thread *threads[NUM_THREADS];
+    Sint64 offsets[NUM_SWEEP_READS];
+    Sint64 fifo_distance, position;
+    SlowStream *stream;
+    Uint8 scratch[16];
+    Uint32 start;
+    int i, received;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(SDL_INIT_EVENTS) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+    if (WriteTestFile() < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't write %s: %s\n", TEST_FILE, SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+    srand((unsigned int)time(NULL));
+
+    for (i = 0; i < NUM_STREAMS; ++i) {
+        streams[i] = CreateSlowStream((Uint8)(i * 101));
+    }
+
+    /* Queue reads from several threads at once and check every one */
+    start = SDL_GetTicks();
+    for (i = 0; i < NUM_THREADS; ++i) {
+        char name[32];
+        SDL_snprintf(name, sizeof(name), "Submit%d", i);
+        threads[i] = SDL_CreateThread(SubmitThread, name, requests[i]);
+    }
+    for (i = 0; i < NUM_THREADS; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    SDL_WaitAsyncIO();
+    SDL_Log("%d reads finished in %u ms, %d failed\n",
+            SDL_AtomicGet(&completed), (unsigned int)(SDL_GetTicks() - start), SDL_AtomicGet(&failures));
+    if (SDL_AtomicGet(&completed) != NUM_THREADS * READS_PER_THREAD || SDL_AtomicGet(&failures) != 0) {
+        goto failed;
+    }
+
+    /* Queue reads in random order behind a slow one and compare the
+       distance the head travels with serving them in submission order */
+    stream = (SlowStream *)streams[0]->hidden.unknown.data1;
+    stream->slow = SDL_TRUE;
+    stream->position = 0;
+    stream->seek_distance = 0;
+    SDL_ReadAsync(streams[0], STREAM_SIZE / 2, scratch, sizeof(scratch), CountRead, NULL);
+    fifo_distance = STREAM_SIZE / 2;
+    position = STREAM_SIZE / 2 + sizeof(scratch);
+    for (i = 0; i < NUM_SWEEP_READS; ++i) {
+        offsets[i] = (Sint64)Random(STREAM_SIZE / sizeof(scratch)) * sizeof(scratch);
+        SDL_ReadAsync(streams[0], offsets[i], scratch, sizeof(scratch), CountRead, NULL);
+        fifo_distance += (offsets[i] > position) ? (offsets[i] - position) : (position - offsets[i]);
+        position = offsets[i] + sizeof(scratch);
+    }
+    SDL_WaitAsyncIO();
+    SDL_Log("Seek distance %d KB, %d KB in submission order\n",
+            (int)(stream->seek_distance / 1024), (int)(fifo_distance / 1024));
+    if (stream->seek_distance >= fifo_distance || SDL_AtomicGet(&failures) != 0) {
+        goto failed;
+    }
+    stream->slow = SDL_FALSE;
+
+    /* Completions without a callback arrive as events */
+    for (i = 0; i < NUM_EVENT_READS; ++i) {
+        Request *request = &requests[0][i];
+        request->source = 1;
+        request->offset = i * 1000;
+        request->size = 100 + i;
+        SDL_ReadAsync(streams[1], request->offset, request->buffer, request->size, NULL, request);
+    }
+    received = 0;
+    start = SDL_GetTicks();
+    while (received < NUM_EVENT_READS && !SDL_TICKS_PASSED(SDL_GetTicks(), start + 5000)) {
+        SDL_Event event;
+        if (!SDL_WaitEventTimeout(&event, 100) || event.type != SDL_ASYNCIOCOMPLETE) {
+            continue;
+        }
+        if (!CheckRequest((const Request *)event.user.data1, event.user.code)) {
+            SDL_AtomicIncRef(&failures);
+        }
+        ++received;
+    }
+    SDL_Log("%d completion events received\n", received);
+    if (received != NUM_EVENT_READS || SDL_AtomicGet(&failures) != 0) {
+        goto failed;
+    }
+
+    for (i = 0; i < NUM_STREAMS; ++i) {
+        SDL_RWclose(streams[i]);
+    }
+    remove(TEST_FILE);
+    SDL_Quit();
+    return 0;
+
+failed:
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Asynchronous reads failed\n");
+    SDL_WaitAsyncIO();
+    remove(TEST_FILE);
+    SDL_Quit();
+    return 1;
+}
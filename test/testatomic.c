@@ -594,6 +594,7 @@ static int SDLCALL FIFO_Watcher(void* _data)
 static void RunFIFOTest(SDL_bool lock_free)
 {
     SDL_EventQueue queue;
+    SDL_Thread *watcher = NULL;
     WriterData writerData[NUM_WRITERS];
     ReaderData readerData[NUM_READERS];
     Uint32 start, end;
@@ -620,7 +621,7 @@ static void RunFIFOTest(SDL_bool lock_free)
 #ifdef TEST_SPINLOCK_FIFO
     /* Start a monitoring thread */
     if (lock_free) {
-        SDL_CreateThread(FIFO_Watcher, "FIFOWatcher", &queue);
+        watcher = SDL_CreateThread(FIFO_Watcher, "FIFOWatcher", &queue);
     }
 #endif
 
@@ -662,6 +663,9 @@ static void RunFIFOTest(SDL_bool lock_free)
         SDL_SemWait(readersDone);
     }
 
+    /* The watcher uses the queue on our stack, so it has to finish too */
+    SDL_WaitThread(watcher, NULL);
+
     end = SDL_GetTicks();
 
     SDL_DestroySemaphore(readersDone);
@@ -708,6 +712,170 @@ static void RunFIFOTest(SDL_bool lock_free)
 /* End FIFO test */
 /**************************************************************************/
 
+/**************************************************************************/
+/* Lock-free queue and stack stress test */
+
+#define NUM_QUEUE_PRODUCERS 4
+#define NUM_QUEUE_CONSUMERS 4
+#define NUM_QUEUE_ITEMS     100000
+#define NUM_STACK_THREADS   8
+#define NUM_STACK_NODES     64
+#define NUM_STACK_CYCLES    100000
+
+static SDL_AtomicQueue *stress_queue;
+static SDL_atomic_t stress_consumed;
+static SDL_atomic_t stress_failed;
+static Uint32 stress_seen[NUM_QUEUE_PRODUCERS][NUM_QUEUE_CONSUMERS];
+static Uint64 stress_sums[NUM_QUEUE_CONSUMERS];
+
+static int SDLCALL
+QueueProducer(void *data)
+{
+    const uintptr_t producer = (uintptr_t)data;
+    uintptr_t i;
+
+    for (i = 1; i <= NUM_QUEUE_ITEMS; ++i) {
+        while (!SDL_AtomicQueuePush(stress_queue, (void *)((producer << 24) | i))) {
+            SDL_Delay(0);
+        }
+    }
+    return 0;
+}
+
+static int SDLCALL
+QueueConsumer(void *data)
+{
+    const int consumer = (int)(uintptr_t)data;
+    const int total = NUM_QUEUE_PRODUCERS * NUM_QUEUE_ITEMS;
+    void *item;
+
+    while (SDL_AtomicGet(&stress_consumed) < total) {
+        if (SDL_AtomicQueuePop(stress_queue, &item)) {
+            const uintptr_t producer = (uintptr_t)item >> 24;
+            const Uint32 value = (Uint32)((uintptr_t)item & 0xFFFFFF);
+
+            /* Each producer's items must come out in the order they went in */
+            if (value <= stress_seen[producer][consumer]) {
+                SDL_AtomicSet(&stress_failed, 1);
+            }
+            stress_seen[producer][consumer] = value;
+            stress_sums[consumer] += value;
+            SDL_AtomicIncRef(&stress_consumed);
+        } else {
+            SDL_Delay(0);
+        }
+    }
+    return 0;
+}
+
+typedef struct
+{
+    SDL_AtomicStackNode link;
+    int count;
+} StressNode;
+
+static SDL_AtomicStack *stress_stack;
+
+static int SDLCALL
+StackCycler(void *data)
+{
+    int i;
+
+    for (i = 0; i < NUM_STACK_CYCLES; ++i) {
+        StressNode *node = (StressNode *)SDL_AtomicStackPop(stress_stack);
+        if (node) {
+            /* Nobody else may have this node while we hold it */
+            int count = node->count;
+            node->count = count + 1;
+            if (node->count != count + 1) {
+                SDL_AtomicSet(&stress_failed, 1);
+            }
+            SDL_AtomicStackPush(stress_stack, &node->link);
+        }
+    }
+    return 0;
+}
+
+static void
+RunLockFreeStressTest(void)
+{
+    SDL_Thread *threads[NUM_QUEUE_PRODUCERS + NUM_QUEUE_CONSUMERS + NUM_STACK_THREADS];
+    StressNode nodes[NUM_STACK_NODES];
+    SDL_AtomicStackNode *list;
+    Uint64 sum = 0, expected;
+    int i, count, total_count;
+    Uint32 start;
+
+    SDL_Log("\nlock-free queue and stack ----------------------\n\n");
+
+    /* A small queue, so producers spend time finding it full */
+    stress_queue = SDL_CreateAtomicQueue(64);
+    SDL_AtomicSet(&stress_consumed, 0);
+    SDL_AtomicSet(&stress_failed, 0);
+    SDL_zero(stress_seen);
+    SDL_zero(stress_sums);
+
+    start = SDL_GetTicks();
+    for (i = 0; i < NUM_QUEUE_CONSUMERS; ++i) {
+        threads[i] = SDL_CreateThread(QueueConsumer, "Consumer", (void *)(uintptr_t)i);
+    }
+    for (i = 0; i < NUM_QUEUE_PRODUCERS; ++i) {
+        threads[NUM_QUEUE_CONSUMERS + i] = SDL_CreateThread(QueueProducer, "Producer", (void *)(uintptr_t)i);
+    }
+    for (i = 0; i < NUM_QUEUE_PRODUCERS + NUM_QUEUE_CONSUMERS; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    for (i = 0; i < NUM_QUEUE_CONSUMERS; ++i) {
+        sum += stress_sums[i];
+    }
+    expected = (Uint64)NUM_QUEUE_PRODUCERS * NUM_QUEUE_ITEMS * (NUM_QUEUE_ITEMS + 1) / 2;
+    if (sum != expected || SDL_AtomicQueuePop(stress_queue, NULL)) {
+        SDL_AtomicSet(&stress_failed, 1);
+    }
+    SDL_DestroyAtomicQueue(stress_queue);
+    SDL_Log("Queue: %d producers, %d consumers, %d items each in %f sec, %s\n",
+            NUM_QUEUE_PRODUCERS, NUM_QUEUE_CONSUMERS, NUM_QUEUE_ITEMS,
+            (SDL_GetTicks() - start) / 1000.f, SDL_AtomicGet(&stress_failed) ? "FAILED" : "passed");
+
+    SDL_AtomicSet(&stress_failed, 0);
+    stress_stack = SDL_CreateAtomicStack();
+    if (!stress_stack) {
+        SDL_Log("Couldn't create stack: %s\n", SDL_GetError());
+        return;
+    }
+    for (i = 0; i < NUM_STACK_NODES; ++i) {
+        nodes[i].count = 0;
+        SDL_AtomicStackPush(stress_stack, &nodes[i].link);
+    }
+
+    start = SDL_GetTicks();
+    for (i = 0; i < NUM_STACK_THREADS; ++i) {
+        threads[i] = SDL_CreateThread(StackCycler, "Cycler", NULL);
+    }
+    for (i = 0; i < NUM_STACK_THREADS; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+
+    /* Every node must still be on the stack exactly once */
+    count = 0;
+    total_count = 0;
+    for (list = SDL_AtomicStackPopAll(stress_stack); list; list = list->next) {
+        total_count += ((StressNode *)list)->count;
+        ++count;
+    }
+    if (count != NUM_STACK_NODES || SDL_AtomicStackPop(stress_stack)) {
+        SDL_AtomicSet(&stress_failed, 1);
+    }
+    SDL_DestroyAtomicStack(stress_stack);
+    stress_stack = NULL;
+    SDL_Log("Stack: %d threads, %d cycles each in %f sec, %d round trips, %s\n",
+            NUM_STACK_THREADS, NUM_STACK_CYCLES, (SDL_GetTicks() - start) / 1000.f,
+            total_count, SDL_AtomicGet(&stress_failed) ? "FAILED" : "passed");
+}
+
+/* End lock-free queue and stack stress test */
+/**************************************************************************/
+
 int
 main(int argc, char *argv[])
 {
@@ -721,6 +889,7 @@ main(int argc, char *argv[])
     RunFIFOTest(SDL_FALSE);
 #endif
     RunFIFOTest(SDL_TRUE);
+    RunLockFreeStressTest();
     return 0;
 }
 
@@ -145,6 +145,53 @@ hints_setHint(void *arg)
   return TEST_COMPLETED;
 }
 
+/**
+ * @brief Check that environment variables override hints unless SDL_HINT_OVERRIDE is used
+ */
+int
+hints_environment(void *arg)
+{
+  const char *name = "SDL_TEST_HINT_ENVIRONMENT";
+  const char *value;
+  SDL_bool result;
+
+  SDL_setenv(name, "0", 1);
+  SDL_ClearHints();
+  SDLTest_AssertPass("Call to SDL_ClearHints()");
+
+  value = SDL_GetHint(name);
+  SDLTest_AssertPass("Call to SDL_GetHint(%s)", name);
+  SDLTest_AssertCheck(
+    value && SDL_strcmp(value, "0") == 0,
+    "Verify the environment value is returned, got: %s",
+    value ? value : "null");
+
+  result = SDL_SetHint(name, "1");
+  SDLTest_AssertPass("Call to SDL_SetHint(%s, \"1\")", name);
+  SDLTest_AssertCheck(result == SDL_FALSE, "Verify the environment wins over a normal hint, got: %i", (int)result);
+  SDLTest_AssertCheck(
+    SDL_GetHintBoolean(name, SDL_TRUE) == SDL_FALSE,
+    "Verify SDL_GetHintBoolean() returns the environment value");
+
+  result = SDL_SetHintWithPriority(name, "1", SDL_HINT_OVERRIDE);
+  SDLTest_AssertPass("Call to SDL_SetHintWithPriority(%s, \"1\", SDL_HINT_OVERRIDE)", name);
+  SDLTest_AssertCheck(result == SDL_TRUE, "Verify an override hint wins over the environment, got: %i", (int)result);
+  SDLTest_AssertCheck(
+    SDL_GetHintBoolean(name, SDL_FALSE) == SDL_TRUE,
+    "Verify SDL_GetHintBoolean() returns the override value");
+
+  SDL_ClearHints();
+  SDL_setenv(name, "", 1);
+  value = SDL_GetHint(name);
+  SDLTest_AssertCheck(
+    SDL_GetHintBoolean(name, SDL_TRUE) == SDL_TRUE,
+    "Verify SDL_GetHintBoolean() returns the default for an empty value, got hint: %s",
+    value ? value : "null");
+  SDL_ClearHints();
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Hints test cases */
@@ -154,9 +201,12 @@ static const SDLTest_TestCaseReference hintsTest1 =
 static const SDLTest_TestCaseReference hintsTest2 =
         { (SDLTest_TestCaseFp)hints_setHint, "hints_setHint", "Call to SDL_SetHint", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference hintsTest3 =
+        { (SDLTest_TestCaseFp)hints_environment, "hints_environment", "Check that environment variables override hints", TEST_ENABLED };
+
 /* Sequence of Hints test cases */
 static const SDLTest_TestCaseReference *hintsTests[] =  {
-    &hintsTest1, &hintsTest2, NULL
+    &hintsTest1, &hintsTest2, &hintsTest3, NULL
 };
 
 /* Hints test suite (global) */
@@ -132,6 +132,7 @@ pixels_allocFreeFormat(void *arg)
   Uint32 format;
   Uint32 masks;
   SDL_PixelFormat* result;
+  SDL_PixelFormat* second;
 
   /* Blank/unknown format */
   format = 0;
@@ -171,6 +172,20 @@ pixels_allocFreeFormat(void *arg)
          SDLTest_AssertCheck(masks > 0, "Verify value of result.[RGBA]mask combined; expected: >0, got %u", masks);
       }
 
+      /* RGB formats are shared, palettized formats each own their palette */
+      second = SDL_AllocFormat(format);
+      SDLTest_AssertPass("Call to SDL_AllocFormat()");
+      SDLTest_AssertCheck(second != NULL, "Verify result is not NULL");
+      if (second != NULL) {
+        if (SDL_ISPIXELFORMAT_INDEXED(format)) {
+          SDLTest_AssertCheck(second != result, "Verify palettized format is not shared");
+        } else {
+          SDLTest_AssertCheck(second == result, "Verify RGB format is shared");
+        }
+        SDL_FreeFormat(second);
+        SDLTest_AssertPass("Call to SDL_FreeFormat()");
+      }
+
       /* Deallocate again */
       SDL_FreeFormat(result);
       SDLTest_AssertPass("Call to SDL_FreeFormat()");
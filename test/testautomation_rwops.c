@@ -700,6 +700,545 @@ rwops_testFileWriteReadEndian(void)
 }
 
 
+/**
+ * @brief Tests a buffered stream against the memory stream it wraps.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_CreateBufferedRW
+ */
+int
+rwops_testBuffered(void)
+{
+   Uint8 mem[1024], ref[1024];
+   Uint8 data[100], expected[100];
+   SDL_RWops *rw, *rwRef;
+   Sint64 pos, refPos;
+   size_t bufferSize, len, result, refResult;
+   int i, op, failed = 0;
+
+   /* Run generic tests with a buffer smaller than the test string */
+   SDL_zero(mem);
+   rw = SDL_CreateBufferedRW(SDL_RWFromMem(mem, sizeof(RWopsHelloWorldTestString)-1), 5, 1);
+   SDLTest_AssertPass("Call to SDL_CreateBufferedRW() succeeded");
+   SDLTest_AssertCheck(rw != NULL, "Verify SDL_CreateBufferedRW does not return NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   SDLTest_AssertCheck(rw->type == SDL_RWOPS_BUFFERED, "Verify RWops type is SDL_RWOPS_BUFFERED; expected: %d, got: %d", SDL_RWOPS_BUFFERED, rw->type);
+   _testGenericRWopsValidations(rw, 1);
+   result = SDL_RWclose(rw);
+   SDLTest_AssertCheck(result == 0, "Verify result value is 0; got: %d", (int) result);
+
+   /* Mix reads, writes and seeks on both streams and compare */
+   for (i = 0; i < (int) sizeof(mem); ++i) {
+      mem[i] = ref[i] = (Uint8) (i * 7);
+   }
+   bufferSize = (size_t) SDLTest_RandomIntegerInRange(1, 64);
+   rw = SDL_CreateBufferedRW(SDL_RWFromMem(mem, sizeof(mem)), bufferSize, 1);
+   rwRef = SDL_RWFromMem(ref, sizeof(ref));
+   SDLTest_AssertCheck(rw != NULL && rwRef != NULL, "Verify buffered stream with a %d byte buffer was created", (int) bufferSize);
+   if (rw == NULL || rwRef == NULL) return TEST_ABORTED;
+
+   for (i = 0; i < 2000 && !failed; ++i) {
+      /* Telling seeks the buffered stream, so only check it now and then */
+      refPos = SDL_RWtell(rwRef);
+      op = SDLTest_RandomIntegerInRange(0, 5);
+      len = (size_t) SDLTest_RandomIntegerInRange(1, sizeof(data));
+      switch (op) {
+      case 0:
+         pos = SDLTest_RandomIntegerInRange(0, sizeof(mem));
+         if (SDL_RWseek(rw, pos, RW_SEEK_SET) != SDL_RWseek(rwRef, pos, RW_SEEK_SET)) {
+            failed = 1;
+         }
+         break;
+      case 1:
+         pos = SDLTest_RandomIntegerInRange(-(int) SDL_min(refPos, 64), (int) SDL_min(sizeof(mem) - refPos, 64));
+         if (SDL_RWseek(rw, pos, RW_SEEK_CUR) != SDL_RWseek(rwRef, pos, RW_SEEK_CUR)) {
+            failed = 1;
+         }
+         break;
+      case 2:
+      case 3:
+         result = SDL_RWread(rw, data, 1, len);
+         refResult = SDL_RWread(rwRef, expected, 1, len);
+         if (result != refResult || SDL_memcmp(data, expected, result) != 0) {
+            failed = 1;
+         }
+         break;
+      case 4:
+         len = SDL_min(len, sizeof(mem) - (size_t) refPos);
+         SDL_memset(data, i, len);
+         if (len > 0 && SDL_RWwrite(rw, data, 1, len) != SDL_RWwrite(rwRef, data, 1, len)) {
+            failed = 1;
+         }
+         break;
+      case 5:
+         if (SDL_RWtell(rw) != refPos) {
+            failed = 1;
+         }
+         break;
+      }
+      if (failed) {
+         SDLTest_AssertCheck(SDL_FALSE, "Verify operation %d (type %d, length %d) matches the memory stream", i, op, (int) len);
+      }
+   }
+   SDLTest_AssertCheck(!failed, "Verify 2000 random operations match the memory stream");
+
+   result = SDL_RWclose(rw);
+   SDLTest_AssertCheck(result == 0, "Verify result value is 0; got: %d", (int) result);
+   SDL_RWclose(rwRef);
+   SDLTest_AssertCheck(SDL_memcmp(mem, ref, sizeof(mem)) == 0, "Verify written data matches after closing");
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests reading a mapped file and getting a pointer to its data.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWFromFileMapped
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWGetPointer
+ */
+int
+rwops_testFileMapped(void)
+{
+   SDL_RWops *rw;
+   const char *data;
+   char buf[sizeof(RWopsAlphabetString)];
+   size_t available, slen = SDL_strlen(RWopsAlphabetString);
+   Sint64 sv;
+   void *loaded;
+
+   rw = SDL_RWFromFileMapped(RWopsAlphabetFilename);
+   SDLTest_AssertPass("Call to SDL_RWFromFileMapped() succeeded");
+   SDLTest_AssertCheck(rw != NULL, "Verify opening file with SDL_RWFromFileMapped does not return NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   SDLTest_AssertCheck(
+      rw->type == SDL_RWOPS_MAPPED || rw->type == SDL_RWOPS_MEMORY_RO,
+      "Verify RWops type is SDL_RWOPS_MAPPED or SDL_RWOPS_MEMORY_RO; got: %d", rw->type);
+   SDLTest_AssertCheck(SDL_RWsize(rw) == (Sint64) slen, "Verify size of the mapped file");
+
+   data = (const char *) SDL_RWGetPointer(rw, &available);
+   SDLTest_AssertPass("Call to SDL_RWGetPointer() succeeded");
+   SDLTest_AssertCheck(data != NULL && available == slen, "Verify the whole file is available; got: %d bytes", (int) available);
+   if (data) {
+      SDLTest_AssertCheck(SDL_memcmp(data, RWopsAlphabetString, slen) == 0, "Verify mapped data contains the alphabet");
+   }
+
+   sv = SDL_RWseek(rw, 20, RW_SEEK_SET);
+   SDLTest_AssertCheck(sv == 20, "Verify seek to 20; got: %d", (int) sv);
+   data = (const char *) SDL_RWGetPointer(rw, &available);
+   SDLTest_AssertCheck(data != NULL && available == slen - 20 && *data == 'U', "Verify pointer follows the stream position");
+   SDLTest_AssertCheck(SDL_RWwrite(rw, "x", 1, 1) == 0, "Verify writing to a mapped file fails");
+   SDL_zero(buf);
+   SDLTest_AssertCheck(SDL_RWread(rw, buf, 1, sizeof(buf)) == slen - 20, "Verify read to the end of the file");
+   SDLTest_AssertCheck(SDL_strcmp(buf, "UVWXYZ") == 0, "Verify read data; got: %s", buf);
+
+   SDL_RWseek(rw, 0, RW_SEEK_SET);
+   loaded = SDL_LoadFile_RW(rw, &available, 1);
+   SDLTest_AssertPass("Call to SDL_LoadFile_RW() succeeded");
+   SDLTest_AssertCheck(
+      loaded != NULL && available == slen && SDL_strcmp((const char *) loaded, RWopsAlphabetString) == 0,
+      "Verify SDL_LoadFile_RW() copies the mapped file");
+   SDL_free(loaded);
+
+   rw = SDL_RWFromFile(RWopsAlphabetFilename, "r");
+   SDLTest_AssertCheck(rw != NULL && SDL_RWGetPointer(rw, &available) == NULL, "Verify SDL_RWGetPointer() returns NULL for a stdio file");
+   SDL_RWclose(rw);
+
+   return TEST_COMPLETED;
+}
+
+/* Writes a pack file with two buckets and 16 byte alignment to buffer */
+static size_t
+_writePack(Uint8 *buffer, const char **names, const Uint8 **data, const Uint32 *sizes, int count)
+{
+   const Uint32 num_buckets = 2;
+   Uint32 header[8], buckets[3] = { 0, 0, 0 };
+   Uint32 hashes[8], name_offsets[8], data_offsets[8];
+   Uint32 names_size = 0, offset;
+   Uint8 *p = buffer;
+   int i, b;
+
+   for (i = 0; i < count; i++) {
+      const char *c;
+      hashes[i] = 2166136261u;
+      for (c = names[i]; *c; c++) {
+         hashes[i] = (hashes[i] ^ (Uint8) *c) * 16777619u;
+      }
+      name_offsets[i] = names_size;
+      names_size += (Uint32) SDL_strlen(names[i]);
+      buckets[(hashes[i] & (num_buckets - 1)) + 1]++;
+   }
+   buckets[2] += buckets[1];
+
+   offset = 32 + sizeof(buckets) + count * 24 + names_size;
+   for (i = 0; i < count; i++) {
+      offset = (offset + 15) & ~15;
+      data_offsets[i] = offset;
+      offset += sizes[i];
+   }
+
+   header[0] = SDL_SwapLE32(0x504C4453);
+   header[1] = SDL_SwapLE32(1);
+   header[2] = SDL_SwapLE32(count);
+   header[3] = SDL_SwapLE32(num_buckets);
+   header[4] = SDL_SwapLE32(names_size);
+   header[5] = SDL_SwapLE32(16);
+   header[6] = header[7] = 0;
+   SDL_memcpy(p, header, sizeof(header));
+   p += sizeof(header);
+   for (b = 0; b <= 2; b++) {
+      Uint32 value = SDL_SwapLE32(buckets[b]);
+      SDL_memcpy(p, &value, 4);
+      p += 4;
+   }
+   for (b = 0; b < 2; b++) {
+      for (i = 0; i < count; i++) {
+         Uint32 entry[6];
+         Uint64 data_offset = SDL_SwapLE64(data_offsets[i]);
+         if ((int) (hashes[i] & (num_buckets - 1)) != b) continue;
+         entry[0] = SDL_SwapLE32(hashes[i]);
+         entry[1] = SDL_SwapLE32(name_offsets[i]);
+         entry[2] = SDL_SwapLE32((Uint32) SDL_strlen(names[i]));
+         entry[3] = SDL_SwapLE32(sizes[i]);
+         SDL_memcpy(&entry[4], &data_offset, 8);
+         SDL_memcpy(p, entry, 24);
+         p += 24;
+      }
+   }
+   for (i = 0; i < count; i++) {
+      SDL_memcpy(p, names[i], SDL_strlen(names[i]));
+      p += SDL_strlen(names[i]);
+   }
+   for (i = 0; i < count; i++) {
+      SDL_memset(p, 0, buffer + data_offsets[i] - p);
+      SDL_memcpy(buffer + data_offsets[i], data[i], sizes[i]);
+      p = buffer + data_offsets[i] + sizes[i];
+   }
+   return (size_t) (p - buffer);
+}
+
+/**
+ * @brief Tests opening the entries of a pack file.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_OpenPackRW
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWFromPack
+ */
+int
+rwops_testPack(void)
+{
+   const char *names[] = { "alphabet.txt", "dir/bytes.bin", "empty", "dir/alphabet.txt" };
+   Uint8 bytes[100], pack_data[1024], buf[128];
+   const Uint8 *data[4];
+   Uint32 sizes[4];
+   SDL_RWops *rw, *rw2;
+   SDL_Pack *pack;
+   size_t pack_size, s;
+   Sint64 sv;
+   int i;
+
+   for (i = 0; i < (int) sizeof(bytes); i++) {
+      bytes[i] = (Uint8) (i * 3);
+   }
+   data[0] = (const Uint8 *) RWopsAlphabetString;
+   sizes[0] = (Uint32) SDL_strlen(RWopsAlphabetString);
+   data[1] = bytes;
+   sizes[1] = sizeof(bytes);
+   data[2] = bytes;
+   sizes[2] = 0;
+   data[3] = (const Uint8 *) RWopsHelloWorldTestString;
+   sizes[3] = (Uint32) SDL_strlen(RWopsHelloWorldTestString);
+   pack_size = _writePack(pack_data, names, data, sizes, 4);
+
+   pack = SDL_OpenPackRW(SDL_RWFromConstMem(pack_data, (int) pack_size), 1);
+   SDLTest_AssertPass("Call to SDL_OpenPackRW() succeeded");
+   SDLTest_AssertCheck(pack != NULL, "Verify SDL_OpenPackRW() does not return NULL");
+   if (pack == NULL) return TEST_ABORTED;
+
+   for (i = 0; i < 4; i++) {
+      rw = SDL_RWFromPack(pack, names[i]);
+      SDLTest_AssertCheck(rw != NULL, "Verify entry '%s' is found", names[i]);
+      if (rw == NULL) continue;
+      SDLTest_AssertCheck(rw->type == SDL_RWOPS_PACK, "Verify RWops type is SDL_RWOPS_PACK; got: %d", rw->type);
+      SDLTest_AssertCheck(SDL_RWsize(rw) == sizes[i], "Verify size of entry '%s'", names[i]);
+      s = SDL_RWread(rw, buf, 1, sizeof(buf));
+      SDLTest_AssertCheck(s == sizes[i] && SDL_memcmp(buf, data[i], s) == 0, "Verify contents of entry '%s'", names[i]);
+      SDLTest_AssertCheck(SDL_RWread(rw, buf, 1, 1) == 0, "Verify read at the end of entry '%s' returns 0", names[i]);
+      SDLTest_AssertCheck(SDL_RWwrite(rw, "x", 1, 1) == 0, "Verify writing to a pack entry fails");
+      SDL_RWclose(rw);
+   }
+
+   SDLTest_AssertCheck(SDL_RWFromPack(pack, "missing") == NULL, "Verify a missing entry is not found");
+   SDLTest_AssertCheck(SDL_RWFromPack(pack, "dir/bytes.bi") == NULL, "Verify a prefix of a name is not found");
+
+   /* Interleaved reads of two entries over the shared source */
+   rw = SDL_RWFromPack(pack, "dir/bytes.bin");
+   rw2 = SDL_RWFromPack(pack, "alphabet.txt");
+   SDLTest_AssertCheck(rw != NULL && rw2 != NULL, "Verify two entries can be open at once");
+   if (rw == NULL || rw2 == NULL) return TEST_ABORTED;
+   sv = SDL_RWseek(rw, -10, RW_SEEK_END);
+   SDLTest_AssertCheck(sv == 90, "Verify seek to 10 bytes before the end; got: %d", (int) sv);
+   SDLTest_AssertCheck(SDL_RWread(rw2, buf, 1, 3) == 3 && SDL_memcmp(buf, "ABC", 3) == 0, "Verify read from the second entry");
+   SDLTest_AssertCheck(SDL_RWread(rw, buf, 4, 3) == 2 && buf[0] == (Uint8) 270 && buf[7] == (Uint8) 291, "Verify whole objects are read up to the end of the entry");
+   SDLTest_AssertCheck(SDL_RWseek(rw, 0, RW_SEEK_CUR) == 98, "Verify position after a short read");
+   SDLTest_AssertCheck(SDL_RWread(rw2, buf, 1, 3) == 3 && SDL_memcmp(buf, "DEF", 3) == 0, "Verify the second entry kept its position");
+
+   /* Entries stay readable after the pack is closed */
+   SDL_ClosePack(pack);
+   SDLTest_AssertPass("Call to SDL_ClosePack() succeeded");
+   SDL_RWseek(rw, 0, RW_SEEK_SET);
+   SDLTest_AssertCheck(SDL_RWread(rw, buf, 1, 4) == 4 && buf[3] == 9, "Verify reading an entry after the pack was closed");
+   SDL_RWclose(rw);
+   SDL_RWclose(rw2);
+
+   /* Not a pack */
+   pack = SDL_OpenPackRW(SDL_RWFromConstMem(RWopsAlphabetString, (int) SDL_strlen(RWopsAlphabetString)), 1);
+   SDLTest_AssertCheck(pack == NULL, "Verify SDL_OpenPackRW() fails on other data");
+
+   /* Truncated directory */
+   pack = SDL_OpenPackRW(SDL_RWFromConstMem(pack_data, 40), 1);
+   SDLTest_AssertCheck(pack == NULL, "Verify SDL_OpenPackRW() fails on a truncated pack");
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests compressing a stream and reading it back with seeks.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_CompressRW
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWFromCompressed
+ */
+int
+rwops_testCompressed(void)
+{
+   const size_t size = 200000, block_size = 4096;
+   const size_t capacity = size + 24 + 4 * (size / block_size + 1);
+   Uint8 *original, *packed, *buf;
+   SDL_RWops *src, *dst, *rw;
+   Sint64 written, sv;
+   Uint32 seed = 1;
+   size_t i, s;
+   int ok;
+
+   original = (Uint8 *) SDL_malloc(size);
+   packed = (Uint8 *) SDL_malloc(capacity);
+   buf = (Uint8 *) SDL_malloc(size);
+   SDLTest_AssertCheck(original && packed && buf, "Verify buffers were allocated");
+   if (!original || !packed || !buf) {
+      SDL_free(original);
+      SDL_free(packed);
+      SDL_free(buf);
+      return TEST_ABORTED;
+   }
+
+   /* Text that compresses well, with a stretch of noise that doesn't */
+   for (i = 0; i < size; i++) {
+      seed = seed * 1103515245 + 12345;
+      if (i >= 50000 && i < 70000) {
+         original[i] = (Uint8) (seed >> 16);
+      } else {
+         original[i] = (Uint8) RWopsAlphabetString[((seed >> 24) < 8) ? (seed >> 16) % 26 : (i / 7) % 26];
+      }
+   }
+
+   src = SDL_RWFromConstMem(original, (int) size);
+   dst = SDL_RWFromMem(packed, (int) capacity);
+   SDLTest_AssertCheck(SDL_CompressRW(src, dst, block_size) == 0, "Verify SDL_CompressRW() succeeds");
+   written = SDL_RWtell(dst);
+   SDLTest_AssertCheck(written > 0 && written < (Sint64) size / 2, "Verify the data was compressed; got: %d bytes", (int) written);
+   SDL_RWclose(src);
+   SDL_RWclose(dst);
+
+   rw = SDL_RWFromCompressed(SDL_RWFromConstMem(packed, (int) written), 1);
+   SDLTest_AssertPass("Call to SDL_RWFromCompressed() succeeded");
+   SDLTest_AssertCheck(rw != NULL, "Verify SDL_RWFromCompressed() does not return NULL");
+   if (rw == NULL) {
+      SDL_free(original);
+      SDL_free(packed);
+      SDL_free(buf);
+      return TEST_ABORTED;
+   }
+   SDLTest_AssertCheck(rw->type == SDL_RWOPS_COMPRESSED, "Verify RWops type is SDL_RWOPS_COMPRESSED; got: %d", rw->type);
+   SDLTest_AssertCheck(SDL_RWsize(rw) == (Sint64) size, "Verify the uncompressed size");
+
+   s = SDL_RWread(rw, buf, 1, size);
+   SDLTest_AssertCheck(s == size && SDL_memcmp(buf, original, size) == 0, "Verify reading the whole stream");
+   SDLTest_AssertCheck(SDL_RWread(rw, buf, 1, 1) == 0, "Verify read at the end returns 0");
+
+   /* Random seeks and reads across block boundaries */
+   ok = 1;
+   for (i = 0; i < 500 && ok; i++) {
+      const Sint64 pos = SDLTest_RandomIntegerInRange(0, (Sint32) size);
+      const size_t len = (size_t) SDLTest_RandomIntegerInRange(0, 3 * (Sint32) block_size);
+      const size_t expected = SDL_min(len, size - (size_t) pos);
+
+      sv = SDL_RWseek(rw, pos, RW_SEEK_SET);
+      s = SDL_RWread(rw, buf, 1, len);
+      ok = (sv == pos && s == expected && SDL_memcmp(buf, original + pos, expected) == 0 &&
+            SDL_RWtell(rw) == pos + (Sint64) expected);
+   }
+   SDLTest_AssertCheck(ok, "Verify random seeks and reads match the original data");
+
+   sv = SDL_RWseek(rw, -10, RW_SEEK_END);
+   s = SDL_RWread(rw, buf, 4, 3);
+   SDLTest_AssertCheck(s == 2 && SDL_RWtell(rw) == (Sint64) size - 2, "Verify whole objects are read up to the end");
+   SDLTest_AssertCheck(SDL_RWwrite(rw, "x", 1, 1) == 0, "Verify writing to a compressed stream fails");
+   SDL_RWclose(rw);
+
+   /* A damaged block must not be read past its bounds */
+   packed[24 + 4 * (size / block_size + 1) + 10] ^= 0x5A;
+   rw = SDL_RWFromCompressed(SDL_RWFromConstMem(packed, (int) written), 1);
+   SDLTest_AssertCheck(rw != NULL, "Verify a stream with a damaged block can be opened");
+   if (rw) {
+      s = SDL_RWread(rw, buf, 1, size);
+      SDLTest_AssertPass("Call to SDL_RWread() on a damaged stream returned %d bytes", (int) s);
+      SDL_RWclose(rw);
+   }
+
+   /* Empty streams */
+   src = SDL_RWFromConstMem(original, 1);
+   SDL_RWseek(src, 1, RW_SEEK_SET);
+   dst = SDL_RWFromMem(packed, (int) capacity);
+   SDLTest_AssertCheck(SDL_CompressRW(src, dst, 0) == 0, "Verify compressing an empty stream");
+   written = SDL_RWtell(dst);
+   SDL_RWclose(src);
+   SDL_RWclose(dst);
+   rw = SDL_RWFromCompressed(SDL_RWFromConstMem(packed, (int) written), 1);
+   SDLTest_AssertCheck(rw != NULL && SDL_RWsize(rw) == 0 && SDL_RWread(rw, buf, 1, 1) == 0, "Verify reading an empty compressed stream");
+   SDL_RWclose(rw);
+
+   rw = SDL_RWFromCompressed(SDL_RWFromConstMem(RWopsAlphabetString, (int) SDL_strlen(RWopsAlphabetString)), 1);
+   SDLTest_AssertCheck(rw == NULL, "Verify SDL_RWFromCompressed() fails on other data");
+
+   /* Headers claiming more blocks than the stream could hold */
+   SDL_memset(packed, 0, 64);
+   SDL_memcpy(packed, "SDLZ", 4);
+   packed[4] = 1;
+   packed[9] = 1;    /* 256 byte blocks */
+   packed[17] = 1;   /* 1 TB */
+   rw = SDL_RWFromCompressed(SDL_RWFromConstMem(packed, 64), 1);
+   SDLTest_AssertCheck(rw == NULL, "Verify SDL_RWFromCompressed() fails on a block table past the end");
+   packed[9] = 0;
+   packed[8] = 1;    /* 1 byte blocks */
+   packed[17] = 0;
+   packed[12] = 8;
+   rw = SDL_RWFromCompressed(SDL_RWFromConstMem(packed, 64), 1);
+   SDLTest_AssertCheck(rw == NULL, "Verify SDL_RWFromCompressed() fails on tiny blocks");
+   src = SDL_RWFromConstMem(original, (int) size);
+   dst = SDL_RWFromMem(packed, (int) capacity);
+   SDLTest_AssertCheck(SDL_CompressRW(src, dst, 16) < 0, "Verify SDL_CompressRW() rejects tiny blocks");
+   SDL_RWclose(src);
+   SDL_RWclose(dst);
+
+   SDL_free(original);
+   SDL_free(packed);
+   SDL_free(buf);
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests writing and reading arrays with the endian aware functions.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_ReadLE16Array
+ * http://wiki.libsdl.org/moin.cgi/SDL_WriteBE64Array
+ */
+int
+rwops_testEndianArrays(void)
+{
+   const size_t count = 301;   /* more than one scratch chunk, with a tail */
+   Uint16 *v16, *r16;
+   Uint32 *v32, *r32;
+   Uint64 *v64, *r64;
+   Uint8 *mem;
+   SDL_RWops *rw;
+   size_t i, total;
+   int le, ok;
+
+   total = count * (2 + 4 + 8);
+   mem = (Uint8 *) SDL_malloc(total);
+   v16 = (Uint16 *) SDL_malloc(count * sizeof(Uint16) * 2);
+   v32 = (Uint32 *) SDL_malloc(count * sizeof(Uint32) * 2);
+   v64 = (Uint64 *) SDL_malloc(count * sizeof(Uint64) * 2);
+   SDLTest_AssertCheck(mem && v16 && v32 && v64, "Verify buffers were allocated");
+   if (!mem || !v16 || !v32 || !v64) {
+      SDL_free(mem);
+      SDL_free(v16);
+      SDL_free(v32);
+      SDL_free(v64);
+      return TEST_ABORTED;
+   }
+   r16 = v16 + count;
+   r32 = v32 + count;
+   r64 = v64 + count;
+   for (i = 0; i < count; i++) {
+      v16[i] = (Uint16) SDLTest_RandomUint16();
+      v32[i] = SDLTest_RandomUint32();
+      v64[i] = SDLTest_RandomUint64();
+   }
+
+   for (le = 0; le <= 1; le++) {
+      const char *order = le ? "LE" : "BE";
+
+      rw = SDL_RWFromMem(mem, (int) total);
+      if (le) {
+         SDLTest_AssertCheck(SDL_WriteLE16Array(rw, v16, count) == count, "Verify SDL_WriteLE16Array() wrote every value");
+         SDLTest_AssertCheck(SDL_WriteLE32Array(rw, v32, count) == count, "Verify SDL_WriteLE32Array() wrote every value");
+         SDLTest_AssertCheck(SDL_WriteLE64Array(rw, v64, count) == count, "Verify SDL_WriteLE64Array() wrote every value");
+      } else {
+         SDLTest_AssertCheck(SDL_WriteBE16Array(rw, v16, count) == count, "Verify SDL_WriteBE16Array() wrote every value");
+         SDLTest_AssertCheck(SDL_WriteBE32Array(rw, v32, count) == count, "Verify SDL_WriteBE32Array() wrote every value");
+         SDLTest_AssertCheck(SDL_WriteBE64Array(rw, v64, count) == count, "Verify SDL_WriteBE64Array() wrote every value");
+      }
+      SDLTest_AssertCheck(SDL_WriteLE16Array(rw, v16, 1) == 0, "Verify writing past the end of the memory stream fails");
+
+      /* Check the bytes against the single value functions */
+      SDL_RWseek(rw, 0, RW_SEEK_SET);
+      ok = 1;
+      for (i = 0; i < count; i++) {
+         ok &= ((le ? SDL_ReadLE16(rw) : SDL_ReadBE16(rw)) == v16[i]);
+      }
+      for (i = 0; i < count; i++) {
+         ok &= ((le ? SDL_ReadLE32(rw) : SDL_ReadBE32(rw)) == v32[i]);
+      }
+      for (i = 0; i < count; i++) {
+         ok &= ((le ? SDL_ReadLE64(rw) : SDL_ReadBE64(rw)) == v64[i]);
+      }
+      SDLTest_AssertCheck(ok, "Verify the %s arrays were written in %s byte order", order, order);
+
+      SDL_RWseek(rw, 0, RW_SEEK_SET);
+      SDL_memset(r16, 0, count * sizeof(Uint16));
+      SDL_memset(r32, 0, count * sizeof(Uint32));
+      SDL_memset(r64, 0, count * sizeof(Uint64));
+      if (le) {
+         SDLTest_AssertCheck(SDL_ReadLE16Array(rw, r16, count) == count, "Verify SDL_ReadLE16Array() read every value");
+         SDLTest_AssertCheck(SDL_ReadLE32Array(rw, r32, count) == count, "Verify SDL_ReadLE32Array() read every value");
+         SDLTest_AssertCheck(SDL_ReadLE64Array(rw, r64, count) == count, "Verify SDL_ReadLE64Array() read every value");
+      } else {
+         SDLTest_AssertCheck(SDL_ReadBE16Array(rw, r16, count) == count, "Verify SDL_ReadBE16Array() read every value");
+         SDLTest_AssertCheck(SDL_ReadBE32Array(rw, r32, count) == count, "Verify SDL_ReadBE32Array() read every value");
+         SDLTest_AssertCheck(SDL_ReadBE64Array(rw, r64, count) == count, "Verify SDL_ReadBE64Array() read every value");
+      }
+      SDLTest_AssertCheck(
+         SDL_memcmp(r16, v16, count * sizeof(Uint16)) == 0 &&
+         SDL_memcmp(r32, v32, count * sizeof(Uint32)) == 0 &&
+         SDL_memcmp(r64, v64, count * sizeof(Uint64)) == 0,
+         "Verify the %s arrays read back the values written", order);
+
+      /* A short read converts only the values that were read */
+      SDL_RWseek(rw, -3, RW_SEEK_END);
+      SDLTest_AssertCheck(SDL_ReadLE16Array(rw, r16, 4) == 1, "Verify a short read returns the number of whole values");
+      SDL_RWclose(rw);
+   }
+
+   SDL_free(mem);
+   SDL_free(v16);
+   SDL_free(v32);
+   SDL_free(v64);
+   return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* RWops test cases */
@@ -733,10 +1272,25 @@ static const SDLTest_TestCaseReference rwopsTest9 =
 static const SDLTest_TestCaseReference rwopsTest10 =
         { (SDLTest_TestCaseFp)rwops_testCompareRWFromMemWithRWFromFile, "rwops_testCompareRWFromMemWithRWFromFile", "Compare RWFromMem and RWFromFile RWops for read and seek", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference rwopsTest11 =
+        { (SDLTest_TestCaseFp)rwops_testBuffered, "rwops_testBuffered", "Test a buffered stream against the stream it wraps", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference rwopsTest12 =
+        { (SDLTest_TestCaseFp)rwops_testFileMapped, "rwops_testFileMapped", "Test reading a mapped file in place", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference rwopsTest13 =
+        { (SDLTest_TestCaseFp)rwops_testPack, "rwops_testPack", "Test opening the entries of a pack file", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference rwopsTest14 =
+        { (SDLTest_TestCaseFp)rwops_testCompressed, "rwops_testCompressed", "Test compressing a stream and reading it back", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference rwopsTest15 =
+        { (SDLTest_TestCaseFp)rwops_testEndianArrays, "rwops_testEndianArrays", "Test writing and reading arrays via the Endian aware functions", TEST_ENABLED };
+
 /* Sequence of RWops test cases */
 static const SDLTest_TestCaseReference *rwopsTests[] =  {
     &rwopsTest1, &rwopsTest2, &rwopsTest3, &rwopsTest4, &rwopsTest5, &rwopsTest6,
-    &rwopsTest7, &rwopsTest8, &rwopsTest9, &rwopsTest10, NULL
+    &rwopsTest7, &rwopsTest8, &rwopsTest9, &rwopsTest10, &rwopsTest11, &rwopsTest12, &rwopsTest13, &rwopsTest14, &rwopsTest15, NULL
 };
 
 /* RWops test suite (global) */
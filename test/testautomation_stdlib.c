@@ -290,6 +290,183 @@ stdlib_sscanf(void *arg)
   return TEST_COMPLETED;
 }
 
+/* Convert with SDL_iconv(), giving it at most chunk bytes of output space
+   at a time, returns the number of bytes written */
+static size_t
+stdlib_iconvChunked(const char *tocode, const char *fromcode, const char *inbuf, size_t inbytes,
+                    char *outbuf, size_t outsize, size_t chunk, size_t *inbytesleft)
+{
+  SDL_iconv_t cd = SDL_iconv_open(tocode, fromcode);
+  const char *src = inbuf;
+  size_t srclen = inbytes;
+  size_t written = 0;
+
+  SDLTest_AssertCheck(cd != (SDL_iconv_t)-1, "Check SDL_iconv_open(\"%s\", \"%s\")", tocode, fromcode);
+  if (cd == (SDL_iconv_t)-1) {
+    *inbytesleft = inbytes;
+    return 0;
+  }
+  while (srclen > 0) {
+    char *dst = outbuf + written;
+    size_t dstlen = SDL_min(chunk, outsize - written);
+    size_t result = SDL_iconv(cd, &src, &srclen, &dst, &dstlen);
+
+    if (result == SDL_ICONV_E2BIG && dst == outbuf + written) {
+      break;
+    }
+    written = dst - outbuf;
+    if (result == SDL_ICONV_ERROR || result == SDL_ICONV_EILSEQ || result == SDL_ICONV_EINVAL) {
+      break;
+    }
+  }
+  SDL_iconv_close(cd);
+  *inbytesleft = srclen;
+  return written;
+}
+
+/* Reverse the byte order of each unit of a buffer */
+static void
+stdlib_iconvSwap(char *buf, size_t len, size_t unit)
+{
+  size_t i, j;
+
+  for (i = 0; i + unit <= len; i += unit) {
+    for (j = 0; j < unit / 2; ++j) {
+      const char tmp = buf[i + j];
+      buf[i + j] = buf[i + unit - 1 - j];
+      buf[i + unit - 1 - j] = tmp;
+    }
+  }
+}
+
+/* Build a UTF-8 string mixing ASCII runs, multibyte characters and invalid
+   sequences, returns its length */
+static size_t
+stdlib_iconvRandomUTF8(Uint8 *buf, size_t size)
+{
+  static const Uint8 invalid[][4] = {
+    { 0xFF }, { 0x80 }, { 0xC0, 0x80 }, { 0xE0, 0x80, 0x80 }, { 0xED, 0xA0, 0x80 },
+    { 0xEF, 0xBF, 0xBF }, { 0xF4, 0x90, 0x80, 0x80 }, { 0xC3 }, { 0xE2, 0x82 }
+  };
+  size_t len = 0;
+
+  while (len + 32 < size) {
+    const int kind = SDLTest_RandomIntegerInRange(0, 9);
+    Uint32 ch;
+    int i, count;
+
+    if (kind < 4) {
+      count = SDLTest_RandomIntegerInRange(1, 24);
+      for (i = 0; i < count; ++i) {
+        buf[len++] = (Uint8)SDLTest_RandomIntegerInRange(0x20, 0x7E);
+      }
+      continue;
+    }
+    if (kind == 9) {
+      const Uint8 *sequence = invalid[SDLTest_RandomIntegerInRange(0, SDL_arraysize(invalid) - 1)];
+      for (i = 0; i < 4 && sequence[i]; ++i) {
+        buf[len++] = sequence[i];
+      }
+      continue;
+    }
+    if (kind < 6) {
+      ch = SDLTest_RandomIntegerInRange(0x80, 0x7FF);
+      buf[len++] = 0xC0 | (Uint8)(ch >> 6);
+    } else if (kind < 8) {
+      ch = SDLTest_RandomIntegerInRange(0x800, 0xD7FF);
+      buf[len++] = 0xE0 | (Uint8)(ch >> 12);
+      buf[len++] = 0x80 | (Uint8)((ch >> 6) & 0x3F);
+    } else {
+      ch = SDLTest_RandomIntegerInRange(0x10000, 0x10FFFF);
+      buf[len++] = 0xF0 | (Uint8)(ch >> 18);
+      buf[len++] = 0x80 | (Uint8)((ch >> 12) & 0x3F);
+      buf[len++] = 0x80 | (Uint8)((ch >> 6) & 0x3F);
+    }
+    buf[len++] = 0x80 | (Uint8)(ch & 0x3F);
+  }
+  return len;
+}
+
+/**
+ * @brief Call to SDL_iconv between UTF-8 and UTF-16LE or UCS-4LE
+ *
+ * These conversions have fast paths, so compare them with the big endian
+ * conversions, which go through the generic code.
+ */
+int
+stdlib_iconv(void *arg)
+{
+  static const struct {
+    const char *le;
+    const char *be;
+    size_t unit;
+  } formats[] = {
+    { "UTF-16LE", "UTF-16BE", 2 },
+    { "UCS-4LE", "UCS-4BE", 4 },
+    { "UTF-32LE", "UTF-32BE", 4 }
+  };
+  static const size_t chunks[] = { 6, 37, 4096 };
+  const size_t size = 2048;
+  Uint8 *utf8 = (Uint8 *)SDL_malloc(size);
+  char *le = (char *)SDL_malloc(size * 4);
+  char *be = (char *)SDL_malloc(size * 4);
+  char *back_le = (char *)SDL_malloc(size * 4);
+  char *back_be = (char *)SDL_malloc(size * 4);
+  size_t utf8_len, le_len, be_len, back_le_len, back_be_len;
+  size_t le_left, be_left;
+  int i, j, k;
+
+  SDLTest_AssertCheck(utf8 && le && be && back_le && back_be, "Check buffer allocation");
+  if (!utf8 || !le || !be || !back_le || !back_be) {
+    return TEST_ABORTED;
+  }
+
+  for (k = 0; k < 8; ++k) {
+    utf8_len = stdlib_iconvRandomUTF8(utf8, size);
+    if (k & 1) {
+      /* End in the middle of a character */
+      utf8[utf8_len++] = 0xE2;
+    }
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+      for (j = 0; j < SDL_arraysize(chunks); ++j) {
+        le_len = stdlib_iconvChunked(formats[i].le, "UTF-8", (const char *)utf8, utf8_len, le, size * 4, chunks[j], &le_left);
+        be_len = stdlib_iconvChunked(formats[i].be, "UTF-8", (const char *)utf8, utf8_len, be, size * 4, chunks[j], &be_left);
+        stdlib_iconvSwap(be, be_len, formats[i].unit);
+        SDLTest_AssertCheck(le_len == be_len && le_left == be_left && SDL_memcmp(le, be, le_len) == 0,
+                            "Check UTF-8 to %s with %d byte chunks, expected %d bytes, got %d",
+                            formats[i].le, (int)chunks[j], (int)be_len, (int)le_len);
+        SDLTest_AssertCheck(le_left == ((k & 1) ? 1 : 0), "Check unconverted input, expected %d, got %d",
+                            (k & 1) ? 1 : 0, (int)le_left);
+
+        /* Add a lone surrogate or an out of range character, and convert back */
+        if (formats[i].unit == 2) {
+          le[le_len++] = (char)0x00;
+          le[le_len++] = (char)0xDC;
+        } else {
+          le[le_len++] = (char)0x00;
+          le[le_len++] = (char)0x00;
+          le[le_len++] = (char)0x11;
+          le[le_len++] = (char)0x00;
+        }
+        SDL_memcpy(be, le, le_len);
+        stdlib_iconvSwap(be, le_len, formats[i].unit);
+        back_le_len = stdlib_iconvChunked("UTF-8", formats[i].le, le, le_len, back_le, size * 4, chunks[j], &le_left);
+        back_be_len = stdlib_iconvChunked("UTF-8", formats[i].be, be, le_len, back_be, size * 4, chunks[j], &be_left);
+        SDLTest_AssertCheck(back_le_len == back_be_len && le_left == be_left && SDL_memcmp(back_le, back_be, back_le_len) == 0,
+                            "Check %s to UTF-8 with %d byte chunks, expected %d bytes, got %d",
+                            formats[i].le, (int)chunks[j], (int)back_be_len, (int)back_le_len);
+      }
+    }
+  }
+
+  SDL_free(utf8);
+  SDL_free(le);
+  SDL_free(be);
+  SDL_free(back_le);
+  SDL_free(back_be);
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Standard C routine test cases */
@@ -305,9 +482,12 @@ static const SDLTest_TestCaseReference stdlibTest3 =
 static const SDLTest_TestCaseReference stdlibTest4 =
         { (SDLTest_TestCaseFp)stdlib_sscanf, "stdlib_sscanf", "Call to SDL_sscanf", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference stdlibTest5 =
+        { (SDLTest_TestCaseFp)stdlib_iconv, "stdlib_iconv", "Call to SDL_iconv between UTF-8 and UTF-16LE or UCS-4LE", TEST_ENABLED };
+
 /* Sequence of Standard C routine test cases */
 static const SDLTest_TestCaseReference *stdlibTests[] =  {
-    &stdlibTest1, &stdlibTest2, &stdlibTest3, &stdlibTest4, NULL
+    &stdlibTest1, &stdlibTest2, &stdlibTest3, &stdlibTest4, &stdlibTest5, NULL
 };
 
 /* Standard C routine test suite (global) */
@@ -259,6 +259,656 @@ surface_testSaveLoadBitmap(void *arg)
     return TEST_COMPLETED;
 }
 
+/* Helper that checks SDL_LoadBMPFormat_RW() against converting the
+   surface from SDL_LoadBMP_RW() */
+static void
+_testLoadBitmapFormats(const void *bmp, size_t size, const char *what)
+{
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_ARGB8888,
+        SDL_PIXELFORMAT_ABGR8888,
+        SDL_PIXELFORMAT_RGB888,
+        SDL_PIXELFORMAT_RGB24,
+        SDL_PIXELFORMAT_RGB565,
+        SDL_PIXELFORMAT_ARGB4444,
+        SDL_PIXELFORMAT_ARGB1555,
+        SDL_PIXELFORMAT_INDEX8,
+    };
+    SDL_Surface *loaded, *expected, *rface;
+    int i, y, differ;
+
+    loaded = SDL_LoadBMP_RW(SDL_RWFromConstMem(bmp, (int)size), 1);
+    SDLTest_AssertCheck(loaded != NULL, "Verify %s loads with SDL_LoadBMP_RW", what);
+    if (loaded == NULL) {
+        return;
+    }
+
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        const char *name = SDL_GetPixelFormatName(formats[i]);
+
+        expected = SDL_ConvertSurfaceFormat(loaded, formats[i], 0);
+        rface = SDL_LoadBMPFormat_RW(SDL_RWFromConstMem(bmp, (int)size), 1, formats[i]);
+        SDLTest_AssertPass("Call to SDL_LoadBMPFormat_RW(%s)", name);
+        SDLTest_AssertCheck(rface != NULL, "Verify result from SDL_LoadBMPFormat_RW is not NULL");
+        if (rface == NULL || expected == NULL) {
+            SDL_FreeSurface(expected);
+            SDL_FreeSurface(rface);
+            continue;
+        }
+        SDLTest_AssertCheck(rface->format->format == formats[i], "Verify format of loaded surface, expected: %s, got: %s", name, SDL_GetPixelFormatName(rface->format->format));
+        SDLTest_AssertCheck(rface->w == expected->w && rface->h == expected->h, "Verify size of loaded surface, expected: %ix%i, got: %ix%i", expected->w, expected->h, rface->w, rface->h);
+        if (rface->format->format == formats[i] && rface->w == expected->w && rface->h == expected->h) {
+            differ = 0;
+            for (y = 0; y < rface->h; ++y) {
+                if (SDL_memcmp((Uint8 *)rface->pixels + y * rface->pitch,
+                               (Uint8 *)expected->pixels + y * expected->pitch,
+                               rface->w * rface->format->BytesPerPixel) != 0) {
+                    ++differ;
+                }
+            }
+            SDLTest_AssertCheck(differ == 0, "Verify %s in %s matches the converted surface, rows differing: %i", what, name, differ);
+        }
+        SDL_FreeSurface(expected);
+        SDL_FreeSurface(rface);
+    }
+    SDL_FreeSurface(loaded);
+}
+
+/**
+ * @brief Tests loading bitmaps straight into other pixel formats.
+ */
+int
+surface_testLoadBitmapFormat(void *arg)
+{
+    const size_t capacity = 1024 * 1024;
+    Uint8 *bmp;
+    SDL_Surface *face, *argb;
+    SDL_RWops *rw;
+    size_t size;
+    int ret, x, y;
+
+    bmp = (Uint8 *)SDL_malloc(capacity);
+    SDLTest_AssertCheck(bmp != NULL, "Verify buffer allocation");
+    if (bmp == NULL) return TEST_ABORTED;
+
+    /* Create sample surface */
+    face = SDLTest_ImageFace();
+    SDLTest_AssertCheck(face != NULL, "Verify face surface is not NULL");
+    if (face == NULL) {
+        SDL_free(bmp);
+        return TEST_ABORTED;
+    }
+    argb = SDL_ConvertSurfaceFormat(face, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDLTest_AssertCheck(argb != NULL, "Verify result from SDL_ConvertSurfaceFormat is not NULL");
+    if (argb == NULL) {
+        SDL_FreeSurface(face);
+        SDL_free(bmp);
+        return TEST_ABORTED;
+    }
+
+    /* A 32-bit bitmap with an alpha channel */
+    rw = SDL_RWFromMem(bmp, (int)capacity);
+    ret = SDL_SaveBMP_RW(face, rw, 0);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SaveBMP_RW, expected: 0, got: %i", ret);
+    size = (size_t)SDL_RWtell(rw);
+    SDL_RWclose(rw);
+    _testLoadBitmapFormats(bmp, size, "32-bit bitmap");
+
+    /* A 24-bit bitmap */
+    SDL_SetSurfaceBlendMode(argb, SDL_BLENDMODE_NONE);
+    {
+        SDL_Surface *rgb = SDL_ConvertSurfaceFormat(argb, SDL_PIXELFORMAT_RGB888, 0);
+        rw = SDL_RWFromMem(bmp, (int)capacity);
+        ret = SDL_SaveBMP_RW(rgb, rw, 0);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SaveBMP_RW, expected: 0, got: %i", ret);
+        size = (size_t)SDL_RWtell(rw);
+        SDL_RWclose(rw);
+        SDL_FreeSurface(rgb);
+    }
+    _testLoadBitmapFormats(bmp, size, "24-bit bitmap");
+
+    /* Legacy 32-bit bitmaps with no alpha in the rows stored first (the
+       bottom ones), and with none at all */
+    SDL_SetHint(SDL_HINT_BMP_SAVE_LEGACY_FORMAT, "1");
+    for (y = 0; y < argb->h; ++y) {
+        Uint32 *row = (Uint32 *)((Uint8 *)argb->pixels + y * argb->pitch);
+        for (x = 0; x < argb->w; ++x) {
+            row[x] &= (y >= argb->h / 2) ? 0x00FFFFFF : 0x7FFFFFFF;
+        }
+    }
+    rw = SDL_RWFromMem(bmp, (int)capacity);
+    ret = SDL_SaveBMP_RW(argb, rw, 0);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SaveBMP_RW, expected: 0, got: %i", ret);
+    size = (size_t)SDL_RWtell(rw);
+    SDL_RWclose(rw);
+    _testLoadBitmapFormats(bmp, size, "legacy bitmap with partial alpha");
+
+    for (y = 0; y < argb->h; ++y) {
+        Uint32 *row = (Uint32 *)((Uint8 *)argb->pixels + y * argb->pitch);
+        for (x = 0; x < argb->w; ++x) {
+            row[x] &= 0x00FFFFFF;
+        }
+    }
+    rw = SDL_RWFromMem(bmp, (int)capacity);
+    ret = SDL_SaveBMP_RW(argb, rw, 0);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SaveBMP_RW, expected: 0, got: %i", ret);
+    size = (size_t)SDL_RWtell(rw);
+    SDL_RWclose(rw);
+    SDL_SetHint(SDL_HINT_BMP_SAVE_LEGACY_FORMAT, NULL);
+    _testLoadBitmapFormats(bmp, size, "legacy bitmap without alpha");
+
+    /* Clean up */
+    SDL_FreeSurface(face);
+    SDL_FreeSurface(argb);
+    SDL_free(bmp);
+
+    return TEST_COMPLETED;
+}
+
+/* Helper that checks a blit into each destination against a fresh copy
+   of the source, which has no cached blit mappings */
+static void
+_testBlitMapDestinations(SDL_Surface *src, SDL_Surface **dsts, int count, const char *what)
+{
+    SDL_Surface *fresh, *expected;
+    Uint8 r, g, b;
+    int i, y, ret;
+
+    fresh = SDL_CreateRGBSurfaceWithFormat(0, src->w, src->h, 0, src->format->format);
+    SDLTest_AssertCheck(fresh != NULL, "Verify result from SDL_CreateRGBSurfaceWithFormat is not NULL");
+    if (fresh == NULL) {
+        return;
+    }
+    for (y = 0; y < src->h; ++y) {
+        SDL_memcpy((Uint8 *)fresh->pixels + y * fresh->pitch,
+                   (Uint8 *)src->pixels + y * src->pitch,
+                   src->w * src->format->BytesPerPixel);
+    }
+    if (src->format->palette) {
+        SDL_SetPaletteColors(fresh->format->palette, src->format->palette->colors, 0, src->format->palette->ncolors);
+    }
+    SDL_GetSurfaceColorMod(src, &r, &g, &b);
+    SDL_SetSurfaceColorMod(fresh, r, g, b);
+    SDL_SetSurfaceBlendMode(fresh, SDL_BLENDMODE_NONE);
+
+    for (i = 0; i < count; ++i) {
+        expected = SDL_CreateRGBSurfaceWithFormat(0, dsts[i]->w, dsts[i]->h, 0, dsts[i]->format->format);
+        SDLTest_AssertCheck(expected != NULL, "Verify result from SDL_CreateRGBSurfaceWithFormat is not NULL");
+        if (expected == NULL) {
+            continue;
+        }
+        ret = SDL_BlitSurface(src, NULL, dsts[i], NULL);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+        ret = SDL_BlitSurface(fresh, NULL, expected, NULL);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+        ret = SDLTest_CompareSurfaces(dsts[i], expected, 0);
+        SDLTest_AssertCheck(ret == 0, "Validate %s blit to %s, expected: 0, got: %i", what, SDL_GetPixelFormatName(dsts[i]->format->format), ret);
+        SDL_FreeSurface(expected);
+    }
+    SDL_FreeSurface(fresh);
+}
+
+/**
+ * @brief Tests blitting one surface to several destination formats in turn,
+ * which reuses the blit mappings cached by the source surface.
+ */
+int
+surface_testBlitMapCache(void *arg)
+{
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_ARGB8888,
+        SDL_PIXELFORMAT_RGB565,
+        SDL_PIXELFORMAT_RGB888,
+        SDL_PIXELFORMAT_ABGR8888,
+        SDL_PIXELFORMAT_ARGB8888,
+        SDL_PIXELFORMAT_BGR24,
+        SDL_PIXELFORMAT_ARGB1555,
+    };
+    SDL_Surface *dsts[SDL_arraysize(formats)];
+    SDL_Surface *face, *indexed;
+    SDL_Color colors[4];
+    int i, pass;
+
+    face = SDLTest_ImageFace();
+    SDLTest_AssertCheck(face != NULL, "Verify face surface is not NULL");
+    if (face == NULL) return TEST_ABORTED;
+    SDL_SetSurfaceBlendMode(face, SDL_BLENDMODE_NONE);
+    indexed = SDL_ConvertSurfaceFormat(face, SDL_PIXELFORMAT_INDEX8, 0);
+    SDLTest_AssertCheck(indexed != NULL, "Verify result from SDL_ConvertSurfaceFormat is not NULL");
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        dsts[i] = SDL_CreateRGBSurfaceWithFormat(0, face->w, face->h, 0, formats[i]);
+        SDLTest_AssertCheck(dsts[i] != NULL, "Verify result from SDL_CreateRGBSurfaceWithFormat is not NULL");
+        if (dsts[i] == NULL || indexed == NULL) {
+            return TEST_ABORTED;
+        }
+    }
+
+    /* More destination formats than the cache holds, several times over */
+    for (pass = 0; pass < 3; ++pass) {
+        _testBlitMapDestinations(face, dsts, SDL_arraysize(dsts), "RGB");
+        _testBlitMapDestinations(indexed, dsts, SDL_arraysize(dsts), "indexed");
+    }
+
+    /* Changing the source has to be seen in every destination */
+    SDL_SetSurfaceColorMod(face, 128, 255, 64);
+    _testBlitMapDestinations(face, dsts, SDL_arraysize(dsts), "color modulated RGB");
+    SDL_SetSurfaceColorMod(face, 255, 255, 255);
+    _testBlitMapDestinations(face, dsts, SDL_arraysize(dsts), "RGB");
+
+    for (i = 0; i < SDL_arraysize(colors); ++i) {
+        colors[i].r = (Uint8)(i * 80);
+        colors[i].g = 255;
+        colors[i].b = (Uint8)(255 - i * 80);
+        colors[i].a = 255;
+    }
+    SDL_SetPaletteColors(indexed->format->palette, colors, 0, SDL_arraysize(colors));
+    _testBlitMapDestinations(indexed, dsts, SDL_arraysize(dsts), "recolored indexed");
+
+    for (i = 0; i < SDL_arraysize(dsts); ++i) {
+        SDL_FreeSurface(dsts[i]);
+    }
+    SDL_FreeSurface(indexed);
+    SDL_FreeSurface(face);
+
+    return TEST_COMPLETED;
+}
+
+/* Helper to check a blit to a palettized surface against SDL_MapRGB() */
+static void
+_testBlitToPalette(SDL_Surface *src, SDL_Surface *dst, const SDL_Color *pixels, const SDL_Color *colorkey, const char *what)
+{
+    int x, y, mismatches = 0;
+
+    SDL_FillRect(dst, NULL, 0);
+    SDL_BlitSurface(src, NULL, dst, NULL);
+    for (y = 0; y < dst->h; ++y) {
+        const Uint8 *row = (const Uint8 *)dst->pixels + y * dst->pitch;
+        for (x = 0; x < dst->w; ++x) {
+            const SDL_Color *c = &pixels[y * dst->w + x];
+            /* The blit looks colors up at 5-6-5 precision */
+            Uint8 r = (Uint8)((c->r & 0xF8) | (c->r >> 5));
+            Uint8 g = (Uint8)((c->g & 0xFC) | (c->g >> 6));
+            Uint8 b = (Uint8)((c->b & 0xF8) | (c->b >> 5));
+            Uint8 expected = (Uint8)SDL_MapRGB(dst->format, r, g, b);
+            if (colorkey && c->r == colorkey->r && c->g == colorkey->g && c->b == colorkey->b) {
+                expected = 0;
+            }
+            if (row[x] != expected) {
+                ++mismatches;
+            }
+        }
+    }
+    SDLTest_AssertCheck(mismatches == 0, "Verify %s pixels map to the nearest palette color, expected: 0 mismatches, got: %d", what, mismatches);
+}
+
+/**
+ * @brief Tests blitting RGB surfaces to a palettized surface, with and
+ * without a color key and with ordered dithering.
+ */
+int
+surface_testBlitToPalette(void *arg)
+{
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_RGB888,
+        SDL_PIXELFORMAT_BGR24,
+        SDL_PIXELFORMAT_RGB565,
+        SDL_PIXELFORMAT_ARGB8888,
+    };
+    const int w = 32, h = 32;
+    SDL_Color palette[64], pixels[32 * 32];
+    SDL_Surface *dst, *src;
+    SDL_bool used[256];
+    int i, x, y;
+
+    for (i = 0; i < SDL_arraysize(palette); ++i) {
+        palette[i].r = (Uint8)((i & 3) * 85);
+        palette[i].g = (Uint8)(((i >> 2) & 3) * 85);
+        palette[i].b = (Uint8)((i >> 4) * 85);
+        palette[i].a = 255;
+    }
+    for (i = 0; i < SDL_arraysize(pixels); ++i) {
+        pixels[i].r = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+        pixels[i].g = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+        pixels[i].b = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+        pixels[i].a = 255;
+    }
+    /* Some pixels exactly on palette colors */
+    for (i = 0; i < SDL_arraysize(palette); ++i) {
+        pixels[i * 7] = palette[i];
+    }
+
+    dst = SDL_CreateRGBSurfaceWithFormat(0, w, h, 8, SDL_PIXELFORMAT_INDEX8);
+    SDLTest_AssertCheck(dst != NULL, "Verify result from SDL_CreateRGBSurfaceWithFormat is not NULL");
+    if (dst == NULL) return TEST_ABORTED;
+    SDL_SetPaletteColors(dst->format->palette, palette, 0, SDL_arraysize(palette));
+
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        src = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, formats[i]);
+        SDLTest_AssertCheck(src != NULL, "Verify result from SDL_CreateRGBSurfaceWithFormat is not NULL");
+        if (src == NULL) return TEST_ABORTED;
+        SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+        for (y = 0; y < h; ++y) {
+            for (x = 0; x < w; ++x) {
+                const SDL_Color *c = &pixels[y * w + x];
+                SDL_Rect rect;
+                rect.x = x;
+                rect.y = y;
+                rect.w = 1;
+                rect.h = 1;
+                SDL_FillRect(src, &rect, SDL_MapRGB(src->format, c->r, c->g, c->b));
+            }
+        }
+        /* RGB565 can't hold all the colors, so compare with what it kept */
+        if (formats[i] == SDL_PIXELFORMAT_RGB565) {
+            SDL_Color kept[32 * 32];
+            for (y = 0; y < h; ++y) {
+                for (x = 0; x < w; ++x) {
+                    const Uint16 *row = (const Uint16 *)((const Uint8 *)src->pixels + y * src->pitch);
+                    SDL_GetRGB(row[x], src->format, &kept[y * w + x].r, &kept[y * w + x].g, &kept[y * w + x].b);
+                }
+            }
+            _testBlitToPalette(src, dst, kept, NULL, SDL_GetPixelFormatName(formats[i]));
+            SDL_FreeSurface(src);
+            continue;
+        }
+        _testBlitToPalette(src, dst, pixels, NULL, SDL_GetPixelFormatName(formats[i]));
+
+        /* Keyed 24-bit pixels aren't compared as a whole, so only 32-bit */
+        if (src->format->BytesPerPixel == 4) {
+            SDL_SetColorKey(src, SDL_TRUE, SDL_MapRGB(src->format, pixels[1].r, pixels[1].g, pixels[1].b));
+            _testBlitToPalette(src, dst, pixels, &pixels[1], SDL_GetPixelFormatName(formats[i]));
+            SDL_SetColorKey(src, SDL_FALSE, 0);
+        }
+
+        /* Changing the palette has to be seen by the next blit */
+        palette[0].r = 255;
+        SDL_SetPaletteColors(dst->format->palette, palette, 0, 1);
+        _testBlitToPalette(src, dst, pixels, NULL, "recolored palette");
+        palette[0].r = 0;
+        SDL_SetPaletteColors(dst->format->palette, palette, 0, 1);
+        SDL_FreeSurface(src);
+    }
+
+    /* A flat color between two palette entries dithers to both of them */
+    SDL_SetHint(SDL_HINT_PALETTE_DITHER, "1");
+    src = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, SDL_PIXELFORMAT_RGB888);
+    SDLTest_AssertCheck(src != NULL, "Verify result from SDL_CreateRGBSurfaceWithFormat is not NULL");
+    if (src == NULL) return TEST_ABORTED;
+    SDL_FillRect(src, NULL, SDL_MapRGB(src->format, 44, 44, 44));
+    SDL_FreeSurface(dst);
+    dst = SDL_CreateRGBSurfaceWithFormat(0, w, h, 8, SDL_PIXELFORMAT_INDEX8);
+    SDLTest_AssertCheck(dst != NULL, "Verify result from SDL_CreateRGBSurfaceWithFormat is not NULL");
+    if (dst == NULL) return TEST_ABORTED;
+    SDL_SetPaletteColors(dst->format->palette, palette, 0, SDL_arraysize(palette));
+    SDL_BlitSurface(src, NULL, dst, NULL);
+    SDL_zero(used);
+    for (y = 0; y < h; ++y) {
+        const Uint8 *row = (const Uint8 *)dst->pixels + y * dst->pitch;
+        for (x = 0; x < w; ++x) {
+            used[row[x]] = SDL_TRUE;
+        }
+    }
+    SDLTest_AssertCheck(used[0] && used[1 + 4 + 16], "Verify dithered pixels use the palette colors on both sides of the fill color");
+    SDL_SetHint(SDL_HINT_PALETTE_DITHER, "0");
+
+    SDL_FreeSurface(src);
+    SDL_FreeSurface(dst);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that pixel converters give the same results as SDL_ConvertPixels().
+ */
+int
+surface_testPixelConverter(void *arg)
+{
+    const Uint32 conversions[][2] = {
+        { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB565 },
+        { SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_ABGR8888 },
+        { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_BGR24 },
+        { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888 },
+        { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_YV12 },
+        { SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_NV12 },
+        { SDL_PIXELFORMAT_YV12, SDL_PIXELFORMAT_ARGB8888 },
+        { SDL_PIXELFORMAT_YV12, SDL_PIXELFORMAT_RGB444 },
+        { SDL_PIXELFORMAT_YV12, SDL_PIXELFORMAT_NV21 },
+    };
+    const int w = 35, h = 17;
+    /* Room for 4 bytes per pixel with an extra 8 bytes of pitch */
+    const size_t size = (w * 4 + 8) * h;
+    Uint8 *src, *expected, *actual;
+    int i, pass;
+
+    src = (Uint8 *)SDL_malloc(size);
+    expected = (Uint8 *)SDL_malloc(size);
+    actual = (Uint8 *)SDL_malloc(size);
+    SDLTest_AssertCheck(src && expected && actual, "Verify buffers were allocated");
+    if (!src || !expected || !actual) return TEST_ABORTED;
+    for (i = 0; i < (int)size; ++i) {
+        src[i] = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+    }
+
+    for (i = 0; i < SDL_arraysize(conversions); ++i) {
+        const Uint32 src_format = conversions[i][0];
+        const Uint32 dst_format = conversions[i][1];
+        SDL_PixelConverter *converter = SDL_CreatePixelConverter(src_format, dst_format, w, h);
+        SDLTest_AssertCheck(converter != NULL, "Verify converter from %s to %s was created",
+                            SDL_GetPixelFormatName(src_format), SDL_GetPixelFormatName(dst_format));
+        if (converter == NULL) continue;
+
+        /* Converters are reused with different pitches */
+        for (pass = 0; pass < 2; ++pass) {
+            const int extra = pass * 8;
+            const int src_pitch = SDL_ISPIXELFORMAT_FOURCC(src_format) ? w + extra : w * SDL_BYTESPERPIXEL(src_format) + extra;
+            const int dst_pitch = SDL_ISPIXELFORMAT_FOURCC(dst_format) ? w + extra : w * SDL_BYTESPERPIXEL(dst_format) + extra;
+            int ret;
+
+            SDL_memset(expected, 0, size);
+            SDL_memset(actual, 0, size);
+            ret = SDL_ConvertPixels(w, h, src_format, src, src_pitch, dst_format, expected, dst_pitch);
+            SDLTest_AssertCheck(ret == 0, "Validate result from SDL_ConvertPixels, expected: 0, got: %i", ret);
+            ret = SDL_RunPixelConverter(converter, src, src_pitch, actual, dst_pitch);
+            SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RunPixelConverter, expected: 0, got: %i", ret);
+            SDLTest_AssertCheck(SDL_memcmp(expected, actual, size) == 0, "Verify %s to %s matches SDL_ConvertPixels with pitch %d",
+                                SDL_GetPixelFormatName(src_format), SDL_GetPixelFormatName(dst_format), dst_pitch);
+        }
+
+        /* Only the pixels under a rect are converted */
+        if (!SDL_ISPIXELFORMAT_FOURCC(src_format) && !SDL_ISPIXELFORMAT_FOURCC(dst_format)) {
+            const SDL_Rect rect = { 3, 2, 20, 11 };
+            const int src_pitch = w * SDL_BYTESPERPIXEL(src_format);
+            const int dst_bpp = SDL_BYTESPERPIXEL(dst_format);
+            const int dst_pitch = w * dst_bpp;
+            int x, y, ret, mismatches = 0;
+
+            SDL_ConvertPixels(w, h, src_format, src, src_pitch, dst_format, expected, dst_pitch);
+            SDL_memset(actual, 0, size);
+            ret = SDL_RunPixelConverterRect(converter, &rect, src, src_pitch, actual, dst_pitch);
+            SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RunPixelConverterRect, expected: 0, got: %i", ret);
+            for (y = 0; y < h; ++y) {
+                for (x = 0; x < w; ++x) {
+                    const SDL_Point point = { x, y };
+                    const int offset = y * dst_pitch + x * dst_bpp;
+                    static const Uint8 zero[4] = { 0, 0, 0, 0 };
+
+                    if (SDL_PointInRect(&point, &rect)) {
+                        mismatches += SDL_memcmp(&expected[offset], &actual[offset], dst_bpp) != 0;
+                    } else {
+                        mismatches += SDL_memcmp(zero, &actual[offset], dst_bpp) != 0;
+                    }
+                }
+            }
+            SDLTest_AssertCheck(mismatches == 0, "Verify %s to %s converts only the rect, %d pixels wrong",
+                                SDL_GetPixelFormatName(src_format), SDL_GetPixelFormatName(dst_format), mismatches);
+        } else {
+            const SDL_Rect rect = { 0, 0, w / 2, h };
+            SDLTest_AssertCheck(SDL_RunPixelConverterRect(converter, &rect, src, w, actual, w) < 0,
+                                "Verify part of a %s to %s conversion is rejected",
+                                SDL_GetPixelFormatName(src_format), SDL_GetPixelFormatName(dst_format));
+        }
+        SDL_FreePixelConverter(converter);
+    }
+
+    SDL_ClearError();
+    SDLTest_AssertCheck(SDL_RunPixelConverter(NULL, src, w, actual, w) < 0, "Verify SDL_RunPixelConverter rejects a NULL converter");
+    SDLTest_AssertCheck(SDL_CreatePixelConverter(SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_INDEX8, w, h) == NULL, "Verify converting to an indexed format is rejected");
+
+    SDL_free(src);
+    SDL_free(expected);
+    SDL_free(actual);
+
+    return TEST_COMPLETED;
+}
+
+/* Blit src onto a copy of background at x, y */
+static SDL_Surface *
+_blitOntoCopy(SDL_Surface *src, SDL_Surface *background, int x, int y)
+{
+    SDL_Surface *result = SDL_ConvertSurface(background, background->format, 0);
+    SDL_Rect rect;
+
+    if (result) {
+        rect.x = x;
+        rect.y = y;
+        rect.w = src->w;
+        rect.h = src->h;
+        SDL_BlitSurface(src, NULL, result, &rect);
+    }
+    return result;
+}
+
+/**
+ * @brief Tests that RLE blits with modulation and additive blending match plain blits.
+ */
+int
+surface_testRLEModulate(void *arg)
+{
+    const struct {
+        SDL_BlendMode blend;
+        Uint8 r, g, b, a;
+    } mods[] = {
+        { SDL_BLENDMODE_BLEND, 255, 255, 255, 128 },
+        { SDL_BLENDMODE_BLEND, 255, 128, 64, 255 },
+        { SDL_BLENDMODE_BLEND, 200, 100, 50, 90 },
+        { SDL_BLENDMODE_ADD, 255, 255, 255, 255 },
+        { SDL_BLENDMODE_ADD, 128, 255, 64, 200 },
+        { SDL_BLENDMODE_MOD, 255, 128, 255, 255 },
+    };
+    const struct {
+        Uint32 src_format;
+        Uint32 dst_format;
+        int allowable_error;
+    } formats[] = {
+        /* Per-pixel alpha, exact on 32-bit targets */
+        { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB888, 0 },
+        /* 16-bit targets keep 5 bits of alpha */
+        { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB565, 3 * 16 * 16 },
+        /* Colorkey */
+        { SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_RGB888, 0 },
+        { SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGB565, 0 },
+    };
+    const SDL_Point positions[] = { { 5, 4 }, { -7, -5 }, { 50, 20 } };
+    const int w = 40, h = 24;
+    int i, j, k, x, y, ret, allowable_error;
+
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        SDL_Surface *plain, *rle, *background;
+        SDL_bool colorkey = !SDL_ISPIXELFORMAT_ALPHA(formats[i].src_format);
+
+        plain = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, formats[i].src_format);
+        background = SDL_CreateRGBSurfaceWithFormat(0, 64, 32, 0, formats[i].dst_format);
+        SDLTest_AssertCheck(plain && background, "Verify surfaces were created");
+        if (!plain || !background) return TEST_ABORTED;
+
+        /* A sprite with a transparent border, and translucent pixels in the middle */
+        SDL_SetSurfaceBlendMode(plain, SDL_BLENDMODE_NONE);
+        for (y = 0; y < h; ++y) {
+            for (x = 0; x < w; ++x) {
+                SDL_Rect rect;
+                Uint8 a = 255;
+                if (x < 4 || x >= w - 4 || y < 3) {
+                    a = 0;
+                } else if (!colorkey && (x & 1) && y > h / 2) {
+                    a = (Uint8)SDLTest_RandomIntegerInRange(1, 254);
+                }
+                rect.x = x;
+                rect.y = y;
+                rect.w = 1;
+                rect.h = 1;
+                if (colorkey && a == 0) {
+                    SDL_FillRect(plain, &rect, SDL_MapRGB(plain->format, 255, 0, 255));
+                } else {
+                    SDL_FillRect(plain, &rect, SDL_MapRGBA(plain->format,
+                                 (Uint8)SDLTest_RandomIntegerInRange(0, 255),
+                                 (Uint8)SDLTest_RandomIntegerInRange(0, 255),
+                                 (Uint8)SDLTest_RandomIntegerInRange(0, 255), a));
+                }
+            }
+        }
+        for (y = 0; y < background->h; ++y) {
+            for (x = 0; x < background->w; ++x) {
+                SDL_Rect rect;
+                rect.x = x;
+                rect.y = y;
+                rect.w = 1;
+                rect.h = 1;
+                SDL_FillRect(background, &rect, SDL_MapRGB(background->format, (Uint8)(x * 4), (Uint8)(y * 8), 128));
+            }
+        }
+        if (colorkey) {
+            SDL_SetColorKey(plain, SDL_TRUE, SDL_MapRGB(plain->format, 255, 0, 255));
+        }
+        rle = SDL_ConvertSurface(plain, plain->format, 0);
+        SDLTest_AssertCheck(rle != NULL, "Verify result from SDL_ConvertSurface is not NULL");
+        if (rle == NULL) return TEST_ABORTED;
+        SDL_SetSurfaceRLE(rle, 1);
+
+        for (j = 0; j < SDL_arraysize(mods); ++j) {
+            /* MOD would change the destination under transparent pixels */
+            if (mods[j].blend == SDL_BLENDMODE_MOD && !colorkey) {
+                continue;
+            }
+            SDL_SetSurfaceBlendMode(plain, mods[j].blend);
+            SDL_SetSurfaceColorMod(plain, mods[j].r, mods[j].g, mods[j].b);
+            SDL_SetSurfaceAlphaMod(plain, mods[j].a);
+            SDL_SetSurfaceBlendMode(rle, mods[j].blend);
+            SDL_SetSurfaceColorMod(rle, mods[j].r, mods[j].g, mods[j].b);
+            SDL_SetSurfaceAlphaMod(rle, mods[j].a);
+
+            /* Per-surface alpha alone still uses the approximate blitters */
+            allowable_error = formats[i].allowable_error;
+            if (colorkey && mods[j].blend == SDL_BLENDMODE_BLEND &&
+                (mods[j].r & mods[j].g & mods[j].b) == 255) {
+                allowable_error = 3 * 16 * 16;
+            }
+
+            for (k = 0; k < SDL_arraysize(positions); ++k) {
+                SDL_Surface *expected = _blitOntoCopy(plain, background, positions[k].x, positions[k].y);
+                SDL_Surface *actual = _blitOntoCopy(rle, background, positions[k].x, positions[k].y);
+                SDLTest_AssertCheck(expected && actual, "Verify blit results were created");
+                if (!expected || !actual) return TEST_ABORTED;
+                SDLTest_AssertCheck((rle->flags & SDL_RLEACCEL) != 0,
+                                    "Verify %s surface with blend mode %d and mods (%d,%d,%d,%d) is RLE encoded",
+                                    SDL_GetPixelFormatName(formats[i].src_format), mods[j].blend,
+                                    mods[j].r, mods[j].g, mods[j].b, mods[j].a);
+                ret = SDLTest_CompareSurfaces(actual, expected, allowable_error);
+                SDLTest_AssertCheck(ret == 0, "Validate RLE blit of %s onto %s with blend mode %d at (%d,%d) matches a plain blit, got %d differences",
+                                    SDL_GetPixelFormatName(formats[i].src_format), SDL_GetPixelFormatName(formats[i].dst_format),
+                                    mods[j].blend, positions[k].x, positions[k].y, ret);
+                SDL_FreeSurface(expected);
+                SDL_FreeSurface(actual);
+            }
+        }
+
+        SDL_FreeSurface(plain);
+        SDL_FreeSurface(rle);
+        SDL_FreeSurface(background);
+    }
+
+    return TEST_COMPLETED;
+}
+
 /* !
  *  Tests surface conversion.
  */
@@ -630,11 +1280,27 @@ static const SDLTest_TestCaseReference surfaceTest11 =
 static const SDLTest_TestCaseReference surfaceTest12 =
         { (SDLTest_TestCaseFp)surface_testBlitBlendMod, "surface_testBlitBlendMod", "Tests blitting routines with mod blending mode.", TEST_ENABLED};
 
+static const SDLTest_TestCaseReference surfaceTest13 =
+        { (SDLTest_TestCaseFp)surface_testLoadBitmapFormat, "surface_testLoadBitmapFormat", "Tests loading bitmaps into other pixel formats.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest14 =
+        { (SDLTest_TestCaseFp)surface_testBlitMapCache, "surface_testBlitMapCache", "Tests blitting a surface to several destination formats in turn.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest15 =
+        { (SDLTest_TestCaseFp)surface_testBlitToPalette, "surface_testBlitToPalette", "Tests blitting RGB surfaces to a palettized surface.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest16 =
+        { (SDLTest_TestCaseFp)surface_testPixelConverter, "surface_testPixelConverter", "Tests converting pixels with a converter set up in advance.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest17 =
+        { (SDLTest_TestCaseFp)surface_testRLEModulate, "surface_testRLEModulate", "Tests RLE blits with color and alpha modulation and additive blending.", TEST_ENABLED};
+
 /* Sequence of Surface test cases */
 static const SDLTest_TestCaseReference *surfaceTests[] =  {
     &surfaceTest1, &surfaceTest2, &surfaceTest3, &surfaceTest4, &surfaceTest5,
     &surfaceTest6, &surfaceTest7, &surfaceTest8, &surfaceTest9, &surfaceTest10,
-    &surfaceTest11, &surfaceTest12, NULL
+    &surfaceTest11, &surfaceTest12, &surfaceTest13, &surfaceTest14,
+    &surfaceTest15, &surfaceTest16, &surfaceTest17, NULL
 };
 
 /* Surface test suite (global) */
@@ -1721,6 +1721,274 @@ video_getSetWindowData(void *arg)
 }
 
 
+/* The rects that reached the dummy driver, which logs each one */
+static SDL_Rect _updatedRects[128];
+static int _numUpdatedRects;
+
+static void SDLCALL
+_logUpdatedRect(void *userdata, int category, SDL_LogPriority priority, const char *message)
+{
+  SDL_Rect rect;
+
+  if (category == SDL_LOG_CATEGORY_VIDEO && _numUpdatedRects < SDL_arraysize(_updatedRects) &&
+      SDL_sscanf(message, "Window %*d update: %d,%d %dx%d", &rect.x, &rect.y, &rect.w, &rect.h) == 4) {
+    _updatedRects[_numUpdatedRects++] = rect;
+  }
+}
+
+/* Update the window surface, collecting the rects sent to the dummy driver */
+int _updateWindowSurfaceRects(SDL_Window *window, const SDL_Rect *rects, int numrects)
+{
+  SDL_LogOutputFunction logFunction;
+  void *logUserdata;
+  SDL_LogPriority priority;
+  int result;
+
+  SDL_LogGetOutputFunction(&logFunction, &logUserdata);
+  priority = SDL_LogGetPriority(SDL_LOG_CATEGORY_VIDEO);
+  SDL_LogSetOutputFunction(_logUpdatedRect, NULL);
+  SDL_LogSetPriority(SDL_LOG_CATEGORY_VIDEO, SDL_LOG_PRIORITY_DEBUG);
+
+  _numUpdatedRects = 0;
+  result = SDL_UpdateWindowSurfaceRects(window, rects, numrects);
+  SDLTest_AssertPass("Call to SDL_UpdateWindowSurfaceRects(numrects=%d)", numrects);
+
+  SDL_LogSetPriority(SDL_LOG_CATEGORY_VIDEO, priority);
+  SDL_LogSetOutputFunction(logFunction, logUserdata);
+  return result;
+}
+
+/* Check the rects sent by the last _updateWindowSurfaceRects() */
+void _checkUpdatedRects(const char *what, const SDL_Rect *expected, int numexpected)
+{
+  int i, wrong = 0;
+
+  SDLTest_AssertCheck(_numUpdatedRects == numexpected, "Validate number of rects sent for %s, expected: %d, got: %d", what, numexpected, _numUpdatedRects);
+  if (_numUpdatedRects != numexpected) return;
+  for (i = 0; i < numexpected; i++) {
+    if (!SDL_RectEquals(&_updatedRects[i], &expected[i])) {
+      SDLTest_LogError("Rect %d sent for %s is %d,%d %dx%d, expected %d,%d %dx%d", i, what,
+                       _updatedRects[i].x, _updatedRects[i].y, _updatedRects[i].w, _updatedRects[i].h,
+                       expected[i].x, expected[i].y, expected[i].w, expected[i].h);
+      wrong++;
+    }
+  }
+  SDLTest_AssertCheck(wrong == 0, "Validate rects sent for %s, %d wrong", what, wrong);
+}
+
+/* Set a rect, for building lists of rects */
+void _setRect(SDL_Rect *rect, int x, int y, int w, int h)
+{
+  rect->x = x;
+  rect->y = y;
+  rect->w = w;
+  rect->h = h;
+}
+
+/**
+ * @brief Tests updating the window surface with lists of damage rects
+ *
+ * @sa http://wiki.libsdl.org/moin.fcg/SDL_UpdateWindowSurfaceRects
+ */
+int
+video_updateWindowSurfaceRects(void *arg)
+{
+  const char* title = "video_updateWindowSurfaceRects Test Window";
+  const char *modes[] = { "0", "1" };
+  SDL_Window* window;
+  SDL_Surface* surface;
+  SDL_Rect rects[4], full;
+  SDL_bool detect, counted;
+  int i, result;
+
+  /* Only the dummy driver reports the rects it is sent */
+  counted = (SDL_strcmp(SDL_GetCurrentVideoDriver(), "dummy") == 0) ? SDL_TRUE : SDL_FALSE;
+
+  /* Call against new test window */
+  window = _createVideoSuiteTestWindow(title);
+  if (window == NULL) return TEST_ABORTED;
+
+  for (i = 0; i < SDL_arraysize(modes); i++) {
+    SDL_SetHint(SDL_HINT_FRAMEBUFFER_DAMAGE, modes[i]);
+    detect = (i == 1) ? SDL_TRUE : SDL_FALSE;
+
+    surface = SDL_GetWindowSurface(window);
+    SDLTest_AssertPass("Call to SDL_GetWindowSurface()");
+    SDLTest_AssertCheck(surface != NULL, "Validate that returned surface is not NULL");
+    if (surface == NULL) break;
+    _setRect(&full, 0, 0, surface->w, surface->h);
+
+    /* The whole surface, then again without any change */
+    SDL_FillRect(surface, NULL, SDL_MapRGB(surface->format, 0, 0, 0));
+    result = _updateWindowSurfaceRects(window, &full, 1);
+    SDLTest_AssertCheck(result == 0, "Validate result from SDL_UpdateWindowSurfaceRects with %s=%s, expected: 0, got: %i", SDL_HINT_FRAMEBUFFER_DAMAGE, modes[i], result);
+    if (counted) {
+      _checkUpdatedRects("the whole surface", &full, 1);
+    }
+    result = _updateWindowSurfaceRects(window, &full, 1);
+    SDLTest_AssertCheck(result == 0, "Validate result from unchanged SDL_UpdateWindowSurfaceRects, expected: 0, got: %i", result);
+    if (counted) {
+      /* Damage detection skips the driver when nothing changed */
+      _checkUpdatedRects("the unchanged surface", &full, detect ? 0 : 1);
+    }
+
+    /* Flipping the top bit of two words in a tile is still a change */
+    if (surface->format->BytesPerPixel == 4) {
+      ((Uint32 *)surface->pixels)[0] ^= 0x80000000;
+      ((Uint32 *)surface->pixels)[4] ^= 0x80000000;
+      result = _updateWindowSurfaceRects(window, &full, 1);
+      SDLTest_AssertCheck(result == 0, "Validate result from SDL_UpdateWindowSurfaceRects, expected: 0, got: %i", result);
+      if (counted) {
+        SDLTest_AssertCheck(_numUpdatedRects > 0, "Validate a tile with two high bits flipped was sent, got: %d", _numUpdatedRects);
+      }
+    }
+
+    /* Overlapping, adjacent and partly offscreen rects */
+    _setRect(&rects[0], 10, 10, 40, 40);
+    _setRect(&rects[1], 30, 30, 40, 40);
+    _setRect(&rects[2], 70, 30, 10, 40);
+    _setRect(&rects[3], -20, surface->h - 10, 50, 50);
+    SDL_FillRect(surface, &rects[1], SDL_MapRGB(surface->format, 255, 255, 255));
+    result = _updateWindowSurfaceRects(window, rects, SDL_arraysize(rects));
+    SDLTest_AssertCheck(result == 0, "Validate result from SDL_UpdateWindowSurfaceRects, expected: 0, got: %i", result);
+    if (counted) {
+      SDLTest_AssertCheck(_numUpdatedRects > 0, "Validate changed rects were sent, got: %d", _numUpdatedRects);
+    }
+    result = _updateWindowSurfaceRects(window, rects, SDL_arraysize(rects));
+    SDLTest_AssertCheck(result == 0, "Validate result from unchanged SDL_UpdateWindowSurfaceRects, expected: 0, got: %i", result);
+    if (counted && detect) {
+      SDLTest_AssertCheck(_numUpdatedRects == 0, "Validate unchanged rects were not sent, got: %d", _numUpdatedRects);
+    }
+
+    /* Nothing on screen at all */
+    rects[0].x = surface->w;
+    rects[0].y = 0;
+    result = _updateWindowSurfaceRects(window, rects, 1);
+    SDLTest_AssertCheck(result == 0, "Validate result from SDL_UpdateWindowSurfaceRects with an offscreen rect, expected: 0, got: %i", result);
+    if (counted) {
+      _checkUpdatedRects("an offscreen rect", rects, 0);
+    }
+  }
+  SDL_SetHint(SDL_HINT_FRAMEBUFFER_DAMAGE, NULL);
+
+  /* Clean up */
+  _destroyVideoSuiteTestWindow(window);
+
+  return TEST_COMPLETED;
+}
+
+
+/**
+ * @brief Tests that damage rects are clipped, aligned and merged before they reach the driver
+ *
+ * @sa http://wiki.libsdl.org/moin.fcg/SDL_UpdateWindowSurfaceRects
+ */
+int
+video_coalesceWindowSurfaceRects(void *arg)
+{
+  const char* title = "video_coalesceWindowSurfaceRects Test Window";
+  SDL_Window* window;
+  SDL_Surface* surface;
+  SDL_Rect rects[100], expected[100];
+  int i, w, h, result;
+
+  if (SDL_strcmp(SDL_GetCurrentVideoDriver(), "dummy") != 0) {
+    SDLTest_Log("Skipping test, only the dummy video driver reports the rects it is sent");
+    return TEST_SKIPPED;
+  }
+
+  /* Call against new test window */
+  window = _createVideoSuiteTestWindow(title);
+  if (window == NULL) return TEST_ABORTED;
+
+  SDL_SetHint(SDL_HINT_FRAMEBUFFER_DAMAGE, "0");
+  surface = SDL_GetWindowSurface(window);
+  SDLTest_AssertPass("Call to SDL_GetWindowSurface()");
+  SDLTest_AssertCheck(surface != NULL, "Validate that returned surface is not NULL");
+  if (surface == NULL) goto cleanup;
+
+  /* Rects are widened to 64 bytes, 16 pixels here */
+  SDLTest_AssertCheck(surface->format->BytesPerPixel == 4, "Validate surface has 4 bytes per pixel, got: %d", surface->format->BytesPerPixel);
+  if (surface->format->BytesPerPixel != 4) goto cleanup;
+  w = surface->w;
+  h = surface->h;
+
+  /* Overlapping rects merge */
+  _setRect(&rects[0], 16, 10, 32, 20);
+  _setRect(&rects[1], 32, 10, 32, 20);
+  _setRect(&expected[0], 16, 10, 48, 20);
+  result = _updateWindowSurfaceRects(window, rects, 2);
+  SDLTest_AssertCheck(result == 0, "Validate result from SDL_UpdateWindowSurfaceRects, expected: 0, got: %i", result);
+  _checkUpdatedRects("overlapping rects", expected, 1);
+
+  /* Adjacent rects merge */
+  _setRect(&rects[0], 0, 0, 16, 8);
+  _setRect(&rects[1], 0, 8, 16, 8);
+  _setRect(&expected[0], 0, 0, 16, 16);
+  result = _updateWindowSurfaceRects(window, rects, 2);
+  SDLTest_AssertCheck(result == 0, "Validate result from SDL_UpdateWindowSurfaceRects, expected: 0, got: %i", result);
+  _checkUpdatedRects("adjacent rects", expected, 1);
+
+  /* Rects are clipped to the surface */
+  _setRect(&rects[0], -10, -10, 20, 20);
+  _setRect(&expected[0], 0, 0, 16, 10);
+  result = _updateWindowSurfaceRects(window, rects, 1);
+  SDLTest_AssertCheck(result == 0, "Validate result from SDL_UpdateWindowSurfaceRects, expected: 0, got: %i", result);
+  _checkUpdatedRects("a rect off the top left", expected, 1);
+
+  _setRect(&rects[0], w - 5, h - 5, 20, 20);
+  _setRect(&expected[0], (w - 5) / 16 * 16, h - 5, w - (w - 5) / 16 * 16, 5);
+  result = _updateWindowSurfaceRects(window, rects, 1);
+  SDLTest_AssertCheck(result == 0, "Validate result from SDL_UpdateWindowSurfaceRects, expected: 0, got: %i", result);
+  _checkUpdatedRects("a rect off the bottom right", expected, 1);
+
+  /* Left and right edges snap out to the alignment */
+  _setRect(&rects[0], 17, 5, 2, 2);
+  _setRect(&expected[0], 16, 5, 16, 2);
+  result = _updateWindowSurfaceRects(window, rects, 1);
+  SDLTest_AssertCheck(result == 0, "Validate result from SDL_UpdateWindowSurfaceRects, expected: 0, got: %i", result);
+  _checkUpdatedRects("an unaligned rect", expected, 1);
+
+  /* Rects that cover most of their bounds are sent as the bounds */
+  _setRect(&rects[0], 0, 0, 32, 10);
+  _setRect(&rects[1], 0, 12, 32, 10);
+  _setRect(&expected[0], 0, 0, 32, 22);
+  result = _updateWindowSurfaceRects(window, rects, 2);
+  SDLTest_AssertCheck(result == 0, "Validate result from SDL_UpdateWindowSurfaceRects, expected: 0, got: %i", result);
+  _checkUpdatedRects("rects filling their bounds", expected, 1);
+
+  /* Rects far apart stay apart */
+  _setRect(&rects[0], 0, 0, 16, 16);
+  _setRect(&rects[1], 256, 256, 16, 16);
+  result = _updateWindowSurfaceRects(window, rects, 2);
+  SDLTest_AssertCheck(result == 0, "Validate result from SDL_UpdateWindowSurfaceRects, expected: 0, got: %i", result);
+  _checkUpdatedRects("distant rects", rects, 2);
+
+  /* Long lists only merge neighbours, which still drops repeats */
+  for (i = 0; i < SDL_arraysize(rects); i++) {
+    _setRect(&rects[i], 32, 32, 16, 16);
+  }
+  result = _updateWindowSurfaceRects(window, rects, SDL_arraysize(rects));
+  SDLTest_AssertCheck(result == 0, "Validate result from SDL_UpdateWindowSurfaceRects, expected: 0, got: %i", result);
+  _checkUpdatedRects("a long list of one rect", rects, 1);
+
+  for (i = 0; i < SDL_arraysize(rects); i++) {
+    _setRect(&rects[i], (i % 10) * 32, (i / 10) * 32, 8, 8);
+    _setRect(&expected[i], (i % 10) * 32, (i / 10) * 32, 16, 8);
+  }
+  result = _updateWindowSurfaceRects(window, rects, SDL_arraysize(rects));
+  SDLTest_AssertCheck(result == 0, "Validate result from SDL_UpdateWindowSurfaceRects, expected: 0, got: %i", result);
+  _checkUpdatedRects("a long list of scattered rects", expected, SDL_arraysize(rects));
+
+  cleanup:
+  SDL_SetHint(SDL_HINT_FRAMEBUFFER_DAMAGE, NULL);
+
+  /* Clean up */
+  _destroyVideoSuiteTestWindow(window);
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Video test cases */
@@ -1793,13 +2061,19 @@ static const SDLTest_TestCaseReference videoTest22 =
 static const SDLTest_TestCaseReference videoTest23 =
         { (SDLTest_TestCaseFp)video_getSetWindowData, "video_getSetWindowData",  "Checks SDL_SetWindowData and SDL_GetWindowData positive and negative cases", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference videoTest24 =
+        { (SDLTest_TestCaseFp)video_updateWindowSurfaceRects, "video_updateWindowSurfaceRects",  "Checks SDL_UpdateWindowSurfaceRects with and without damage detection", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference videoTest25 =
+        { (SDLTest_TestCaseFp)video_coalesceWindowSurfaceRects, "video_coalesceWindowSurfaceRects",  "Checks the damage rects sent to the video driver are clipped, aligned and merged", TEST_ENABLED };
+
 /* Sequence of Video test cases */
 static const SDLTest_TestCaseReference *videoTests[] =  {
     &videoTest1, &videoTest2, &videoTest3, &videoTest4, &videoTest5, &videoTest6,
     &videoTest7, &videoTest8, &videoTest9, &videoTest10, &videoTest11, &videoTest12,
     &videoTest13, &videoTest14, &videoTest15, &videoTest16, &videoTest17,
     &videoTest18, &videoTest19, &videoTest20, &videoTest21, &videoTest22,
-    &videoTest23, NULL
+    &videoTest23, &videoTest24, &videoTest25, NULL
 };
 
 /* Video test suite (global) */
@@ -0,0 +1,125 @@
+/*
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Compress a file for SDL_RWFromCompressed(), check that it reads back
+   the same, and report how fast it decompresses.
+
+   Usage: testcompress [--block-size bytes] input [output]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define DECOMPRESS_ROUNDS   10
+
+int
+main(int argc, char *argv[])
+{
+    const char *input = NULL;
+    const char *output = NULL;
+    size_t block_size = 0;
+    size_t size, packed_capacity, decompressed;
+    Sint64 packed_size;
+    Uint8 *original, *packed, *buffer;
+    SDL_RWops *src, *dst, *rw;
+    Uint64 start, elapsed;
+    int i, failed = 0;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; ++i) {
+        if (SDL_strcmp(argv[i], "--block-size") == 0 && argv[i + 1]) {
+            block_size = (size_t)SDL_atoi(argv[++i]);
+        } else if (!input) {
+            input = argv[i];
+        } else if (!output) {
+            output = argv[i];
+        } else {
+            input = NULL;
+            break;
+        }
+    }
+    if (!input) {
+        SDL_Log("Usage: %s [--block-size bytes] input [output]\n", argv[0]);
+        return 1;
+    }
+
+    original = (Uint8 *)SDL_LoadFile(input, &size);
+    if (!original) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't load %s: %s\n", input, SDL_GetError());
+        return 1;
+    }
+
+    /* Stored blocks never grow, so the output fits in this */
+    packed_capacity = size + 1024 + (size / 64) + 64;
+    packed = (Uint8 *)SDL_malloc(packed_capacity);
+    buffer = (Uint8 *)SDL_malloc(size + 1);
+    if (!packed || !buffer) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
+        return 1;
+    }
+
+    src = SDL_RWFromConstMem(original, (int)size);
+    dst = SDL_RWFromMem(packed, (int)packed_capacity);
+    start = SDL_GetPerformanceCounter();
+    if (SDL_CompressRW(src, dst, block_size) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't compress %s: %s\n", input, SDL_GetError());
+        return 1;
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+    packed_size = SDL_RWtell(dst);
+    SDL_RWclose(src);
+    SDL_RWclose(dst);
+    SDL_Log("%s: %u bytes compressed to %u (%.1f%%) at %.0f MB/s\n", input,
+            (unsigned int)size, (unsigned int)packed_size,
+            size ? 100.0 * packed_size / size : 100.0,
+            (double)size / (1024.0 * 1024.0) * SDL_GetPerformanceFrequency() / (elapsed ? elapsed : 1));
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < DECOMPRESS_ROUNDS && !failed; ++i) {
+        rw = SDL_RWFromCompressed(SDL_RWFromConstMem(packed, (int)packed_size), 1);
+        if (!rw) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't open the compressed data: %s\n", SDL_GetError());
+            return 1;
+        }
+        decompressed = SDL_RWread(rw, buffer, 1, size + 1);
+        SDL_RWclose(rw);
+        if (decompressed != size || SDL_memcmp(buffer, original, size) != 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "The data didn't decompress to the original\n");
+            failed = 1;
+        }
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+    if (!failed) {
+        SDL_Log("Decompressed at %.0f MB/s\n",
+                (double)size * DECOMPRESS_ROUNDS / (1024.0 * 1024.0) * SDL_GetPerformanceFrequency() / (elapsed ? elapsed : 1));
+    }
+
+    if (output && !failed) {
+        dst = SDL_RWFromFile(output, "wb");
+        if (!dst || SDL_RWwrite(dst, packed, (size_t)packed_size, 1) != 1) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't write %s: %s\n", output, SDL_GetError());
+            failed = 1;
+        }
+        if (dst) {
+            SDL_RWclose(dst);
+        }
+    }
+
+    SDL_free(original);
+    SDL_free(packed);
+    SDL_free(buffer);
+    return failed;
+}
@@ -0,0 +1,279 @@
+/*
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Time large pixel conversions on one thread and split across the job
+   pool with SDL_HINT_PARALLEL_CONVERT, and check that both give the same
+   pixels.  With --workers the parallel runs are repeated with each of the
+   given job pool sizes, to show how the conversions scale with cores.
+
+   Usage: testconvert [--size width height] [--rounds count] [--workers n,n,...]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+typedef enum
+{
+    CONVERT_PIXELS,
+    CONVERT_SURFACE,
+    STRETCH
+} TestType;
+
+typedef struct
+{
+    const char *name;
+    TestType type;
+    Uint32 src_format;
+    Uint32 dst_format;
+} Test;
+
+static const Test tests[] = {
+    { "ARGB8888 to RGB565", CONVERT_PIXELS, SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB565 },
+    { "RGB565 to ABGR8888", CONVERT_PIXELS, SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_ABGR8888 },
+    { "IYUV to ARGB8888", CONVERT_PIXELS, SDL_PIXELFORMAT_IYUV, SDL_PIXELFORMAT_ARGB8888 },
+    { "YUY2 to RGB565", CONVERT_PIXELS, SDL_PIXELFORMAT_YUY2, SDL_PIXELFORMAT_RGB565 },
+    { "ARGB8888 surface to RGB24", CONVERT_SURFACE, SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB24 },
+    { "ARGB8888 stretch 2x", STRETCH, SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888 },
+};
+
+static int width = 2048;
+static int height = 2048;
+static int rounds = 10;
+
+#define MAX_WORKER_COUNTS 8
+
+/* The job pool sizes to time, -1 for the default size */
+static int worker_counts[MAX_WORKER_COUNTS] = { -1 };
+static int num_worker_counts = 1;
+
+static int
+ParseWorkerCounts(const char *list)
+{
+    num_worker_counts = 0;
+    while (*list) {
+        if (num_worker_counts == MAX_WORKER_COUNTS || *list < '0' || *list > '9') {
+            return -1;
+        }
+        worker_counts[num_worker_counts++] = SDL_atoi(list);
+        while (*list >= '0' && *list <= '9') {
+            ++list;
+        }
+        if (*list == ',') {
+            ++list;
+        }
+    }
+    return num_worker_counts ? 0 : -1;
+}
+
+/* Restart SDL so the job pool is started again with the given number of
+   workers, returning the number it actually got */
+static int
+RestartJobPool(int count)
+{
+    SDL_Quit();
+    if (SDL_Init(0) < 0) {
+        return -1;
+    }
+    if (count >= 0) {
+        char hint[16];
+        SDL_snprintf(hint, sizeof(hint), "%d", count);
+        SDL_SetHint(SDL_HINT_JOB_WORKERS, hint);
+    }
+    return SDL_GetJobWorkerCount();
+}
+
+static int
+Pitch(Uint32 format, int w)
+{
+    if (SDL_ISPIXELFORMAT_FOURCC(format)) {
+        return (format == SDL_PIXELFORMAT_YUY2) ? w * 2 : w;
+    }
+    return w * SDL_BYTESPERPIXEL(format);
+}
+
+static size_t
+ImageSize(Uint32 format, int w, int h)
+{
+    if (format == SDL_PIXELFORMAT_IYUV) {
+        return (size_t)w * h + 2 * (size_t)((w + 1) / 2) * ((h + 1) / 2);
+    }
+    return (size_t)Pitch(format, w) * h;
+}
+
+/* Run a test once, returning the result as a surface to compare */
+static SDL_Surface *
+RunTest(const Test *test, SDL_Surface *source, const void *yuv)
+{
+    SDL_Surface *result = NULL;
+
+    switch (test->type) {
+    case CONVERT_PIXELS:
+        result = SDL_CreateRGBSurfaceWithFormat(0, width, height, 0, test->dst_format);
+        if (result) {
+            const void *src = yuv ? yuv : source->pixels;
+            int src_pitch = yuv ? Pitch(test->src_format, width) : source->pitch;
+            SDL_ConvertPixels(width, height, test->src_format, src, src_pitch,
+                              test->dst_format, result->pixels, result->pitch);
+        }
+        break;
+    case CONVERT_SURFACE:
+        result = SDL_ConvertSurfaceFormat(source, test->dst_format, 0);
+        break;
+    case STRETCH:
+        result = SDL_CreateRGBSurfaceWithFormat(0, width * 2, height * 2, 0, test->dst_format);
+        if (result) {
+            SDL_SoftStretch(source, NULL, result, NULL);
+        }
+        break;
+    }
+    return result;
+}
+
+static SDL_bool
+SameSurface(SDL_Surface *a, SDL_Surface *b)
+{
+    const size_t row = (size_t)a->w * a->format->BytesPerPixel;
+    int y;
+
+    for (y = 0; y < a->h; ++y) {
+        if (SDL_memcmp((Uint8 *)a->pixels + y * a->pitch, (Uint8 *)b->pixels + y * b->pitch, row) != 0) {
+            return SDL_FALSE;
+        }
+    }
+    return SDL_TRUE;
+}
+
+/* Time a test in megapixels of output per second */
+static double
+TimeTest(const Test *test, SDL_Surface *source, const void *yuv, SDL_Surface **result)
+{
+    Uint64 start, elapsed;
+    double pixels;
+    int i;
+
+    *result = RunTest(test, source, yuv);
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < rounds; ++i) {
+        SDL_FreeSurface(RunTest(test, source, yuv));
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+    pixels = (double)width * height * rounds * ((test->type == STRETCH) ? 4 : 1);
+    return pixels / 1000000.0 * SDL_GetPerformanceFrequency() / (elapsed ? elapsed : 1);
+}
+
+int
+main(int argc, char *argv[])
+{
+    int i, failed = 0;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; ++i) {
+        if (SDL_strcmp(argv[i], "--size") == 0 && argv[i + 1] && argv[i + 2]) {
+            width = SDL_atoi(argv[++i]);
+            height = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--rounds") == 0 && argv[i + 1]) {
+            rounds = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--workers") == 0 && argv[i + 1] && ParseWorkerCounts(argv[i + 1]) == 0) {
+            ++i;
+        } else {
+            SDL_Log("Usage: %s [--size width height] [--rounds count] [--workers n,n,...]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (width <= 0 || height <= 0 || rounds <= 0) {
+        SDL_Log("The size and number of rounds must be positive\n");
+        return 1;
+    }
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+    SDL_Log("Converting %dx%d images on %d CPUs\n", width, height, SDL_GetCPUCount());
+
+    for (i = 0; i < SDL_arraysize(tests); ++i) {
+        const Test *test = &tests[i];
+        SDL_Surface *source, *serial;
+        void *yuv = NULL;
+        double serial_rate;
+        int x, y, j;
+
+        source = SDL_CreateRGBSurfaceWithFormat(0, width, height, 0,
+                                                SDL_ISPIXELFORMAT_FOURCC(test->src_format) ? SDL_PIXELFORMAT_ARGB8888 : test->src_format);
+        if (!source) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface: %s\n", SDL_GetError());
+            return 1;
+        }
+        for (y = 0; y < height; ++y) {
+            Uint8 *row = (Uint8 *)source->pixels + y * source->pitch;
+            for (x = 0; x < source->pitch; ++x) {
+                row[x] = (Uint8)(rand() ^ (x * 7) ^ y);
+            }
+        }
+        if (SDL_ISPIXELFORMAT_FOURCC(test->src_format)) {
+            yuv = SDL_malloc(ImageSize(test->src_format, width, height));
+            if (!yuv) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
+                return 1;
+            }
+            SDL_ConvertPixels(width, height, source->format->format, source->pixels, source->pitch,
+                              test->src_format, yuv, Pitch(test->src_format, width));
+        }
+
+        SDL_SetHint(SDL_HINT_PARALLEL_CONVERT, "0");
+        serial_rate = TimeTest(test, source, yuv, &serial);
+        if (!serial) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s: %s\n", test->name, SDL_GetError());
+            failed = 1;
+        } else {
+            SDL_Log("%-28s %8.1f Mpix/s serial\n", test->name, serial_rate);
+        }
+
+        for (j = 0; serial && j < num_worker_counts; ++j) {
+            SDL_Surface *parallel;
+            double parallel_rate;
+            const int workers = RestartJobPool(worker_counts[j]);
+
+            if (workers < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+                return 1;
+            }
+            SDL_SetHint(SDL_HINT_PARALLEL_CONVERT, "1");
+            parallel_rate = TimeTest(test, source, yuv, &parallel);
+
+            if (!parallel) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s: %s\n", test->name, SDL_GetError());
+                failed = 1;
+            } else if (!SameSurface(serial, parallel)) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s: the parallel result with %d workers is different\n", test->name, workers);
+                failed = 1;
+            } else {
+                SDL_Log("%-28s %8.1f Mpix/s with %d workers (%.2fx)\n",
+                        "", parallel_rate, workers, parallel_rate / serial_rate);
+            }
+            SDL_FreeSurface(parallel);
+        }
+
+        SDL_FreeSurface(serial);
+        SDL_FreeSurface(source);
+        SDL_free(yuv);
+    }
+
+    SDL_Quit();
+    return failed;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,168 @@
+/*
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Test the job system, and measure how SDL_ParallelFor() scales with the
+   number of worker threads.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define NUM_ROWS    1024
+#define NUM_COLUMNS 1024
+#define NUM_NESTED  64
+
+static Uint32 rows[NUM_ROWS];
+static SDL_atomic_t jobs_done;
+
+/* Some busy work with a deterministic result: iterate a small LCG per pixel */
+static void SDLCALL
+ComputeRows(void *data, int start, int end)
+{
+    int y, x, i;
+
+    for (y = start; y < end; ++y) {
+        Uint32 sum = 0;
+        for (x = 0; x < NUM_COLUMNS; ++x) {
+            Uint32 seed = (Uint32)(y * NUM_COLUMNS + x);
+            for (i = 0; i < 16; ++i) {
+                seed = seed * 1664525u + 1013904223u;
+            }
+            sum += seed >> 16;
+        }
+        rows[y] = sum;
+    }
+}
+
+static Uint32
+Checksum(void)
+{
+    Uint32 sum = 0;
+    int i;
+
+    for (i = 0; i < NUM_ROWS; ++i) {
+        sum = (sum << 1 | sum >> 31) ^ rows[i];
+    }
+    return sum;
+}
+
+static void SDLCALL
+CountJob(void *data)
+{
+    SDL_AtomicIncRef(&jobs_done);
+}
+
+/* A job that fans out more jobs and waits for them from inside the pool */
+static void SDLCALL
+NestedJob(void *data)
+{
+    SDL_JobGroup *group = SDL_CreateJobGroup();
+    int i;
+
+    for (i = 0; i < NUM_NESTED; ++i) {
+        SDL_SubmitJob(group, CountJob, NULL);
+    }
+    SDL_DestroyJobGroup(group);
+    SDL_AtomicIncRef(&jobs_done);
+}
+
+static SDL_bool
+RunGroupTest(void)
+{
+    SDL_JobGroup *group = SDL_CreateJobGroup();
+    const int expected = NUM_NESTED * (NUM_NESTED + 1);
+    int i;
+
+    if (!group) {
+        SDL_Log("Couldn't create job group: %s\n", SDL_GetError());
+        return SDL_FALSE;
+    }
+
+    SDL_AtomicSet(&jobs_done, 0);
+    for (i = 0; i < NUM_NESTED; ++i) {
+        SDL_SubmitJob(group, NestedJob, NULL);
+    }
+    SDL_WaitJobGroup(group);
+    SDL_DestroyJobGroup(group);
+
+    if (SDL_AtomicGet(&jobs_done) != expected) {
+        SDL_Log("Job group finished %d jobs, expected %d\n", SDL_AtomicGet(&jobs_done), expected);
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+static double
+TimeParallelFor(int iterations)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    int i;
+
+    for (i = 0; i < iterations; ++i) {
+        SDL_ParallelFor(0, NUM_ROWS, 0, ComputeRows, NULL);
+    }
+    return (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency() / iterations;
+}
+
+int
+main(int argc, char *argv[])
+{
+    const int iterations = (argc > 1) ? SDL_atoi(argv[1]) : 10;
+    const int max_workers = SDL_GetCPUCount() - 1;
+    double serial_ms = 0.0;
+    Uint32 expected;
+    int workers;
+    SDL_bool passed = SDL_TRUE;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    ComputeRows(NULL, 0, NUM_ROWS);
+    expected = Checksum();
+
+    SDL_Log("%d CPU cores, %d iterations of %dx%d\n", SDL_GetCPUCount(), iterations, NUM_COLUMNS, NUM_ROWS);
+    SDL_Log("workers      ms/iter    speedup\n");
+
+    /* SDL_Quit() stops the pool, so each pass starts with a new worker count */
+    for (workers = 0; workers <= SDL_max(max_workers, 1); ++workers) {
+        char hint[16];
+        double ms;
+
+        if (SDL_Init(0) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+            return 1;
+        }
+        SDL_snprintf(hint, sizeof(hint), "%d", workers);
+        SDL_SetHint(SDL_HINT_JOB_WORKERS, hint);
+
+        SDL_memset(rows, 0, sizeof(rows));
+        ms = TimeParallelFor(iterations);
+        if (workers == 0) {
+            serial_ms = ms;
+        }
+        SDL_Log("%7d %12.3f %10.2fx\n", SDL_GetJobWorkerCount(), ms, serial_ms / ms);
+
+        if (Checksum() != expected) {
+            SDL_Log("SDL_ParallelFor() with %d workers gave the wrong result\n", workers);
+            passed = SDL_FALSE;
+        }
+        if (!RunGroupTest()) {
+            passed = SDL_FALSE;
+        }
+        SDL_Quit();
+    }
+
+    SDL_Log("Job system test %s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+/*
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Log from several threads through a slow output function with
+   asynchronous logging on, and check that every message was either
+   written in order or counted as dropped.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define NUM_THREADS     4
+#define NUM_MESSAGES    1000
+
+static SDL_LogOutputFunction default_output;
+static void *default_userdata;
+static int next_index[NUM_THREADS];
+static int written;
+static int out_of_order;
+static int long_messages;
+static SDL_atomic_t done_sending;
+static SDL_atomic_t stall_output;
+static SDL_atomic_t stalled;
+static SDL_atomic_t written_past_stall;
+
+static void SDLCALL
+SlowOutput(void *userdata, int category, SDL_LogPriority priority, const char *message)
+{
+    int thread, index;
+
+    if (category != SDL_LOG_CATEGORY_CUSTOM) {
+        default_output(default_userdata, category, priority, message);
+        return;
+    }
+    if (message[0] == 'x') {
+        /* Long messages are cut short rather than copied */
+        if (SDL_strlen(message) < 1000 && SDL_strstr(message, "...")) {
+            ++long_messages;
+        }
+        return;
+    }
+    if (SDL_strcmp(message, "stall") == 0) {
+        SDL_AtomicSet(&stalled, 1);
+        while (SDL_AtomicGet(&stall_output)) {
+            SDL_Delay(1);
+        }
+        return;
+    }
+    if (SDL_strcmp(message, "past stall") == 0) {
+        SDL_AtomicIncRef(&written_past_stall);
+        return;
+    }
+    if (SDL_sscanf(message, "thread %d message %d", &thread, &index) == 2 &&
+        thread >= 0 && thread < NUM_THREADS) {
+        if (index < next_index[thread]) {
+            ++out_of_order;
+        }
+        next_index[thread] = index + 1;
+        ++written;
+    }
+
+    /* Pretend to be a serial port until the senders are done */
+    if (!SDL_AtomicGet(&done_sending)) {
+        SDL_Delay(1);
+    }
+}
+
+static int SDLCALL
+Sender(void *data)
+{
+    int thread = (int)(size_t)data;
+    int i;
+
+    for (i = 0; i < NUM_MESSAGES; ++i) {
+        SDL_LogInfo(SDL_LOG_CATEGORY_CUSTOM, "thread %d message %d\n", thread, i);
+    }
+    return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_Thread *threads[NUM_THREADS];
+    char long_message[2048];
+    Uint32 start, elapsed;
+    int i, dropped;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_CUSTOM, SDL_LOG_PRIORITY_INFO);
+
+    SDL_LogGetOutputFunction(&default_output, &default_userdata);
+    SDL_LogSetOutputFunction(SlowOutput, NULL);
+    if (SDL_LogSetAsync(SDL_TRUE) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't start asynchronous logging: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_memset(long_message, 'x', sizeof(long_message) - 1);
+    long_message[sizeof(long_message) - 1] = '\0';
+    SDL_LogInfo(SDL_LOG_CATEGORY_CUSTOM, "%s", long_message);
+
+    start = SDL_GetTicks();
+    for (i = 0; i < NUM_THREADS; ++i) {
+        threads[i] = SDL_CreateThread(Sender, "Sender", (void *)(size_t)i);
+    }
+    for (i = 0; i < NUM_THREADS; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    elapsed = SDL_GetTicks() - start;
+    SDL_AtomicSet(&done_sending, 1);
+
+    SDL_LogFlush();
+
+    /* Flushing mustn't hang when the log thread is stuck in the output function */
+    SDL_AtomicSet(&stall_output, 1);
+    SDL_LogInfo(SDL_LOG_CATEGORY_CUSTOM, "stall");
+    while (!SDL_AtomicGet(&stalled)) {
+        SDL_Delay(1);
+    }
+    SDL_LogInfo(SDL_LOG_CATEGORY_CUSTOM, "past stall");
+    SDL_LogFlush();
+    SDL_AtomicSet(&stall_output, 0);
+
+    SDL_LogSetAsync(SDL_FALSE);
+    SDL_LogSetOutputFunction(default_output, default_userdata);
+
+    dropped = SDL_LogGetDroppedCount();
+    SDL_Log("Sent %d messages in %u ms, %d were dropped\n", NUM_THREADS * NUM_MESSAGES, elapsed, dropped);
+    if (long_messages != 1) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "The long message wasn't written\n");
+        return 1;
+    }
+    if (SDL_AtomicGet(&written_past_stall) != 1) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_LogFlush() didn't write past a stuck log thread\n");
+        return 1;
+    }
+    if (out_of_order) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%d messages were written out of order\n", out_of_order);
+        return 1;
+    }
+    if (written + dropped != NUM_THREADS * NUM_MESSAGES) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%d messages were lost\n", NUM_THREADS * NUM_MESSAGES - written - dropped);
+        return 1;
+    }
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,136 @@
+/*
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Measure the cost of small SDL_malloc()/SDL_free() pairs on one and on
+   several threads, and check that blocks handed between threads stay intact.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define NUM_THREADS 4
+#define NUM_LIVE    256
+#define NUM_OPS     1000000
+
+static SDL_atomic_t failed;
+static SDL_AtomicQueue *handoff;
+
+static double
+NanosecondsPerOp(Uint64 start, int count)
+{
+    return (double)(SDL_GetPerformanceCounter() - start) * 1000000000.0 / SDL_GetPerformanceFrequency() / count;
+}
+
+static size_t
+RandomSize(Uint32 *seed)
+{
+    *seed = *seed * 1664525u + 1013904223u;
+    return 2 + (*seed >> 16) % 383;
+}
+
+/* Allocate and free random small blocks, keeping some alive, and pass some
+   to other threads to free.
+ */
+static int SDLCALL
+Churn(void *data)
+{
+    Uint8 *live[NUM_LIVE];
+    size_t sizes[NUM_LIVE];
+    Uint32 seed = (Uint32)(uintptr_t)data;
+    Uint64 start;
+    int i;
+
+    SDL_zero(live);
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_OPS; ++i) {
+        const int slot = i % NUM_LIVE;
+        void *other;
+
+        if (live[slot]) {
+            if (live[slot][0] != (Uint8)sizes[slot] || live[slot][sizes[slot] - 1] != (Uint8)slot) {
+                SDL_AtomicSet(&failed, 1);
+            }
+            if ((i & 7) || !SDL_AtomicQueuePush(handoff, live[slot])) {
+                SDL_free(live[slot]);
+            }
+        }
+        if (SDL_AtomicQueuePop(handoff, &other)) {
+            SDL_free(other);
+        }
+
+        sizes[slot] = RandomSize(&seed);
+        live[slot] = (Uint8 *)SDL_malloc(sizes[slot]);
+        live[slot][0] = (Uint8)sizes[slot];
+        live[slot][sizes[slot] - 1] = (Uint8)slot;
+
+        /* Grow some of them, which may move them out of their size class */
+        if ((i & 15) == 0) {
+            const size_t size = sizes[slot] * 2;
+            live[slot] = (Uint8 *)SDL_realloc(live[slot], size);
+            if (live[slot][0] != (Uint8)sizes[slot]) {
+                SDL_AtomicSet(&failed, 1);
+            }
+            sizes[slot] = size;
+            live[slot][0] = (Uint8)sizes[slot];
+            live[slot][sizes[slot] - 1] = (Uint8)slot;
+        }
+    }
+    for (i = 0; i < NUM_LIVE; ++i) {
+        SDL_free(live[i]);
+    }
+
+    SDL_Log("Thread %lu: %.2f ns per allocation\n", SDL_ThreadID(), NanosecondsPerOp(start, NUM_OPS));
+    return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_Thread *threads[NUM_THREADS];
+    void *item;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    handoff = SDL_CreateAtomicQueue(1024);
+
+    SDL_Log("Single thread, %d allocations of up to 384 bytes\n", NUM_OPS);
+    Churn((void *)1);
+
+    SDL_Log("%d threads, %d allocations each\n", NUM_THREADS, NUM_OPS);
+    for (i = 0; i < NUM_THREADS; ++i) {
+        char name[64];
+        SDL_snprintf(name, sizeof(name), "Malloc%d", i);
+        threads[i] = SDL_CreateThread(Churn, name, (void *)(uintptr_t)(i + 2));
+    }
+    for (i = 0; i < NUM_THREADS; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    while (SDL_AtomicQueuePop(handoff, &item)) {
+        SDL_free(item);
+    }
+    SDL_DestroyAtomicQueue(handoff);
+
+    if (SDL_AtomicGet(&failed)) {
+        SDL_Log("A block was corrupted!\n");
+    }
+    SDL_Quit();
+    return SDL_AtomicGet(&failed) ? 1 : 0;
+}
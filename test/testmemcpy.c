@@ -0,0 +1,187 @@
+/*
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Check SDL_memcpy() and SDL_memset() across a range of sizes and
+   alignments, and compare their throughput with the C library's.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SDL.h"
+
+#define MAX_SIZE    (4 * 1024 * 1024)
+#define GUARD       64
+#define MIN_BYTES   (64 * 1024 * 1024)
+
+static const size_t sizes[] = {
+    16, 64, 256, 1024, 4096, 16 * 1024, 64 * 1024, 256 * 1024, 1024 * 1024, MAX_SIZE
+};
+
+/* Destination and source offsets from a 64 byte boundary */
+static const int alignments[][2] = {
+    { 0, 0 }, { 0, 4 }, { 3, 0 }, { 5, 9 }
+};
+
+static Uint8 *src_buffer;
+static Uint8 *dst_buffer;
+static int failed;
+
+static Uint8 *
+Align64(Uint8 *ptr)
+{
+    return (Uint8 *)(((uintptr_t)ptr + 63) & ~(uintptr_t)63);
+}
+
+static void
+CheckCopy(Uint8 *dst, const Uint8 *src, size_t size)
+{
+    size_t i;
+
+    SDL_memset(dst - GUARD, 0xAA, size + 2 * GUARD);
+    SDL_memcpy(dst, src, size);
+    for (i = 0; i < GUARD; ++i) {
+        if (dst[-1 - (int)i] != 0xAA || dst[size + i] != 0xAA) {
+            SDL_Log("SDL_memcpy() of %u bytes wrote outside the destination\n", (unsigned int)size);
+            failed = 1;
+            return;
+        }
+    }
+    if (memcmp(dst, src, size) != 0) {
+        SDL_Log("SDL_memcpy() of %u bytes copied the wrong data\n", (unsigned int)size);
+        failed = 1;
+    }
+}
+
+static void
+CheckFill(Uint8 *dst, size_t size)
+{
+    size_t i;
+
+    memset(dst - GUARD, 0xAA, size + 2 * GUARD);
+    SDL_memset(dst, 0x5C, size);
+    for (i = 0; i < GUARD; ++i) {
+        if (dst[-1 - (int)i] != 0xAA || dst[size + i] != 0xAA) {
+            SDL_Log("SDL_memset() of %u bytes wrote outside the destination\n", (unsigned int)size);
+            failed = 1;
+            return;
+        }
+    }
+    for (i = 0; i < size; ++i) {
+        if (dst[i] != 0x5C) {
+            SDL_Log("SDL_memset() of %u bytes filled the wrong data\n", (unsigned int)size);
+            failed = 1;
+            return;
+        }
+    }
+}
+
+/* Returns the throughput in MB/s */
+static double
+Benchmark(void *(*copy)(void *, const void *, size_t), void *(*fill)(void *, int, size_t),
+          Uint8 *dst, const Uint8 *src, size_t size)
+{
+    const int count = (int)SDL_max(MIN_BYTES / size, 4);
+    Uint64 start, elapsed;
+    int i;
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < count; ++i) {
+        if (copy) {
+            copy(dst, src, size);
+        } else {
+            fill(dst, i, size);
+        }
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+    return (double)size * count / (1024.0 * 1024.0) * SDL_GetPerformanceFrequency() / (elapsed ? elapsed : 1);
+}
+
+static void *
+SDLmemcpy(void *dst, const void *src, size_t len)
+{
+    return SDL_memcpy(dst, src, len);
+}
+
+static void *
+LIBCmemcpy(void *dst, const void *src, size_t len)
+{
+    return memcpy(dst, src, len);
+}
+
+static void *
+SDLmemset(void *dst, int c, size_t len)
+{
+    return SDL_memset(dst, c, len);
+}
+
+static void *
+LIBCmemset(void *dst, int c, size_t len)
+{
+    return memset(dst, c, len);
+}
+
+int
+main(int argc, char *argv[])
+{
+    Uint8 *src_memory, *dst_memory;
+    size_t i, j;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    src_memory = (Uint8 *)SDL_malloc(MAX_SIZE + 2 * GUARD + 128);
+    dst_memory = (Uint8 *)SDL_malloc(MAX_SIZE + 2 * GUARD + 128);
+    if (!src_memory || !dst_memory) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
+        return 1;
+    }
+    src_buffer = Align64(src_memory + GUARD);
+    dst_buffer = Align64(dst_memory + GUARD);
+    for (i = 0; i < MAX_SIZE + 64; ++i) {
+        src_buffer[i] = (Uint8)(i * 7 + (i >> 8));
+    }
+
+    /* Sizes around each of the thresholds, with every alignment */
+    for (i = 1; i <= 1024 * 1024 && !failed; i = (i < 64) ? i + 1 : i * 2 - 1) {
+        for (j = 0; j < SDL_arraysize(alignments); ++j) {
+            CheckCopy(dst_buffer + alignments[j][0], src_buffer + alignments[j][1], i);
+            CheckCopy(dst_buffer + alignments[j][0], src_buffer + alignments[j][1], i + 1);
+            CheckFill(dst_buffer + alignments[j][0], i);
+        }
+    }
+    if (failed) {
+        return 1;
+    }
+
+    SDL_Log("%9s %9s  %12s %12s  %12s %12s\n", "size", "dst/src", "SDL_memcpy", "memcpy", "SDL_memset", "memset");
+    for (i = 0; i < SDL_arraysize(sizes); ++i) {
+        for (j = 0; j < SDL_arraysize(alignments); ++j) {
+            Uint8 *dst = dst_buffer + alignments[j][0];
+            const Uint8 *src = src_buffer + alignments[j][1];
+            char alignment[16];
+
+            SDL_snprintf(alignment, sizeof(alignment), "+%d/+%d", alignments[j][0], alignments[j][1]);
+            SDL_Log("%9u %9s  %7.0f MB/s %7.0f MB/s  %7.0f MB/s %7.0f MB/s\n",
+                    (unsigned int)sizes[i], alignment,
+                    Benchmark(SDLmemcpy, NULL, dst, src, sizes[i]),
+                    Benchmark(LIBCmemcpy, NULL, dst, src, sizes[i]),
+                    Benchmark(NULL, SDLmemset, dst, src, sizes[i]),
+                    Benchmark(NULL, LIBCmemset, dst, src, sizes[i]));
+        }
+    }
+
+    SDL_free(src_memory);
+    SDL_free(dst_memory);
+    return 0;
+}
@@ -0,0 +1,90 @@
+/*
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Check that application allocations show up in the heap statistics, then
+   print the statistics for every tag after initializing some subsystems.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define NUM_BLOCKS  100
+#define BLOCK_SIZE  100
+
+static int failed;
+
+static void
+Check(SDL_bool condition, const char *what)
+{
+    if (!condition) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed: %s\n", what);
+        failed = 1;
+    }
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_MemoryStats before, after;
+    void *blocks[NUM_BLOCKS];
+    SDL_RWops *out;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_GetMemoryStats(SDL_MEMORY_TAG_APP, &before) < 0) {
+        SDL_Log("No memory statistics: %s\n", SDL_GetError());
+        return 0;
+    }
+
+    for (i = 0; i < NUM_BLOCKS; ++i) {
+        blocks[i] = SDL_malloc(BLOCK_SIZE);
+    }
+    SDL_GetMemoryStats(SDL_MEMORY_TAG_APP, &after);
+    Check(after.live_bytes == before.live_bytes + NUM_BLOCKS * BLOCK_SIZE, "live bytes after SDL_malloc()");
+    Check(after.live_allocations == before.live_allocations + NUM_BLOCKS, "live allocations after SDL_malloc()");
+    Check(after.total_allocations == before.total_allocations + NUM_BLOCKS, "total allocations after SDL_malloc()");
+    Check(after.peak_bytes >= after.live_bytes, "peak bytes after SDL_malloc()");
+    Check(after.histogram[3] == before.histogram[3] + NUM_BLOCKS, "histogram after SDL_malloc()");
+
+    blocks[0] = SDL_realloc(blocks[0], 2 * BLOCK_SIZE);
+    SDL_GetMemoryStats(SDL_MEMORY_TAG_APP, &after);
+    Check(after.live_bytes == before.live_bytes + (NUM_BLOCKS + 1) * BLOCK_SIZE, "live bytes after SDL_realloc()");
+    Check(after.live_allocations == before.live_allocations + NUM_BLOCKS, "live allocations after SDL_realloc()");
+    Check(after.histogram[4] == before.histogram[4] + 1, "histogram after SDL_realloc()");
+
+    for (i = 0; i < NUM_BLOCKS; ++i) {
+        SDL_free(blocks[i]);
+    }
+    SDL_GetMemoryStats(SDL_MEMORY_TAG_APP, &after);
+    Check(after.live_bytes == before.live_bytes, "live bytes after SDL_free()");
+    Check(after.live_allocations == before.live_allocations, "live allocations after SDL_free()");
+    Check(after.peak_bytes >= before.live_bytes + (NUM_BLOCKS + 1) * BLOCK_SIZE, "peak bytes after SDL_free()");
+
+    if (SDL_Init(SDL_INIT_EVENTS | SDL_INIT_JOYSTICK) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    out = SDL_RWFromFP(stdout, SDL_FALSE);
+    if (!out || SDL_DumpMemoryStats(out) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't dump memory statistics: %s\n", SDL_GetError());
+        failed = 1;
+    }
+    SDL_RWclose(out);
+
+    SDL_Quit();
+    return failed;
+}
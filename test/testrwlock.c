@@ -0,0 +1,201 @@
+/*
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Test the reader/writer lock, and compare a read-mostly workload under
+   contention when protected by a spinlock, a mutex and a reader/writer lock.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define NUM_THREADS   4
+#define NUM_OPS       200000
+#define WRITE_PERCENT 5
+#define TABLE_SIZE    64
+
+typedef enum
+{
+    LOCK_SPINLOCK,
+    LOCK_MUTEX,
+    LOCK_RWLOCK,
+    LOCK_COUNT
+} LockType;
+
+static const char *lock_names[LOCK_COUNT] = { "spinlock", "mutex", "rwlock" };
+
+static LockType lock_type;
+static SDL_SpinLock spinlock;
+static SDL_mutex *mutex;
+static SDL_rwlock *rwlock;
+
+/* Writers keep every entry equal to the generation, so readers can tell
+   if they ever see a half-finished update.
+ */
+static Uint32 table[TABLE_SIZE];
+static SDL_atomic_t failed;
+
+static void
+Lock(SDL_bool write)
+{
+    switch (lock_type) {
+    case LOCK_SPINLOCK:
+        SDL_AtomicLock(&spinlock);
+        break;
+    case LOCK_MUTEX:
+        SDL_LockMutex(mutex);
+        break;
+    default:
+        if (write) {
+            SDL_LockRWLockForWriting(rwlock);
+        } else {
+            SDL_LockRWLockForReading(rwlock);
+        }
+        break;
+    }
+}
+
+static void
+Unlock(void)
+{
+    switch (lock_type) {
+    case LOCK_SPINLOCK:
+        SDL_AtomicUnlock(&spinlock);
+        break;
+    case LOCK_MUTEX:
+        SDL_UnlockMutex(mutex);
+        break;
+    default:
+        SDL_UnlockRWLock(rwlock);
+        break;
+    }
+}
+
+static int SDLCALL
+Worker(void *data)
+{
+    Uint32 seed = (Uint32)(uintptr_t)data;
+    int i, j;
+
+    for (i = 0; i < NUM_OPS; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        if ((seed >> 16) % 100 < WRITE_PERCENT) {
+            Lock(SDL_TRUE);
+            for (j = 0; j < TABLE_SIZE; ++j) {
+                ++table[j];
+            }
+            Unlock();
+        } else {
+            Uint32 first;
+
+            Lock(SDL_FALSE);
+            first = table[0];
+            for (j = 1; j < TABLE_SIZE; ++j) {
+                if (table[j] != first) {
+                    SDL_AtomicSet(&failed, 1);
+                }
+            }
+            Unlock();
+        }
+    }
+    return 0;
+}
+
+static SDL_bool
+TestTryLock(void)
+{
+    SDL_bool passed = SDL_TRUE;
+
+    if (SDL_TryLockRWLockForReading(rwlock) != 0 ||
+        SDL_TryLockRWLockForReading(rwlock) != 0) {
+        SDL_Log("Couldn't take two read locks\n");
+        passed = SDL_FALSE;
+    }
+    if (SDL_TryLockRWLockForWriting(rwlock) != SDL_MUTEX_TIMEDOUT) {
+        SDL_Log("Took a write lock while readers held the lock\n");
+        passed = SDL_FALSE;
+    }
+    SDL_UnlockRWLock(rwlock);
+    SDL_UnlockRWLock(rwlock);
+
+    if (SDL_TryLockRWLockForWriting(rwlock) != 0) {
+        SDL_Log("Couldn't take an unlocked write lock\n");
+        passed = SDL_FALSE;
+    }
+    if (SDL_TryLockRWLockForReading(rwlock) != SDL_MUTEX_TIMEDOUT) {
+        SDL_Log("Took a read lock while a writer held the lock\n");
+        passed = SDL_FALSE;
+    }
+    SDL_UnlockRWLock(rwlock);
+    return passed;
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_Thread *threads[NUM_THREADS];
+    SDL_bool passed;
+    int type, i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    mutex = SDL_CreateMutex();
+    rwlock = SDL_CreateRWLock();
+    if (!mutex || !rwlock) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create locks: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    passed = TestTryLock();
+
+    SDL_Log("%d CPU cores, %d threads, %d operations each, %d%% writes\n",
+            SDL_GetCPUCount(), NUM_THREADS, NUM_OPS, WRITE_PERCENT);
+    for (type = 0; type < LOCK_COUNT; ++type) {
+        Uint64 start;
+        double ms;
+
+        lock_type = (LockType)type;
+        SDL_memset(table, 0, sizeof(table));
+
+        start = SDL_GetPerformanceCounter();
+        for (i = 0; i < NUM_THREADS; ++i) {
+            char name[64];
+            SDL_snprintf(name, sizeof(name), "RWLock%d", i);
+            threads[i] = SDL_CreateThread(Worker, name, (void *)(uintptr_t)(i + 1));
+        }
+        for (i = 0; i < NUM_THREADS; ++i) {
+            SDL_WaitThread(threads[i], NULL);
+        }
+        ms = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+
+        SDL_Log("%-10s %10.2f ms\n", lock_names[type], ms);
+    }
+
+    if (SDL_AtomicGet(&failed)) {
+        SDL_Log("A reader saw a partial update!\n");
+        passed = SDL_FALSE;
+    }
+
+    SDL_DestroyRWLock(rwlock);
+    SDL_DestroyMutex(mutex);
+    SDL_Quit();
+
+    SDL_Log("Reader/writer lock test %s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
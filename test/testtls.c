@@ -0,0 +1,162 @@
+/*
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Measure the cost of SDL_TLSGet(), compared to a lookup in a linked list
+   of threads protected by a mutex, which is how the generic thread-local
+   storage used to work.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define NUM_THREADS 4
+#define NUM_LOOKUPS 1000000
+
+typedef struct ListEntry {
+    SDL_threadID thread;
+    void *data;
+    struct ListEntry *next;
+} ListEntry;
+
+static SDL_mutex *list_lock;
+static ListEntry *list;
+static SDL_TLSID tls_id;
+static SDL_atomic_t failed;
+
+static void
+ListSet(void *data)
+{
+    ListEntry *entry = (ListEntry *)SDL_malloc(sizeof(*entry));
+
+    SDL_LockMutex(list_lock);
+    entry->thread = SDL_ThreadID();
+    entry->data = data;
+    entry->next = list;
+    list = entry;
+    SDL_UnlockMutex(list_lock);
+}
+
+static void *
+ListGet(void)
+{
+    SDL_threadID thread = SDL_ThreadID();
+    ListEntry *entry;
+    void *data = NULL;
+
+    SDL_LockMutex(list_lock);
+    for (entry = list; entry; entry = entry->next) {
+        if (entry->thread == thread) {
+            data = entry->data;
+            break;
+        }
+    }
+    SDL_UnlockMutex(list_lock);
+    return data;
+}
+
+static double
+NanosecondsPerLookup(Uint64 start, int count)
+{
+    return (double)(SDL_GetPerformanceCounter() - start) * 1000000000.0 / SDL_GetPerformanceFrequency() / count;
+}
+
+static int SDLCALL
+BenchmarkThread(void *data)
+{
+    void *value = data;
+    Uint64 start;
+    double tls_ns, list_ns;
+    int i;
+
+    SDL_TLSSet(tls_id, value, NULL);
+    ListSet(value);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_LOOKUPS; ++i) {
+        if (SDL_TLSGet(tls_id) != value) {
+            SDL_AtomicSet(&failed, 1);
+        }
+    }
+    tls_ns = NanosecondsPerLookup(start, NUM_LOOKUPS);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_LOOKUPS; ++i) {
+        if (ListGet() != value) {
+            SDL_AtomicSet(&failed, 1);
+        }
+    }
+    list_ns = NanosecondsPerLookup(start, NUM_LOOKUPS);
+
+    SDL_Log("Thread %lu: SDL_TLSGet %.2f ns, mutex list %.2f ns\n", SDL_ThreadID(), tls_ns, list_ns);
+    return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_Thread *threads[NUM_THREADS];
+    Uint64 start;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    list_lock = SDL_CreateMutex();
+    tls_id = SDL_TLSCreate();
+
+    SDL_Log("Single thread, %d lookups each\n", NUM_LOOKUPS);
+    BenchmarkThread((void *)1);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_LOOKUPS; ++i) {
+        SDL_SetError("error %d", i & 1);
+    }
+    SDL_Log("SDL_SetError: %.2f ns\n", NanosecondsPerLookup(start, NUM_LOOKUPS));
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < NUM_LOOKUPS; ++i) {
+        if (!*SDL_GetError()) {
+            SDL_AtomicSet(&failed, 1);
+        }
+    }
+    SDL_Log("SDL_GetError: %.2f ns\n", NanosecondsPerLookup(start, NUM_LOOKUPS));
+
+    SDL_Log("%d threads, %d lookups each\n", NUM_THREADS, NUM_LOOKUPS);
+    for (i = 0; i < NUM_THREADS; ++i) {
+        char name[64];
+        SDL_snprintf(name, sizeof(name), "TLS%d", i);
+        threads[i] = SDL_CreateThread(BenchmarkThread, name, (void *)(uintptr_t)(i + 2));
+    }
+    for (i = 0; i < NUM_THREADS; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+
+    while (list) {
+        ListEntry *entry = list;
+        list = entry->next;
+        SDL_free(entry);
+    }
+    SDL_DestroyMutex(list_lock);
+
+    if (SDL_AtomicGet(&failed)) {
+        SDL_Log("Thread-local storage returned the wrong value!\n");
+    }
+    SDL_Quit();
+    return SDL_AtomicGet(&failed) ? 1 : 0;
+}